@@ -0,0 +1,619 @@
+/**
+ * @file meshlabeler_bench.cpp
+ * @brief MeshLabelCore 热点路径的性能基准测试
+ *
+ * 在 MeshGenerator 生成的细分球网格（1万 ~ 500万三角形）上测量加载、邻接构建、
+ * BFS 区域查询、球体判定、标签统计、标签隐藏（整网格与分块）、感兴趣区域、保存和撤销/重做。
+ *
+ * 输出 JSON 以便在版本间对比：
+ * @code
+ * meshlabeler_bench --benchmark_format=json --benchmark_out=bench.json
+ * @endcode
+ */
+
+#include "meshgenerator.h"
+#include "meshlabelcore.h"
+#include "parallelutils.h"
+#include "renderchunks.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QString>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+
+#include <vtkCellData.h>
+#include <vtkMath.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+namespace {
+
+/**
+ * @brief 获取（缓存的）网格几何，不含标签数据
+ */
+vtkPolyData* cachedMesh(int targetTriangles)
+{
+    static std::map<int, vtkSmartPointer<vtkPolyData>> cache;
+    auto it = cache.find(targetTriangles);
+    if (it == cache.end()) {
+        MeshGeneratorOptions options;
+        options.shape = MeshShape::Icosphere;
+        options.targetTriangles = targetTriangles;
+        it = cache.emplace(targetTriangles, MeshGenerator::generate(options)).first;
+    }
+    return it->second.Get();
+}
+
+/**
+ * @brief 用缓存网格的浅拷贝初始化核心对象（每次得到全新的标签数组）
+ */
+bool prepareCore(MeshLabelCore& core, int targetTriangles)
+{
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->ShallowCopy(cachedMesh(targetTriangles));
+    polyData->GetCellData()->SetScalars(nullptr);
+    return core.setMesh(polyData);
+}
+
+/**
+ * @brief 获取画刷起始单元（单元0）的质心和平均边长
+ * @return 起始单元ID
+ */
+int brushStart(MeshLabelCore& core, double position[3], double* edgeLength)
+{
+    vtkPolyData* polyData = core.polyData();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polyData->GetCellPoints(0, npts, pts);
+
+    double p[3][3];
+    for (int k = 0; k < 3; ++k) {
+        polyData->GetPoint(pts[k], p[k]);
+    }
+    for (int k = 0; k < 3; ++k) {
+        position[k] = (p[0][k] + p[1][k] + p[2][k]) / 3.0;
+    }
+    *edgeLength = (std::sqrt(vtkMath::Distance2BetweenPoints(p[0], p[1]))
+                   + std::sqrt(vtkMath::Distance2BetweenPoints(p[1], p[2]))
+                   + std::sqrt(vtkMath::Distance2BetweenPoints(p[2], p[0]))) / 3.0;
+    return 0;
+}
+
+/**
+ * @brief 获取临时文件路径
+ */
+QString tempMeshFile(int targetTriangles, const char* suffix)
+{
+    return QDir::temp().filePath(
+        QString("meshlabeler_bench_%1.%2").arg(targetTriangles).arg(suffix));
+}
+
+void meshSizes(benchmark::internal::Benchmark* b)
+{
+    for (int n : { 10000, 100000, 1000000, 5000000 }) {
+        b->Arg(n);
+    }
+}
+
+void meshSizesAndRadii(benchmark::internal::Benchmark* b)
+{
+    for (int n : { 10000, 100000, 1000000, 5000000 }) {
+        for (int radius : { 2, 8, 32 }) {
+            b->Args({ n, radius });
+        }
+    }
+}
+
+} // namespace
+
+// ==================== 文件加载 ====================
+
+static void BM_LoadSTL(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    const QString filename = tempMeshFile(n, "stl");
+    if (!QFileInfo::exists(filename)) {
+        MeshGenerator::write(cachedMesh(n), filename);
+    }
+
+    for (auto _ : state) {
+        MeshLabelCore core;
+        if (!core.loadSTL(filename)) {
+            state.SkipWithError(core.lastError().toLocal8Bit().constData());
+            break;
+        }
+        benchmark::DoNotOptimize(core.polyData());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+
+    // 加载后常驻结构的每三角形字节数（预算见 MeshLabelCore::MEMORY_BUDGET_PER_CELL）
+    MeshLabelCore core;
+    if (core.loadSTL(filename)) {
+        state.counters["bytes_per_cell"] = core.memoryReport().residentBytesPerCell();
+    }
+}
+BENCHMARK(BM_LoadSTL)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadVTP(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    const QString filename = tempMeshFile(n, "vtp");
+    if (!QFileInfo::exists(filename)) {
+        MeshLabelCore writerCore;
+        prepareCore(writerCore, n);
+        writerCore.saveVTP(filename);
+    }
+
+    for (auto _ : state) {
+        MeshLabelCore core;
+        if (!core.loadVTP(filename)) {
+            state.SkipWithError(core.lastError().toLocal8Bit().constData());
+            break;
+        }
+        benchmark::DoNotOptimize(core.polyData());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+
+    // 加载后常驻结构的每三角形字节数（预算见 MeshLabelCore::MEMORY_BUDGET_PER_CELL）
+    MeshLabelCore core;
+    if (core.loadVTP(filename)) {
+        state.counters["bytes_per_cell"] = core.memoryReport().residentBytesPerCell();
+    }
+}
+BENCHMARK(BM_LoadVTP)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+// ==================== 邻接构建 ====================
+
+static void BM_BuildAdjacency(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    for (auto _ : state) {
+        core.buildAdjacency();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_BuildAdjacency)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+// ==================== 区域查询 ====================
+
+static void BM_LabelWithBFS(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    // 半径以平均边长为单位
+    double position[3];
+    double edgeLength = 1.0;
+    const int startCell = brushStart(core, position, &edgeLength);
+    const double radius = edgeLength * static_cast<double>(state.range(1));
+
+    size_t affected = 0;
+    for (auto _ : state) {
+        std::vector<int> cells = core.labelWithBFS(position, startCell, radius, 1);
+        affected = cells.size();
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.counters["cells"] = static_cast<double>(affected);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(affected));
+}
+BENCHMARK(BM_LabelWithBFS)->Apply(meshSizesAndRadii)->Unit(benchmark::kMicrosecond);
+
+/**
+ * 大半径画刷（覆盖 100 万三角形细分球的大部分）在不同线程数下的耗时，
+ * 队列超过 PARALLEL_BFS_FRONTIER 后由多个线程扩展
+ */
+static void BM_LabelWithBFSThreads(benchmark::State& state)
+{
+    MeshLabelCore core;
+    prepareCore(core, 1000000);
+
+    double position[3];
+    double edgeLength = 1.0;
+    const int startCell = brushStart(core, position, &edgeLength);
+    const double radius = edgeLength * 200.0;
+    ParallelUtils::setThreadCount(static_cast<int>(state.range(0)));
+
+    size_t affected = 0;
+    for (auto _ : state) {
+        std::vector<int> cells = core.labelWithBFS(position, startCell, radius, 1);
+        affected = cells.size();
+        benchmark::DoNotOptimize(cells.data());
+    }
+    ParallelUtils::setThreadCount(0);
+    state.counters["cells"] = static_cast<double>(affected);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(affected));
+}
+BENCHMARK(BM_LabelWithBFSThreads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_LabelWithGeodesic(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency();   // 邻接关系在首次使用时构建，不计入单次查询
+
+    double position[3];
+    double edgeLength = 1.0;
+    const int startCell = brushStart(core, position, &edgeLength);
+    const double radius = edgeLength * static_cast<double>(state.range(1));
+
+    size_t affected = 0;
+    for (auto _ : state) {
+        std::vector<int> cells = core.labelWithGeodesic(position, startCell, radius, 1);
+        affected = cells.size();
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.counters["cells"] = static_cast<double>(affected);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(affected));
+}
+BENCHMARK(BM_LabelWithGeodesic)->Apply(meshSizesAndRadii)->Unit(benchmark::kMicrosecond);
+
+static void BM_LabelWithRegionGrow(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency(true);   // 邻接关系和面片法向在首次使用时构建，不计入单次查询
+
+    double position[3];
+    double edgeLength = 1.0;
+    const int startCell = brushStart(core, position, &edgeLength);
+
+    // 光滑网格上默认阈值会扩展到整个连通块，是魔棒的最坏情况
+    RegionGrowOptions options;
+    size_t affected = 0;
+    for (auto _ : state) {
+        std::vector<int> cells = core.labelWithRegionGrow(startCell, options, 1);
+        affected = cells.size();
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.counters["cells"] = static_cast<double>(affected);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(affected));
+}
+BENCHMARK(BM_LabelWithRegionGrow)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_BucketFill(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency();   // 邻接关系在首次使用时构建，不计入单次填充
+
+    // 整个网格是一个同标签区域：每次迭代在 0 和 1 之间来回填充
+    int label = 1;
+    int filled = 0;
+    for (auto _ : state) {
+        filled = core.bucketFill(0, label);
+        label = 1 - label;
+        state.PauseTiming();
+        core.clearHistory();
+        state.ResumeTiming();
+    }
+    state.counters["cells"] = filled;
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(filled));
+}
+BENCHMARK(BM_BucketFill)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_AnalyzeComponents(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency();   // 邻接关系在首次使用时构建，不计入单次分析
+
+    // 按单元编号分段着色，每段再撒少量孤立单元作为碎片
+    const int cellCount = core.getCellCount();
+    for (int cellId = 0; cellId < cellCount; ++cellId) {
+        core.labelCell(cellId, (cellId / 4096) % 4 + (cellId % 997 == 0 ? 5 : 0));
+    }
+
+    size_t components = 0;
+    for (auto _ : state) {
+        components = core.analyzeComponents().components().size();
+        benchmark::DoNotOptimize(components);
+    }
+    state.counters["components"] = static_cast<double>(components);
+    state.SetItemsProcessed(state.iterations() * cellCount);
+}
+BENCHMARK(BM_AnalyzeComponents)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_SmoothLabelBoundaries(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency();   // 邻接关系在首次使用时构建，不计入单次平滑
+
+    // 按单元编号分段着色，边界附近撒入锯齿
+    const int cellCount = core.getCellCount();
+    for (int cellId = 0; cellId < cellCount; ++cellId) {
+        const int segment = cellId / 4096;
+        const int offset = cellId % 4096;
+        core.labelCell(cellId, (segment + (offset < 64 && cellId % 3 == 0 ? 1 : 0)) % 4);
+    }
+
+    int changed = 0;
+    for (auto _ : state) {
+        changed = core.smoothLabelBoundaries();
+        state.PauseTiming();
+        core.undo();
+        core.clearHistory();
+        state.ResumeTiming();
+    }
+    state.counters["cells"] = changed;
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cellCount));
+}
+BENCHMARK(BM_SmoothLabelBoundaries)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_RefineWithGraphCut(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency(true);   // 邻接关系和面片几何在首次使用时构建，不计入单次细化
+
+    // 前半部分单元为前景，交界处前后错开形成粗糙边界
+    const int cellCount = core.getCellCount();
+    for (int cellId = 0; cellId < cellCount / 2 + 256; ++cellId) {
+        if (cellId < cellCount / 2 || cellId % 2 == 0) {
+            core.labelCell(cellId, 1);
+        }
+    }
+
+    int changed = 0;
+    for (auto _ : state) {
+        changed = core.refineWithGraphCut(1, 0);
+        state.PauseTiming();
+        core.undo();
+        core.clearHistory();
+        state.ResumeTiming();
+    }
+    state.counters["cells"] = changed;
+}
+BENCHMARK(BM_RefineWithGraphCut)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_TransferLabels(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+
+    // 参考网格：同一形状的另一种分辨率，前半部分单元标为1
+    const QString reference = tempMeshFile(n, "reference.vtp");
+    if (!QFileInfo::exists(reference)) {
+        MeshLabelCore referenceCore;
+        prepareCore(referenceCore, 2 * n);
+        for (int cellId = 0; cellId < referenceCore.getCellCount() / 2; ++cellId) {
+            referenceCore.labelCell(cellId, 1);
+        }
+        referenceCore.saveVTP(reference);
+    }
+
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency(true);   // 单元质心在首次使用时构建，不计入单次迁移
+
+    int changed = 0;
+    for (auto _ : state) {
+        changed = core.transferLabelsFrom(reference);
+        if (changed < 0) {
+            state.SkipWithError(core.lastError().toLocal8Bit().constData());
+            break;
+        }
+        state.PauseTiming();
+        core.undo();
+        core.clearHistory();
+        state.ResumeTiming();
+    }
+    state.counters["cells"] = changed;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TransferLabels)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_IsCellInSphere(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    double position[3];
+    double edgeLength = 1.0;
+    brushStart(core, position, &edgeLength);
+    const double radius = 8.0 * edgeLength;
+    const int cellCount = std::min(core.getCellCount(), 100000);
+
+    for (auto _ : state) {
+        int inside = 0;
+        for (int cellId = 0; cellId < cellCount; ++cellId) {
+            inside += core.isCellInSphere(position, radius, cellId) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    state.SetItemsProcessed(state.iterations() * cellCount);
+}
+BENCHMARK(BM_IsCellInSphere)->Apply(meshSizes)->Unit(benchmark::kMicrosecond);
+
+// ==================== 统计与保存 ====================
+
+static void BM_RecountLabelStatistics(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    for (auto _ : state) {
+        core.recountLabelStatistics();
+        benchmark::DoNotOptimize(core.getLabelStatistics().data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_RecountLabelStatistics)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_SaveVTP(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    const QString filename = tempMeshFile(n, "save.vtp");
+
+    for (auto _ : state) {
+        if (!core.saveVTP(filename)) {
+            state.SkipWithError(core.lastError().toLocal8Bit().constData());
+            break;
+        }
+    }
+    QFile::remove(filename);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SaveVTP)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+// ==================== 标签隐藏 ====================
+
+static void BM_ToggleHiddenLabel(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    // 标签1覆盖约 10% 单元，每次迭代隐藏再显示一次（整网格的可见性数组）
+    std::vector<int> cellIds(core.getCellCount() / 10);
+    std::iota(cellIds.begin(), cellIds.end(), 0);
+    core.paintCells(cellIds, 1);
+    LabelMask hidden;
+    hidden.set(1, true);
+
+    for (auto _ : state) {
+        core.setHiddenLabels(hidden);
+        core.setHiddenLabels(LabelMask());
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_ToggleHiddenLabel)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_ToggleHiddenLabelChunked(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    // 与 BM_ToggleHiddenLabel 相同的标注，只更新含标签1的块
+    std::vector<int> cellIds(core.getCellCount() / 10);
+    std::iota(cellIds.begin(), cellIds.end(), 0);
+    core.paintCells(cellIds, 1);
+    RenderChunks chunks;
+    chunks.build(core.polyData());
+    LabelMask hidden;
+    hidden.set(1, true);
+
+    for (auto _ : state) {
+        chunks.setHiddenLabels(hidden);
+        chunks.setHiddenLabels(LabelMask());
+    }
+    state.counters["chunks"] = chunks.chunkCount();
+    state.SetItemsProcessed(state.iterations() * 2 * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_ToggleHiddenLabelChunked)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+// ==================== 感兴趣区域 ====================
+
+static void BM_LabelWithRegionGrowClipped(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    core.meshAdjacency(true);
+
+    // 与 BM_LabelWithRegionGrow 相同的最坏情况，但限制在边长约 40 条边的裁剪盒内：
+    // 区域大小不随网格规模增长
+    double position[3];
+    double edgeLength = 1.0;
+    const int startCell = brushStart(core, position, &edgeLength);
+    const double halfSize = 20.0 * edgeLength;
+    const double box[6] = { position[0] - halfSize, position[0] + halfSize,
+                            position[1] - halfSize, position[1] + halfSize,
+                            position[2] - halfSize, position[2] + halfSize };
+    core.setClipBox(box);
+
+    RegionGrowOptions options;
+    size_t affected = 0;
+    for (auto _ : state) {
+        std::vector<int> cells = core.labelWithRegionGrow(startCell, options, 1);
+        affected = cells.size();
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.counters["cells"] = static_cast<double>(affected);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(affected));
+}
+BENCHMARK(BM_LabelWithRegionGrowClipped)->Apply(meshSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_MoveClipBoxChunked(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+    RenderChunks chunks;
+    chunks.build(core.polyData());
+
+    // 拖动裁剪盒的一步：边长为网格的 1/4，每次迭代沿 x 轴来回移动
+    double bounds[6];
+    core.polyData()->GetBounds(bounds);
+    const double size = 0.25 * (bounds[1] - bounds[0]);
+    double box[6] = { bounds[0], bounds[0] + size, bounds[2], bounds[2] + size,
+                      bounds[4], bounds[4] + size };
+    int step = 0;
+    for (auto _ : state) {
+        const double offset = (step++ % 8) * 0.1 * size;
+        const double moved[6] = { box[0] + offset, box[1] + offset, box[2], box[3], box[4], box[5] };
+        chunks.setClipBox(moved);
+        benchmark::DoNotOptimize(chunks.takeVisibilityChanged());
+    }
+    state.counters["chunks"] = chunks.chunkCount();
+    state.counters["visible"] = chunks.visibleCellCount();
+}
+BENCHMARK(BM_MoveClipBoxChunked)->Apply(meshSizes)->Unit(benchmark::kMicrosecond);
+
+// ==================== 撤销/重做 ====================
+
+static void BM_UndoRedo(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    MeshLabelCore core;
+    prepareCore(core, n);
+
+    // 一笔覆盖约 10% 单元
+    std::vector<int> cellIds(core.getCellCount() / 10);
+    std::iota(cellIds.begin(), cellIds.end(), 0);
+    core.paintCells(cellIds, 1);
+
+    for (auto _ : state) {
+        core.undo();
+        core.redo();
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * static_cast<int64_t>(cellIds.size()));
+}
+BENCHMARK(BM_UndoRedo)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+    // 核心类的调试日志会干扰计时
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
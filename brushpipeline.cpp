@@ -0,0 +1,117 @@
+/**
+ * @file brushpipeline.cpp
+ * @brief BrushPipeline 画刷流水线的实现
+ */
+
+#include "brushpipeline.h"
+#include "meshlabelcore.h"
+
+BrushPipeline::BrushPipeline(std::function<void()> resultsReady)
+    : m_resultsReady(std::move(resultsReady))
+    , m_submitted(0)
+    , m_posted(0)
+    , m_acknowledged(0)
+    , m_stopping(false)
+{
+    m_worker = std::thread(&BrushPipeline::run, this);
+}
+
+BrushPipeline::~BrushPipeline()
+{
+    m_stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_workerWake.notify_one();
+    m_worker.join();
+}
+
+bool BrushPipeline::submit(const BrushSample& sample)
+{
+    if (!m_samples.push(sample)) {
+        return false;
+    }
+    ++m_submitted;
+
+    // 先入队再经过一次互斥锁，工作线程不会在检查条件和睡眠之间错过通知
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_workerWake.notify_one();
+    return true;
+}
+
+bool BrushPipeline::takeResult(BrushResult& result)
+{
+    return m_results.pop(result);
+}
+
+void BrushPipeline::acknowledge()
+{
+    m_acknowledged.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_workerWake.notify_one();
+}
+
+bool BrushPipeline::isIdle() const
+{
+    return m_acknowledged.load() == m_submitted;
+}
+
+void BrushPipeline::waitForResult()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_resultWake.wait(lock, [this]() { return !m_results.empty() || isIdle(); });
+}
+
+void BrushPipeline::run()
+{
+    BrushSample sample;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workerWake.wait(lock, [this]() {
+                return m_stopping.load()
+                    || (m_acknowledged.load() == m_posted.load() && !m_samples.empty());
+            });
+        }
+        if (m_stopping.load()) {
+            return;
+        }
+
+        m_samples.pop(sample);
+        BrushResult result;
+        compute(sample, result);
+
+        // 同一时刻最多一个结果未确认，结果队列不会满
+        m_results.push(std::move(result));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_posted.fetch_add(1);
+        }
+        m_resultWake.notify_all();
+        m_resultsReady();
+    }
+}
+
+void BrushPipeline::compute(const BrushSample& sample, BrushResult& result)
+{
+    result.core = sample.core;
+    result.label = sample.label;
+    result.points = sample.points;
+    if (sample.points && sample.geodesic) {
+        result.cellIds = sample.core->labelPointsWithGeodesic(sample.position, sample.cellId,
+                                                              sample.radius, sample.label);
+    } else if (sample.points) {
+        result.cellIds = sample.core->labelPointsInSphere(sample.position, sample.radius,
+                                                          sample.label);
+    } else if (sample.geodesic) {
+        result.cellIds = sample.core->labelWithGeodesic(sample.position, sample.cellId,
+                                                        sample.radius, sample.label);
+    } else {
+        result.cellIds = sample.core->labelWithBFS(sample.position, sample.cellId,
+                                                   sample.radius, sample.label);
+    }
+}
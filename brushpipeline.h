@@ -0,0 +1,189 @@
+/**
+ * @file brushpipeline.h
+ * @brief 画刷流水线（GUI 线程拾取，工作线程计算区域，GUI 线程写标签和渲染）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef BRUSHPIPELINE_H
+#define BRUSHPIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class MeshLabelCore;
+
+/**
+ * @brief 单生产者单消费者的无锁环形队列
+ *
+ * 生产者只写 m_tail，消费者只写 m_head，两者各占一条缓存行。
+ * 队列满时 push() 返回 false，由生产者决定丢弃还是合并。
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : m_head(0), m_tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief 入队（只能由生产者线程调用）
+     * @return 队列已满返回false
+     */
+    bool push(T value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % SLOTS;
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 出队（只能由消费者线程调用）
+     * @return 队列为空返回false
+     */
+    bool pop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[head]);
+        m_head.store((head + 1) % SLOTS, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 队列是否为空（另一端可能同时修改，结果只是一个快照）
+     */
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t SLOTS = Capacity + 1;   ///< 留一个空槽区分空和满
+
+    T m_slots[SLOTS];
+    alignas(64) std::atomic<size_t> m_head;   ///< 下一个出队位置（消费者写）
+    alignas(64) std::atomic<size_t> m_tail;   ///< 下一个入队位置（生产者写）
+};
+
+/**
+ * @brief 一个画刷样本（GUI 线程拾取得到）
+ */
+struct BrushSample {
+    MeshLabelCore* core = nullptr;  ///< 拾取到的网格
+    double position[3] = {};        ///< 球心位置
+    int cellId = -1;                ///< 拾取到的单元
+    double radius = 0.0;            ///< 画刷半径
+    int label = 0;                  ///< 目标标签
+    bool geodesic = false;          ///< 是否按测地距离
+    bool points = false;            ///< 是否标注顶点（顶点标签模式）
+};
+
+/**
+ * @brief 一个样本的计算结果
+ */
+struct BrushResult {
+    MeshLabelCore* core = nullptr;  ///< 样本的网格
+    int label = 0;                  ///< 目标标签
+    bool points = false;            ///< cellIds 是否为顶点ID（顶点标签模式）
+    std::vector<int> cellIds;       ///< 需要标注的单元（或顶点）
+};
+
+/**
+ * @brief 画刷流水线
+ *
+ * VTK 的拾取器和渲染器不是线程安全的，因此拾取和渲染留在 GUI 线程；区域计算
+ * （labelWithBFS/labelWithGeodesic，顶点标签模式下为 labelPointsInSphere/labelPointsWithGeodesic）放到一个常驻工作线程，鼠标事件处理只做一次拾取和一次入队，
+ * 不再等区域计算完成。样本和结果各走一个无锁队列：
+ * - GUI 线程 submit() 样本，工作线程计算后放入结果队列并调用 resultsReady 回调
+ *   （回调在工作线程上执行，应只投递一个事件回 GUI 线程）；
+ * - GUI 线程 takeResult() 取出结果写入标签，然后 acknowledge()。
+ *
+ * 工作线程在上一个结果被确认之前不会开始下一个样本：每个样本看到的标签都已包含之前所有样本的结果，
+ * 选中的单元与在事件回调中直接计算完全相同；区域计算只读网格，与 GUI 线程的拾取和渲染并发。
+ */
+class BrushPipeline {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 8;    ///< 样本和结果队列的容量（限制标注落后于鼠标的样本数）
+
+    /**
+     * @brief 构造函数（启动工作线程）
+     * @param resultsReady 有新结果时在工作线程上调用
+     */
+    explicit BrushPipeline(std::function<void()> resultsReady);
+
+    /**
+     * @brief 析构函数（丢弃未处理的样本并结束工作线程）
+     */
+    ~BrushPipeline();
+
+    BrushPipeline(const BrushPipeline&) = delete;
+    BrushPipeline& operator=(const BrushPipeline&) = delete;
+
+    /**
+     * @brief 提交一个样本（GUI 线程）
+     * @return 样本队列已满返回false
+     */
+    bool submit(const BrushSample& sample);
+
+    /**
+     * @brief 取出一个结果（GUI 线程）
+     * @return 没有结果返回false
+     */
+    bool takeResult(BrushResult& result);
+
+    /**
+     * @brief 确认一个结果已写入标签，允许工作线程计算下一个样本（GUI 线程）
+     */
+    void acknowledge();
+
+    /**
+     * @brief 是否所有已提交的样本都已计算并确认（GUI 线程）
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief 阻塞到有结果可取或流水线空闲（GUI 线程）
+     */
+    void waitForResult();
+
+private:
+    /**
+     * @brief 工作线程主循环
+     */
+    void run();
+
+    /**
+     * @brief 计算一个样本
+     */
+    static void compute(const BrushSample& sample, BrushResult& result);
+
+    std::function<void()> m_resultsReady;                  ///< 新结果回调
+    SpscQueue<BrushSample, QUEUE_CAPACITY> m_samples;      ///< 样本队列（GUI -> 工作线程）
+    SpscQueue<BrushResult, QUEUE_CAPACITY> m_results;      ///< 结果队列（工作线程 -> GUI）
+    uint64_t m_submitted;                                  ///< 已提交的样本数（只由 GUI 线程访问）
+    std::atomic<uint64_t> m_posted;                        ///< 已放入结果队列的结果数
+    std::atomic<uint64_t> m_acknowledged;                  ///< 已确认的结果数
+    std::atomic<bool> m_stopping;                          ///< 是否正在结束工作线程
+    std::mutex m_mutex;                                    ///< 只用于睡眠和唤醒
+    std::condition_variable m_workerWake;                  ///< 唤醒工作线程（新样本、确认、结束）
+    std::condition_variable m_resultWake;                  ///< 唤醒 waitForResult()
+    std::thread m_worker;                                  ///< 工作线程
+};
+
+#endif // BRUSHPIPELINE_H
@@ -0,0 +1,801 @@
+/**
+ * @file chunkedmesh.cpp
+ * @brief ChunkedMesh 外存分块网格的实现
+ */
+
+#include "chunkedmesh.h"
+#include "labelarray.h"
+#include "trianglebvh.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr int GRID_RESOLUTION = 128;          ///< 分组格子在最长轴上的数量
+constexpr int STL_RECORD_SIZE = 50;           ///< 二进制 STL 每个三角形的字节数
+constexpr int STL_BLOCK_RECORDS = 16384;      ///< 每次读入的三角形数
+const char INDEX_MAGIC[8] = { 'M', 'L', 'C', 'H', 'U', 'N', 'K', '1' };
+
+/**
+ * @brief 二进制 STL 的顺序读取（分块缓冲，可多遍读取）
+ */
+class BinaryStlReader {
+public:
+    bool open(const QString& filename, QString& error)
+    {
+        m_file.setFileName(filename);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            error = QString("无法打开STL文件: %1").arg(filename);
+            return false;
+        }
+        quint32 count = 0;
+        if (!m_file.seek(80) || m_file.read(reinterpret_cast<char*>(&count), 4) != 4
+            || m_file.size() != 84 + static_cast<qint64>(count) * STL_RECORD_SIZE) {
+            error = QString("只支持二进制STL文件: %1").arg(filename);
+            return false;
+        }
+        m_count = count;
+        return rewind();
+    }
+
+    bool rewind()
+    {
+        m_remaining = m_count;
+        m_position = 0;
+        m_end = 0;
+        return m_file.seek(84);
+    }
+
+    /**
+     * @brief 读下一个三角形的三个顶点
+     */
+    bool next(float corners[9])
+    {
+        if (m_position == m_end) {
+            if (m_remaining == 0) {
+                return false;
+            }
+            const quint32 records = std::min<quint32>(m_remaining, STL_BLOCK_RECORDS);
+            m_buffer.resize(static_cast<size_t>(records) * STL_RECORD_SIZE);
+            if (m_file.read(m_buffer.data(), m_buffer.size()) != static_cast<qint64>(m_buffer.size())) {
+                return false;
+            }
+            m_remaining -= records;
+            m_position = 0;
+            m_end = m_buffer.size();
+        }
+        // 记录：法向(12字节) + 三个顶点(36字节) + 属性(2字节)
+        std::memcpy(corners, m_buffer.data() + m_position + 12, 36);
+        m_position += STL_RECORD_SIZE;
+        return true;
+    }
+
+private:
+    QFile m_file;
+    quint32 m_count = 0;
+    quint32 m_remaining = 0;
+    std::vector<char> m_buffer;
+    size_t m_position = 0;
+    size_t m_end = 0;
+};
+
+/**
+ * @brief 是否有坐标完全相同的顶点（vtkSTLReader 合并顶点后会丢弃这样的三角形）
+ */
+bool isDegenerate(const float* t)
+{
+    auto same = [t](int a, int b) {
+        return t[3 * a] == t[3 * b] && t[3 * a + 1] == t[3 * b + 1] && t[3 * a + 2] == t[3 * b + 2];
+    };
+    return same(0, 1) || same(1, 2) || same(0, 2);
+}
+
+/**
+ * @brief 3D Morton 编码（每轴低10位交错）
+ */
+uint32_t morton(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t code = 0;
+    for (int bit = 0; bit < 10; ++bit) {
+        code |= ((x >> bit) & 1u) << (3 * bit);
+        code |= ((y >> bit) & 1u) << (3 * bit + 1);
+        code |= ((z >> bit) & 1u) << (3 * bit + 2);
+    }
+    return code;
+}
+
+/**
+ * @brief 点到包围盒距离的平方
+ */
+double boxDistance2(const float bounds[6], const double point[3])
+{
+    double distance2 = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        double d = 0.0;
+        if (point[k] < bounds[2 * k]) {
+            d = bounds[2 * k] - point[k];
+        } else if (point[k] > bounds[2 * k + 1]) {
+            d = point[k] - bounds[2 * k + 1];
+        }
+        distance2 += d * d;
+    }
+    return distance2;
+}
+
+/**
+ * @brief 画刷 BFS 中的一个角点（按坐标排序后，坐标相同的角点是同一个顶点）
+ */
+struct Corner {
+    float x, y, z;
+    int slot;   ///< 3 × 球内单元序号 + 角点序号
+};
+
+} // namespace
+
+ChunkedMesh::ChunkedMesh()
+    : m_cellCount(0)
+    , m_labels(nullptr)
+    , m_labelBytes(1)
+    , m_labelCapacity(LabelArray::COMPACT_CAPACITY)
+    , m_memoryBudget(DEFAULT_MEMORY_BUDGET)
+    , m_residentBytes(0)
+    , m_useCounter(0)
+{
+    std::fill(m_bounds, m_bounds + 6, 0.0);
+}
+
+ChunkedMesh::~ChunkedMesh()
+{
+    close();
+}
+
+bool ChunkedMesh::createFromSTL(const QString& stlFile, const QString& directory, int chunkCells)
+{
+    close();
+    if (chunkCells <= 0) {
+        chunkCells = DEFAULT_CHUNK_CELLS;
+    }
+    if (!QDir().mkpath(directory)) {
+        m_lastError = QString("无法创建目录: %1").arg(directory);
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    BinaryStlReader reader;
+    if (!reader.open(stlFile, m_lastError)) {
+        return false;
+    }
+
+    // 第一遍：有效单元数和包围盒
+    float corners[9];
+    int64_t cellCount = 0;
+    float bounds[6] = { std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+    while (reader.next(corners)) {
+        if (isDegenerate(corners)) {
+            continue;
+        }
+        ++cellCount;
+        for (int corner = 0; corner < 3; ++corner) {
+            for (int k = 0; k < 3; ++k) {
+                bounds[2 * k] = std::min(bounds[2 * k], corners[3 * corner + k]);
+                bounds[2 * k + 1] = std::max(bounds[2 * k + 1], corners[3 * corner + k]);
+            }
+        }
+    }
+    if (cellCount == 0 || cellCount > INT_MAX) {
+        m_lastError = QString("STL文件的三角形数量无效: %1").arg(stlFile);
+        return false;
+    }
+
+    // 分组格子：最长轴 GRID_RESOLUTION 格，其它轴按比例
+    double extent[3];
+    double longest = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        extent[k] = static_cast<double>(bounds[2 * k + 1]) - bounds[2 * k];
+        longest = std::max(longest, extent[k]);
+    }
+    int bins[3];
+    for (int k = 0; k < 3; ++k) {
+        bins[k] = longest > 0.0
+            ? std::max(1, std::min(GRID_RESOLUTION,
+                                   static_cast<int>(std::ceil(GRID_RESOLUTION * extent[k] / longest))))
+            : 1;
+    }
+    auto binCoordinate = [&](const float* t, int k) {
+        const double centroid = (static_cast<double>(t[k]) + t[3 + k] + t[6 + k]) / 3.0;
+        const int bin = extent[k] > 0.0
+            ? static_cast<int>((centroid - bounds[2 * k]) / extent[k] * bins[k]) : 0;
+        return std::max(0, std::min(bins[k] - 1, bin));
+    };
+    auto binOf = [&](const float* t) {
+        return (binCoordinate(t, 2) * bins[1] + binCoordinate(t, 1)) * bins[0] + binCoordinate(t, 0);
+    };
+
+    // 第二遍：每个格子的单元数
+    std::vector<int> binCounts(static_cast<size_t>(bins[0]) * bins[1] * bins[2], 0);
+    reader.rewind();
+    while (reader.next(corners)) {
+        if (!isDegenerate(corners)) {
+            ++binCounts[binOf(corners)];
+        }
+    }
+
+    // 非空格子按 Morton 顺序连成块，块内单元数不超过 chunkCells（单个格子超过时独占一块）
+    std::vector<std::pair<uint32_t, int>> order;
+    for (int z = 0; z < bins[2]; ++z) {
+        for (int y = 0; y < bins[1]; ++y) {
+            for (int x = 0; x < bins[0]; ++x) {
+                const int bin = (z * bins[1] + y) * bins[0] + x;
+                if (binCounts[bin] > 0) {
+                    order.push_back(std::make_pair(morton(x, y, z), bin));
+                }
+            }
+        }
+    }
+    std::sort(order.begin(), order.end());
+    std::vector<int> binChunk(binCounts.size(), -1);
+    std::vector<int64_t> chunkOffsets;
+    std::vector<int> chunkCounts;
+    int64_t offset = 0;
+    for (const std::pair<uint32_t, int>& entry : order) {
+        const int count = binCounts[entry.second];
+        if (chunkCounts.empty() || (chunkCounts.back() > 0 && chunkCounts.back() + count > chunkCells)) {
+            chunkOffsets.push_back(offset);
+            chunkCounts.push_back(0);
+        }
+        binChunk[entry.second] = static_cast<int>(chunkCounts.size()) - 1;
+        chunkCounts.back() += count;
+        offset += count;
+    }
+    const int chunkCount = static_cast<int>(chunkCounts.size());
+
+    // 第三遍：单元记录按块写入 cells.bin（内存映射，由系统换页）
+    QDir dir(directory);
+    QFile cellFile(dir.filePath("cells.bin"));
+    const qint64 cellBytes = cellCount * static_cast<qint64>(sizeof(CellRecord));
+    if (!cellFile.open(QIODevice::ReadWrite | QIODevice::Truncate) || !cellFile.resize(cellBytes)) {
+        m_lastError = QString("无法写入文件: %1").arg(cellFile.fileName());
+        return false;
+    }
+    uchar* cellData = cellFile.map(0, cellBytes);
+    if (!cellData) {
+        m_lastError = QString("无法映射文件: %1").arg(cellFile.fileName());
+        return false;
+    }
+
+    std::vector<int64_t> cursors = chunkOffsets;
+    std::vector<float> chunkBounds(6 * static_cast<size_t>(chunkCount));
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        for (int k = 0; k < 3; ++k) {
+            chunkBounds[6 * chunk + 2 * k] = std::numeric_limits<float>::max();
+            chunkBounds[6 * chunk + 2 * k + 1] = -std::numeric_limits<float>::max();
+        }
+    }
+    reader.rewind();
+    int32_t cellId = 0;
+    while (reader.next(corners)) {
+        if (isDegenerate(corners)) {
+            continue;
+        }
+        const int chunk = binChunk[binOf(corners)];
+        CellRecord record;
+        record.cellId = cellId++;
+        std::memcpy(record.corners, corners, sizeof(record.corners));
+        std::memcpy(cellData + cursors[chunk]++ * sizeof(CellRecord), &record, sizeof(CellRecord));
+        float* b = &chunkBounds[6 * chunk];
+        for (int corner = 0; corner < 3; ++corner) {
+            for (int k = 0; k < 3; ++k) {
+                b[2 * k] = std::min(b[2 * k], corners[3 * corner + k]);
+                b[2 * k + 1] = std::max(b[2 * k + 1], corners[3 * corner + k]);
+            }
+        }
+    }
+    cellFile.unmap(cellData);
+    cellFile.close();
+
+    // 标签初始全为0（每单元1字节，需要更多标签时由 setLabelCapacity() 转换）
+    QFile labelFile(dir.filePath("labels.bin"));
+    if (!labelFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || !labelFile.resize(cellCount)) {
+        m_lastError = QString("无法写入文件: %1").arg(labelFile.fileName());
+        return false;
+    }
+    labelFile.close();
+
+    QFile indexFile(dir.filePath("chunks.idx"));
+    if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = QString("无法写入文件: %1").arg(indexFile.fileName());
+        return false;
+    }
+    QDataStream out(&indexFile);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out.writeRawData(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    out << static_cast<qint32>(cellCount) << static_cast<qint32>(chunkCount);
+    for (int k = 0; k < 6; ++k) {
+        out << bounds[k];
+    }
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        out << static_cast<qint64>(chunkOffsets[chunk]) << static_cast<qint32>(chunkCounts[chunk]);
+        for (int k = 0; k < 6; ++k) {
+            out << chunkBounds[6 * chunk + k];
+        }
+    }
+    indexFile.close();
+
+    qDebug() << "Tiled" << stlFile << ":" << cellCount << "cells into" << chunkCount
+             << "chunks in" << timer.elapsed() << "ms";
+    return open(directory);
+}
+
+bool ChunkedMesh::open(const QString& directory)
+{
+    close();
+
+    QDir dir(directory);
+    QFile indexFile(dir.filePath("chunks.idx"));
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        m_lastError = QString("无法打开分块索引: %1").arg(indexFile.fileName());
+        return false;
+    }
+    QDataStream in(&indexFile);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    char magic[sizeof(INDEX_MAGIC)];
+    qint32 cellCount = 0;
+    qint32 chunkCount = 0;
+    if (in.readRawData(magic, sizeof(magic)) != sizeof(magic)
+        || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) {
+        m_lastError = QString("不是分块索引文件: %1").arg(indexFile.fileName());
+        return false;
+    }
+    in >> cellCount >> chunkCount;
+    for (int k = 0; k < 6; ++k) {
+        float value;
+        in >> value;
+        m_bounds[k] = value;
+    }
+    m_chunks.resize(std::max(0, chunkCount));
+    for (ChunkInfo& chunk : m_chunks) {
+        qint64 offset;
+        qint32 count;
+        in >> offset >> count;
+        chunk.offset = offset;
+        chunk.count = count;
+        for (int k = 0; k < 6; ++k) {
+            in >> chunk.bounds[k];
+        }
+    }
+    if (in.status() != QDataStream::Ok || cellCount <= 0) {
+        m_chunks.clear();
+        m_lastError = QString("分块索引已损坏: %1").arg(indexFile.fileName());
+        return false;
+    }
+
+    m_cellFile.setFileName(dir.filePath("cells.bin"));
+    if (!m_cellFile.open(QIODevice::ReadOnly)
+        || m_cellFile.size() != cellCount * static_cast<qint64>(sizeof(CellRecord))) {
+        m_chunks.clear();
+        m_cellFile.close();
+        m_lastError = QString("单元文件缺失或大小不符: %1").arg(m_cellFile.fileName());
+        return false;
+    }
+
+    // 每单元1字节或2字节（与 LabelArray 的 8/16 位存储相同），按文件大小识别
+    m_labelFile.setFileName(dir.filePath("labels.bin"));
+    const bool labelsOpen = m_labelFile.open(QIODevice::ReadWrite);
+    const qint64 labelSize = labelsOpen ? m_labelFile.size() : 0;
+    m_labelBytes = labelSize == 2 * static_cast<qint64>(cellCount) ? 2 : 1;
+    if (!labelsOpen || labelSize != m_labelBytes * static_cast<qint64>(cellCount)
+        || !(m_labels = m_labelFile.map(0, labelSize))) {
+        m_chunks.clear();
+        m_cellFile.close();
+        m_labelFile.close();
+        m_lastError = QString("标签文件缺失或无法映射: %1").arg(m_labelFile.fileName());
+        return false;
+    }
+
+    m_cellCount = cellCount;
+    m_directory = directory;
+    m_labelCapacity = m_labelBytes == 1 ? LabelArray::COMPACT_CAPACITY : LabelArray::MAX_CAPACITY;
+    qDebug() << "Opened chunked mesh" << directory << ":" << m_cellCount << "cells,"
+             << chunkCount << "chunks," << 8 * m_labelBytes << "-bit labels";
+    return true;
+}
+
+void ChunkedMesh::close()
+{
+    if (m_labels) {
+        // 共享映射的修改已在页缓存中，解除映射后由系统写回文件
+        m_labelFile.unmap(m_labels);
+        m_labels = nullptr;
+    }
+    m_labelFile.close();
+    m_cellFile.close();
+    m_chunks.clear();
+    m_undoStack.clear();
+    m_redoStack.clear();
+    m_residentBytes = 0;
+    m_cellCount = 0;
+    m_labelBytes = 1;
+    m_labelCapacity = LabelArray::COMPACT_CAPACITY;
+    m_directory.clear();
+}
+
+std::vector<int64_t> ChunkedMesh::labelCounts(int labelCount) const
+{
+    std::vector<int64_t> counts(std::max(0, labelCount), 0);
+    for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+        const int label = cellLabel(cellId);
+        if (label < labelCount) {
+            ++counts[label];
+        }
+    }
+    return counts;
+}
+
+bool ChunkedMesh::setLabelCapacity(int capacity)
+{
+    if (capacity < 1 || capacity > LabelArray::MAX_CAPACITY) {
+        m_lastError = QString("标签容量必须在 1 ~ %1 之间").arg(LabelArray::MAX_CAPACITY);
+        return false;
+    }
+    if (!isOpen()) {
+        m_lastError = "分块网格未打开";
+        return false;
+    }
+    if (capacity == m_labelCapacity) {
+        return true;
+    }
+
+    int highest = -1;
+    for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+        highest = std::max(highest, cellLabel(cellId));
+    }
+    if (highest >= capacity) {
+        m_lastError = QString("网格中已有标签 %1，标签容量至少为 %2").arg(highest).arg(highest + 1);
+        return false;
+    }
+
+    const int labelBytes = LabelArray::storageType(capacity) == VTK_UNSIGNED_CHAR ? 1 : 2;
+    if (labelBytes != m_labelBytes && !convertLabels(labelBytes)) {
+        return false;
+    }
+    if (capacity < m_labelCapacity) {
+        // 撤销可能恢复超出新容量的标签
+        m_undoStack.clear();
+        m_redoStack.clear();
+    }
+    m_labelCapacity = capacity;
+    return true;
+}
+
+bool ChunkedMesh::convertLabels(int labelBytes)
+{
+    const qint64 oldSize = m_labelBytes * static_cast<qint64>(m_cellCount);
+    const qint64 newSize = labelBytes * static_cast<qint64>(m_cellCount);
+    const qint64 mapSize = std::max(oldSize, newSize);
+    m_labelFile.unmap(m_labels);
+    m_labels = nullptr;
+
+    // 扩大时先加长文件，从后向前展开（第 i 个16位标签写在字节 2i 处，不会覆盖尚未读取的字节）；
+    // 缩小时从前向后收拢，之后截短文件
+    if (newSize > oldSize && !m_labelFile.resize(newSize)) {
+        m_labels = m_labelFile.map(0, oldSize);
+        m_lastError = QString("无法扩展标签文件: %1").arg(m_labelFile.fileName());
+        return false;
+    }
+    uchar* data = m_labelFile.map(0, mapSize);
+    if (!data) {
+        m_labelFile.resize(oldSize);
+        m_labels = m_labelFile.map(0, oldSize);
+        m_lastError = QString("无法映射文件: %1").arg(m_labelFile.fileName());
+        return false;
+    }
+    uint16_t* wide = reinterpret_cast<uint16_t*>(data);
+    if (labelBytes == 2) {
+        for (int cellId = m_cellCount - 1; cellId >= 0; --cellId) {
+            wide[cellId] = data[cellId];
+        }
+    } else {
+        for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+            data[cellId] = static_cast<uchar>(wide[cellId]);
+        }
+        m_labelFile.unmap(data);
+        m_labelFile.resize(newSize);
+        data = m_labelFile.map(0, newSize);
+    }
+
+    m_labels = data;
+    m_labelBytes = labelBytes;
+    if (!m_labels) {
+        m_lastError = QString("无法映射文件: %1").arg(m_labelFile.fileName());
+        close();
+        return false;
+    }
+
+    // 历史中的标签值不依赖存储宽度，不需要转换
+    qDebug() << "Chunked labels:" << 8 * labelBytes << "-bit";
+    return true;
+}
+
+void ChunkedMesh::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    evict();
+}
+
+void ChunkedMesh::prefetch(const double bounds[6])
+{
+    acquireChunks(bounds, true);
+}
+
+int ChunkedMesh::residentChunkCount() const
+{
+    int count = 0;
+    for (const ChunkInfo& chunk : m_chunks) {
+        count += chunk.cells ? 1 : 0;
+    }
+    return count;
+}
+
+bool ChunkedMesh::loadChunk(int chunk)
+{
+    ChunkInfo& info = m_chunks[chunk];
+    const qint64 bytes = static_cast<qint64>(info.count) * static_cast<qint64>(sizeof(CellRecord));
+    std::unique_ptr<std::vector<CellRecord>> cells(new std::vector<CellRecord>(info.count));
+    if (!m_cellFile.seek(info.offset * static_cast<qint64>(sizeof(CellRecord)))
+        || m_cellFile.read(reinterpret_cast<char*>(cells->data()), bytes) != bytes) {
+        qWarning() << "Failed to read chunk" << chunk;
+        return false;
+    }
+    info.cells = std::move(cells);
+    m_residentBytes += static_cast<size_t>(bytes);
+    return true;
+}
+
+void ChunkedMesh::evict()
+{
+    while (m_residentBytes > m_memoryBudget) {
+        int oldest = -1;
+        for (int chunk = 0; chunk < chunkCount(); ++chunk) {
+            const ChunkInfo& info = m_chunks[chunk];
+            if (info.cells && info.lastUsed != m_useCounter
+                && (oldest < 0 || info.lastUsed < m_chunks[oldest].lastUsed)) {
+                oldest = chunk;
+            }
+        }
+        if (oldest < 0) {
+            break;   // 剩下的都是本次操作正在使用的块
+        }
+        m_residentBytes -= m_chunks[oldest].cells->size() * sizeof(CellRecord);
+        m_chunks[oldest].cells.reset();
+    }
+}
+
+std::vector<int> ChunkedMesh::acquireChunks(const double bounds[6], bool limitToBudget)
+{
+    ++m_useCounter;
+    std::vector<int> acquired;
+    for (int chunk = 0; chunk < chunkCount(); ++chunk) {
+        ChunkInfo& info = m_chunks[chunk];
+        bool intersects = true;
+        for (int k = 0; k < 3; ++k) {
+            intersects = intersects && info.bounds[2 * k] <= bounds[2 * k + 1]
+                && info.bounds[2 * k + 1] >= bounds[2 * k];
+        }
+        if (!intersects) {
+            continue;
+        }
+        if (!info.cells) {
+            if (limitToBudget
+                && m_residentBytes + info.count * sizeof(CellRecord) > m_memoryBudget) {
+                continue;
+            }
+            if (!loadChunk(chunk)) {
+                continue;
+            }
+        }
+        info.lastUsed = m_useCounter;
+        acquired.push_back(chunk);
+    }
+    evict();
+    return acquired;
+}
+
+int ChunkedMesh::findCell(const double point[3])
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    // 按包围盒距离从近到远检查块，直到包围盒比已找到的最近单元更远
+    std::vector<std::pair<double, int>> order;
+    order.reserve(m_chunks.size());
+    for (int chunk = 0; chunk < chunkCount(); ++chunk) {
+        order.push_back(std::make_pair(boxDistance2(m_chunks[chunk].bounds, point), chunk));
+    }
+    std::sort(order.begin(), order.end());
+
+    ++m_useCounter;
+    double best = std::numeric_limits<double>::max();
+    int bestCell = -1;
+    for (const std::pair<double, int>& entry : order) {
+        if (entry.first >= best) {
+            break;
+        }
+        ChunkInfo& info = m_chunks[entry.second];
+        if (!info.cells && !loadChunk(entry.second)) {
+            continue;
+        }
+        info.lastUsed = m_useCounter;
+        for (const CellRecord& record : *info.cells) {
+            const double distance2 = TriangleBvh::pointTriangleDistance2(record.corners, point);
+            if (distance2 < best) {
+                best = distance2;
+                bestCell = record.cellId;
+            }
+        }
+    }
+    evict();
+    return bestCell;
+}
+
+std::vector<int> ChunkedMesh::labelWithBFS(const double* position, int startCellId,
+                                           double radius, int label)
+{
+    std::vector<int> affectedCells;
+    if (!isOpen() || startCellId < 0 || startCellId >= m_cellCount) {
+        return affectedCells;
+    }
+
+    // 可能在球内的单元都在与球的包围盒相交的块中
+    const double box[6] = { position[0] - radius, position[0] + radius,
+                            position[1] - radius, position[1] + radius,
+                            position[2] - radius, position[2] + radius };
+    const std::vector<int> chunks = acquireChunks(box, false);
+
+    // 球内单元：任一顶点在球内（与 MeshLabelCore::isCellInSphere 相同）
+    const double radiusSquared = radius * radius;
+    std::vector<const CellRecord*> inside;
+    int start = -1;
+    for (int chunk : chunks) {
+        for (const CellRecord& record : *m_chunks[chunk].cells) {
+            for (int corner = 0; corner < 3; ++corner) {
+                const double dx = position[0] - record.corners[3 * corner];
+                const double dy = position[1] - record.corners[3 * corner + 1];
+                const double dz = position[2] - record.corners[3 * corner + 2];
+                if (dx * dx + dy * dy + dz * dz < radiusSquared) {
+                    if (record.cellId == startCellId) {
+                        start = static_cast<int>(inside.size());
+                    }
+                    inside.push_back(&record);
+                    break;
+                }
+            }
+        }
+    }
+    if (start < 0) {
+        return affectedCells;   // 起始单元不在球内
+    }
+
+    // 共享顶点：角点按坐标排序，坐标相同的连续一段即同一顶点
+    std::vector<Corner> corners(3 * inside.size());
+    for (size_t cell = 0; cell < inside.size(); ++cell) {
+        for (int k = 0; k < 3; ++k) {
+            const float* p = &inside[cell]->corners[3 * k];
+            corners[3 * cell + k] = { p[0], p[1], p[2], static_cast<int>(3 * cell + k) };
+        }
+    }
+    auto less = [](const Corner& a, const Corner& b) {
+        return a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && a.z < b.z)));
+    };
+    std::sort(corners.begin(), corners.end(), less);
+    std::vector<int> vertexBegin;          // 每个顶点在 corners 中的起始位置
+    std::vector<int> slotVertex(corners.size());
+    for (size_t i = 0; i < corners.size(); ++i) {
+        if (i == 0 || less(corners[i - 1], corners[i])) {
+            vertexBegin.push_back(static_cast<int>(i));
+        }
+        slotVertex[corners[i].slot] = static_cast<int>(vertexBegin.size()) - 1;
+    }
+    vertexBegin.push_back(static_cast<int>(corners.size()));
+
+    // BFS：已是目标标签或受保护标签的单元不标注也不继续扩展（与 labelWithBFS 相同）
+    std::vector<char> visited(inside.size(), 0);
+    std::vector<int> queue;
+    queue.push_back(start);
+    visited[start] = 1;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int cell = queue[head];
+        const int cellId = inside[cell]->cellId;
+        const int currentLabel = cellLabel(cellId);
+        if (currentLabel == label || m_protectedLabels.test(currentLabel)) {
+            continue;
+        }
+        affectedCells.push_back(cellId);
+        for (int k = 0; k < 3; ++k) {
+            const int vertex = slotVertex[3 * cell + k];
+            for (int i = vertexBegin[vertex]; i < vertexBegin[vertex + 1]; ++i) {
+                const int neighbor = corners[i].slot / 3;
+                if (!visited[neighbor]) {
+                    visited[neighbor] = 1;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    }
+    return affectedCells;
+}
+
+bool ChunkedMesh::paintCells(const std::vector<int>& cellIds, int label)
+{
+    if (!isOpen()) {
+        m_lastError = "分块网格未打开";
+        return false;
+    }
+    if (label < 0 || label >= m_labelCapacity) {
+        m_lastError = QString("标签 %1 超出标签容量 %2").arg(label).arg(m_labelCapacity);
+        return false;
+    }
+
+    Stroke stroke;
+    stroke.newLabel = static_cast<uint16_t>(label);
+    stroke.cellIds.reserve(cellIds.size());
+    stroke.oldLabels.reserve(cellIds.size());
+    for (int cellId : cellIds) {
+        if (cellId >= 0 && cellId < m_cellCount) {
+            stroke.cellIds.push_back(cellId);
+            stroke.oldLabels.push_back(static_cast<uint16_t>(cellLabel(cellId)));
+            setCellLabel(cellId, label);
+        }
+    }
+    if (stroke.cellIds.empty()) {
+        return true;
+    }
+
+    m_undoStack.push_back(std::move(stroke));
+    if (static_cast<int>(m_undoStack.size()) > MAX_HISTORY_SIZE) {
+        m_undoStack.erase(m_undoStack.begin());
+    }
+    m_redoStack.clear();
+    return true;
+}
+
+bool ChunkedMesh::undo()
+{
+    if (m_undoStack.empty()) {
+        return false;
+    }
+    Stroke stroke = std::move(m_undoStack.back());
+    m_undoStack.pop_back();
+    for (size_t i = 0; i < stroke.cellIds.size(); ++i) {
+        setCellLabel(stroke.cellIds[i], stroke.oldLabels[i]);
+    }
+    m_redoStack.push_back(std::move(stroke));
+    return true;
+}
+
+bool ChunkedMesh::redo()
+{
+    if (m_redoStack.empty()) {
+        return false;
+    }
+    Stroke stroke = std::move(m_redoStack.back());
+    m_redoStack.pop_back();
+    for (int cellId : stroke.cellIds) {
+        setCellLabel(cellId, stroke.newLabel);
+    }
+    m_undoStack.push_back(std::move(stroke));
+    return true;
+}
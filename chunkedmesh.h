@@ -0,0 +1,291 @@
+/**
+ * @file chunkedmesh.h
+ * @brief 超大网格的外存分块模式（按空间分块存放在磁盘上，按需换入换出）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef CHUNKEDMESH_H
+#define CHUNKEDMESH_H
+
+#include "labelmask.h"
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 外存分块网格
+ *
+ * createFromSTL() 以流式方式读三遍二进制 STL（内存占用与网格规模无关），把三角形按质心所在的
+ * 空间格子分组，格子按 Morton 顺序连成每块约 chunkCells 个单元的块，写入目录中的三个文件：
+ * - chunks.idx：块索引（每块在 cells.bin 中的位置、单元数、实际包围盒）
+ * - cells.bin：按块连续存放的单元记录（全局单元ID + 三个顶点坐标）
+ * - labels.bin：每单元的标签，打开后内存映射，写入直接落到页缓存。存储规则与内存模式的标签数组
+ *   相同（LabelArray）：标签容量不超过 256 时每单元1字节，否则2字节（本机字节序），
+ *   打开时按文件大小识别
+ *
+ * 单元ID与 vtkSTLReader 加载同一文件得到的单元ID一致（同样跳过有重合顶点的退化三角形），
+ * 因此标签文件可以直接对应回完整网格。
+ *
+ * 打开后块按需读入，按最近使用顺序在内存预算内换出。画刷只读入与画刷球包围盒相交的块
+ * （块包围盒是块内三角形的实际包围盒，跨块边界的三角形也不会漏），
+ * 在这些块的球内单元上按共享顶点（坐标完全相同即同一顶点，与 STL 加载时的合并规则相同）做 BFS，
+ * 跳过 setProtectedLabels() 设置的锁定/隐藏标签，得到的单元集合与内存模式的
+ * MeshLabelCore::labelWithBFS() 相同；不支持感兴趣区域（clip box），设置了区域的内存模式
+ * 只会选中其中的子集。
+ *
+ * 目前是无界面的后端：由 meshlabeler_batch 的 tile（分块）和 paint（按笔画文件标注）命令使用。
+ * 界面仍把整个网格加载为 vtkPolyData，没有按光标和视野换页；prefetch() 供知道视野的调用方使用。
+ */
+class ChunkedMesh {
+public:
+    static constexpr int DEFAULT_CHUNK_CELLS = 65536;                 ///< 默认每块单元数
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 512u * 1024 * 1024; ///< 默认常驻块内存预算（字节）
+    static constexpr int MAX_HISTORY_SIZE = 100;                      ///< 最大历史记录数
+
+    ChunkedMesh();
+    ~ChunkedMesh();
+
+    ChunkedMesh(const ChunkedMesh&) = delete;
+    ChunkedMesh& operator=(const ChunkedMesh&) = delete;
+
+    // ==================== 创建/打开 ====================
+    /**
+     * @brief 把二进制 STL 分块写入目录并打开
+     * @param stlFile 输入 STL 文件
+     * @param directory 输出目录（不存在时创建）
+     * @param chunkCells 每块的目标单元数
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool createFromSTL(const QString& stlFile, const QString& directory,
+                       int chunkCells = DEFAULT_CHUNK_CELLS);
+
+    /**
+     * @brief 打开已分块的目录
+     * @param directory 目录
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool open(const QString& directory);
+
+    /**
+     * @brief 关闭（解除标签映射并释放所有块）
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const { return m_labels != nullptr; }
+
+    /**
+     * @brief 获取最近一次错误信息
+     */
+    const QString& lastError() const { return m_lastError; }
+
+    // ==================== 查询 ====================
+    /**
+     * @brief 单元总数
+     */
+    int cellCount() const { return m_cellCount; }
+
+    /**
+     * @brief 块数量
+     */
+    int chunkCount() const { return static_cast<int>(m_chunks.size()); }
+
+    /**
+     * @brief 整个网格的包围盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    const double* bounds() const { return m_bounds; }
+
+    /**
+     * @brief 获取单元的标签
+     */
+    int cellLabel(int cellId) const
+    {
+        return m_labelBytes == 1 ? m_labels[cellId]
+                                 : reinterpret_cast<const uint16_t*>(m_labels)[cellId];
+    }
+
+    /**
+     * @brief 标签容量（打开时取存储类型的上限：1字节为 256，2字节为 65536）
+     */
+    int labelCapacity() const { return m_labelCapacity; }
+
+    /**
+     * @brief 设置标签容量，存储类型改变时就地转换 labels.bin
+     *
+     * 与 MeshLabelCore::setLabelCapacity() 规则相同：不能小于已有的最大标签 + 1，缩小时清空历史。
+     * @param capacity 标签容量（1 ~ 65536）
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool setLabelCapacity(int capacity);
+
+    /**
+     * @brief 统计每个标签的单元数量（顺序扫描内存映射的标签）
+     * @param labelCount 标签数量
+     */
+    std::vector<int64_t> labelCounts(int labelCount) const;
+
+    /**
+     * @brief 查找离点最近的单元（按需读入附近的块）
+     * @param point 查询点
+     * @return 单元ID，没有单元时返回-1
+     */
+    int findCell(const double point[3]);
+
+    // ==================== 换页 ====================
+    /**
+     * @brief 设置常驻块的内存预算（超出时换出最久未用的块）
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief 预先读入与区域相交的块（如当前视野），预算允许的范围内
+     * @param bounds 区域包围盒
+     */
+    void prefetch(const double bounds[6]);
+
+    /**
+     * @brief 当前常驻的块数量
+     */
+    int residentChunkCount() const;
+
+    /**
+     * @brief 常驻块占用的内存（字节）
+     */
+    size_t residentBytes() const { return m_residentBytes; }
+
+    // ==================== 标注 ====================
+    /**
+     * @brief 设置画刷不修改也不穿过的标签（对应 MeshLabelCore 的锁定和隐藏标签）
+     */
+    void setProtectedLabels(const LabelMask& labels) { m_protectedLabels = labels; }
+
+    /**
+     * @brief 画刷不修改的标签
+     */
+    const LabelMask& protectedLabels() const { return m_protectedLabels; }
+
+    /**
+     * @brief 收集画刷球内需要标注的单元
+     *
+     * 与锁定/隐藏相同标签、未设置感兴趣区域的 MeshLabelCore::labelWithBFS() 结果相同。
+     * @param position 球心位置
+     * @param startCellId 起始单元ID
+     * @param radius 球半径
+     * @param label 目标标签
+     * @return 受影响的单元ID列表
+     */
+    std::vector<int> labelWithBFS(const double* position, int startCellId,
+                                  double radius, int label);
+
+    /**
+     * @brief 标注单元并记录历史（一次调用为一个撤销步骤）
+     * @param cellIds 单元ID列表
+     * @param label 标签值（0 ~ labelCapacity() - 1）
+     * @return 成功返回true；未打开或标签超出容量时返回false（错误信息见 lastError()）
+     */
+    bool paintCells(const std::vector<int>& cellIds, int label);
+
+    /**
+     * @brief 撤销
+     * @return 成功撤销返回true
+     */
+    bool undo();
+
+    /**
+     * @brief 重做
+     * @return 成功重做返回true
+     */
+    bool redo();
+
+    bool canUndo() const { return !m_undoStack.empty(); }
+    bool canRedo() const { return !m_redoStack.empty(); }
+
+private:
+    /**
+     * @brief 磁盘和内存中的单元记录
+     */
+    struct CellRecord {
+        int32_t cellId;       ///< 全局单元ID
+        float corners[9];     ///< 三个顶点坐标
+    };
+
+    /**
+     * @brief 块索引
+     */
+    struct ChunkInfo {
+        int64_t offset = 0;            ///< 第一条记录在 cells.bin 中的序号
+        int count = 0;                 ///< 单元数
+        float bounds[6] = {};          ///< 块内三角形的实际包围盒
+        std::unique_ptr<std::vector<CellRecord>> cells; ///< 常驻时的单元记录（未读入时为空）
+        uint64_t lastUsed = 0;         ///< 最近一次使用的序号
+    };
+
+    /**
+     * @brief 一次标注的撤销信息
+     */
+    struct Stroke {
+        std::vector<int> cellIds;        ///< 单元ID
+        std::vector<uint16_t> oldLabels; ///< 旧标签
+        uint16_t newLabel = 0;           ///< 新标签
+    };
+
+    /**
+     * @brief 读入与包围盒相交的块并返回块编号（读入后按预算换出其它块）
+     * @param bounds 包围盒
+     * @param limitToBudget 为true时读满预算即停止（预取），否则全部读入
+     */
+    std::vector<int> acquireChunks(const double bounds[6], bool limitToBudget);
+
+    /**
+     * @brief 读入一个块
+     */
+    bool loadChunk(int chunk);
+
+    /**
+     * @brief 按最近使用顺序换出块，直到不超过预算（当前操作正在使用的块不换出）
+     */
+    void evict();
+
+    /**
+     * @brief 写入一个单元的标签
+     */
+    void setCellLabel(int cellId, int label)
+    {
+        if (m_labelBytes == 1) {
+            m_labels[cellId] = static_cast<uchar>(label);
+        } else {
+            reinterpret_cast<uint16_t*>(m_labels)[cellId] = static_cast<uint16_t>(label);
+        }
+    }
+
+    /**
+     * @brief 把 labels.bin 就地转换为每单元 labelBytes 字节并重新映射
+     */
+    bool convertLabels(int labelBytes);
+
+    QString m_directory;                  ///< 分块目录
+    QString m_lastError;                  ///< 最近一次错误信息
+    int m_cellCount;                      ///< 单元总数
+    double m_bounds[6];                   ///< 网格包围盒
+    std::vector<ChunkInfo> m_chunks;      ///< 块索引和常驻数据
+    QFile m_cellFile;                     ///< cells.bin
+    QFile m_labelFile;                    ///< labels.bin
+    uchar* m_labels;                      ///< 内存映射的标签
+    int m_labelBytes;                     ///< 每个标签的字节数（1 或 2）
+    int m_labelCapacity;                  ///< 标签容量
+    size_t m_memoryBudget;                ///< 常驻块内存预算
+    size_t m_residentBytes;               ///< 常驻块占用的内存
+    uint64_t m_useCounter;                ///< 使用计数（ChunkInfo::lastUsed）
+    std::vector<Stroke> m_undoStack;      ///< 撤销栈
+    std::vector<Stroke> m_redoStack;      ///< 重做栈
+    LabelMask m_protectedLabels;          ///< 画刷不修改的标签
+};
+
+#endif // CHUNKEDMESH_H
@@ -0,0 +1,110 @@
+/**
+ * @file geodesicengine.cpp
+ * @brief GeodesicEngine 测地距离引擎的实现
+ */
+
+#include "geodesicengine.h"
+#include "meshadjacency.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+void GeodesicEngine::beginQuery(int pointCount, int cellCount)
+{
+    if (static_cast<int>(m_vertexStamp.size()) != pointCount
+        || static_cast<int>(m_cellStamp.size()) != cellCount) {
+        m_distance.assign(pointCount, 0.0);
+        m_vertexStamp.assign(pointCount, 0);
+        m_cellStamp.assign(cellCount, 0);
+        m_generation = 0;
+    }
+
+    // 代号回绕时清零一次
+    if (++m_generation == 0) {
+        std::fill(m_vertexStamp.begin(), m_vertexStamp.end(), 0);
+        std::fill(m_cellStamp.begin(), m_cellStamp.end(), 0);
+        m_generation = 1;
+    }
+
+    m_heap.clear();
+    m_reached.clear();
+}
+
+int GeodesicEngine::run(const MeshAdjacency& adjacency, const GeodesicSeed* seeds,
+                        int seedCount, double radius)
+{
+    beginQuery(adjacency.pointCount(), adjacency.cellCount());
+
+    const std::greater<HeapEntry> compare;
+    for (int i = 0; i < seedCount; ++i) {
+        const GeodesicSeed& seed = seeds[i];
+        if (seed.vertex < 0 || seed.vertex >= adjacency.pointCount() || !(seed.distance < radius)) {
+            continue;
+        }
+        if (m_vertexStamp[seed.vertex] == m_generation && m_distance[seed.vertex] <= seed.distance) {
+            continue;
+        }
+        m_vertexStamp[seed.vertex] = m_generation;
+        m_distance[seed.vertex] = seed.distance;
+        m_heap.push_back({ seed.distance, seed.vertex });
+        std::push_heap(m_heap.begin(), m_heap.end(), compare);
+    }
+
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), compare);
+        const HeapEntry entry = m_heap.back();
+        m_heap.pop_back();
+
+        // 惰性删除：已有更短的路径
+        if (entry.distance > m_distance[entry.vertex]) {
+            continue;
+        }
+        m_reached.push_back(entry.vertex);
+
+        for (int i = adjacency.neighborBegin(entry.vertex); i < adjacency.neighborEnd(entry.vertex); ++i) {
+            const int next = adjacency.neighbor(i);
+            const double distance = entry.distance + adjacency.edgeLength(i);
+            if (!(distance < radius)) {
+                continue;
+            }
+            if (m_vertexStamp[next] == m_generation && m_distance[next] <= distance) {
+                continue;
+            }
+            m_vertexStamp[next] = m_generation;
+            m_distance[next] = distance;
+            m_heap.push_back({ distance, next });
+            std::push_heap(m_heap.begin(), m_heap.end(), compare);
+        }
+    }
+
+    return static_cast<int>(m_reached.size());
+}
+
+double GeodesicEngine::distance(int vertex) const
+{
+    if (vertex < 0 || vertex >= static_cast<int>(m_vertexStamp.size())
+        || m_vertexStamp[vertex] != m_generation) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_distance[vertex];
+}
+
+void GeodesicEngine::collectCells(const MeshAdjacency& adjacency, std::vector<int>& cells)
+{
+    for (int vertex : m_reached) {
+        for (const int* it = adjacency.vertexCellsBegin(vertex); it != adjacency.vertexCellsEnd(vertex); ++it) {
+            if (m_cellStamp[*it] != m_generation) {
+                m_cellStamp[*it] = m_generation;
+                cells.push_back(*it);
+            }
+        }
+    }
+}
+
+size_t GeodesicEngine::memoryBytes() const
+{
+    return m_distance.capacity() * sizeof(double)
+        + (m_vertexStamp.capacity() + m_cellStamp.capacity()) * sizeof(uint32_t)
+        + m_heap.capacity() * sizeof(HeapEntry) + m_reached.capacity() * sizeof(int);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file geodesicengine.h
+ * @brief 有界 Dijkstra 测地距离引擎（用于测地画刷）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef GEODESICENGINE_H
+#define GEODESICENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MeshAdjacency;
+
+/**
+ * @brief 测地距离的起点
+ */
+struct GeodesicSeed {
+    int vertex;         ///< 顶点ID
+    double distance;    ///< 初始距离（拾取点到该顶点的距离）
+};
+
+/**
+ * @brief 有界测地距离引擎
+ *
+ * 沿网格边做 Dijkstra 最短路，超过半径的顶点不再扩展，因此每次查询的代价
+ * 只与画刷覆盖的顶点数有关，与网格规模无关。
+ * 距离、访问标记和堆在多次查询间复用：用递增的代号代替清零，
+ * 首次使用后的查询不再分配内存。
+ */
+class GeodesicEngine {
+public:
+    /**
+     * @brief 计算半径内各顶点的测地距离
+     * @param adjacency 网格邻接关系
+     * @param seeds 起点数组
+     * @param seedCount 起点数量
+     * @param radius 测地半径
+     * @return 半径内的顶点数量
+     */
+    int run(const MeshAdjacency& adjacency, const GeodesicSeed* seeds, int seedCount,
+            double radius);
+
+    /**
+     * @brief 上一次 run() 中半径内的顶点（按距离递增）
+     */
+    const std::vector<int>& reachedVertices() const { return m_reached; }
+
+    /**
+     * @brief 上一次 run() 中顶点的测地距离（未到达返回无穷大）
+     */
+    double distance(int vertex) const;
+
+    /**
+     * @brief 收集至少有一个顶点在半径内的单元（每个单元只出现一次）
+     * @param adjacency 网格邻接关系（与 run() 相同）
+     * @param cells 输出单元ID（追加）
+     */
+    void collectCells(const MeshAdjacency& adjacency, std::vector<int>& cells);
+
+    /**
+     * @brief 缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct HeapEntry {
+        double distance;
+        int vertex;
+        bool operator>(const HeapEntry& other) const { return distance > other.distance; }
+    };
+
+    /**
+     * @brief 开始新一轮查询（必要时扩容，推进代号）
+     */
+    void beginQuery(int pointCount, int cellCount);
+
+    std::vector<double> m_distance;          ///< 顶点距离（代号匹配时有效）
+    std::vector<uint32_t> m_vertexStamp;     ///< 顶点代号
+    std::vector<uint32_t> m_cellStamp;       ///< 单元代号（collectCells 去重）
+    std::vector<HeapEntry> m_heap;           ///< 最小堆（惰性删除）
+    std::vector<int> m_reached;              ///< 半径内的顶点
+    uint32_t m_generation = 0;               ///< 当前代号
+};
+
+#endif // GEODESICENGINE_H
@@ -0,0 +1,162 @@
+/**
+ * @file graphcutrefiner.cpp
+ * @brief GraphCutRefiner 图割边界细化的实现
+ */
+
+#include "graphcutrefiner.h"
+#include "meshadjacency.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float HARD_CAPACITY = 1e30f;   ///< 硬约束的容量（不会被割开）
+
+} // namespace
+
+double GraphCutRefiner::refine(const MeshAdjacency& adjacency, std::vector<int>& labels,
+                               int foreground, int background, int bandRings,
+                               double featureAngle, std::vector<int>& changedCells)
+{
+    changedCells.clear();
+    m_band.clear();
+    m_ring.clear();
+
+    const int cellCount = adjacency.cellCount();
+    if (cellCount == 0 || static_cast<int>(labels.size()) < cellCount
+        || foreground == background || !adjacency.hasCellGeometry()) {
+        return 0.0;
+    }
+    if (static_cast<int>(m_nodeIndex.size()) != cellCount) {
+        m_nodeIndex.assign(cellCount, -1);
+    }
+
+    // 交界单元：前景与背景相邻（并行扫描，按块收集后拼接）
+    const int chunks = ParallelUtils::chunkCount(0, cellCount);
+    std::vector<std::vector<int>> seams(chunks);
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int chunk) {
+            for (int cell = static_cast<int>(begin); cell < end; ++cell) {
+                const int label = labels[cell];
+                if (label != foreground && label != background) {
+                    continue;
+                }
+                const int other = label == foreground ? background : foreground;
+                for (const int* it = adjacency.cellNeighborsBegin(cell);
+                     it != adjacency.cellNeighborsEnd(cell); ++it) {
+                    if (labels[*it] == other) {
+                        seams[chunk].push_back(cell);
+                        break;
+                    }
+                }
+            }
+        });
+    for (const std::vector<int>& cells : seams) {
+        for (int cell : cells) {
+            m_nodeIndex[cell] = static_cast<int>(m_band.size());
+            m_band.push_back(cell);
+            m_ring.push_back(0);
+        }
+    }
+    if (m_band.empty()) {
+        return 0.0;
+    }
+
+    // 待定带：只在前景和背景单元中向两侧扩展
+    size_t ringBegin = 0;
+    for (int ring = 1; ring <= bandRings; ++ring) {
+        const size_t ringEnd = m_band.size();
+        for (size_t i = ringBegin; i < ringEnd; ++i) {
+            for (const int* it = adjacency.cellNeighborsBegin(m_band[i]);
+                 it != adjacency.cellNeighborsEnd(m_band[i]); ++it) {
+                const int label = labels[*it];
+                if (m_nodeIndex[*it] < 0 && (label == foreground || label == background)) {
+                    m_nodeIndex[*it] = static_cast<int>(m_band.size());
+                    m_band.push_back(*it);
+                    m_ring.push_back(ring);
+                }
+            }
+        }
+        ringBegin = ringEnd;
+    }
+
+    const int nodeCount = static_cast<int>(m_band.size());
+    m_graph.reset(nodeCount);
+
+    const double degToRad = 3.14159265358979323846 / 180.0;
+    const double sharpness = std::max(1e-6, 1.0 - std::cos(featureAngle * degToRad));
+    bool hardForeground = false;
+    bool hardBackground = false;
+    int deepestForeground = 0;
+    int deepestBackground = 0;
+
+    for (int node = 0; node < nodeCount; ++node) {
+        const int cell = m_band[node];
+        if (labels[cell] == foreground) {
+            deepestForeground = std::max(deepestForeground, m_ring[node]);
+        } else {
+            deepestBackground = std::max(deepestBackground, m_ring[node]);
+        }
+
+        const float* normal = adjacency.cellNormal(cell);
+        const int offset = adjacency.cellNeighborOffset(cell);
+        const int* begin = adjacency.cellNeighborsBegin(cell);
+        for (const int* it = begin; it != adjacency.cellNeighborsEnd(cell); ++it) {
+            const int neighbor = *it;
+            const int neighborNode = m_nodeIndex[neighbor];
+            if (neighborNode >= 0 && neighbor < cell) {
+                continue;   // 带内的边只从编号小的一侧添加一次
+            }
+
+            const float* neighborNormal = adjacency.cellNormal(neighbor);
+            const double cosine = static_cast<double>(normal[0]) * neighborNormal[0]
+                + static_cast<double>(normal[1]) * neighborNormal[1]
+                + static_cast<double>(normal[2]) * neighborNormal[2];
+            const float weight = static_cast<float>(
+                adjacency.sharedEdgeLength(offset + static_cast<int>(it - begin))
+                * std::exp(-(1.0 - cosine) / sharpness));
+
+            if (neighborNode >= 0) {
+                m_graph.addEdge(node, neighborNode, weight, weight);
+            } else if (labels[neighbor] == foreground) {
+                m_graph.addEdge(m_graph.source(), node, weight, 0.0f);
+                hardForeground = true;
+            } else if (labels[neighbor] == background) {
+                m_graph.addEdge(node, m_graph.sink(), weight, 0.0f);
+                hardBackground = true;
+            }
+            // 其它标签的邻居不参与：割开这样的边没有代价
+        }
+    }
+
+    // 某一侧整个落在带内（区域比带窄）时，用该侧最深的一圈作为硬约束，防止整块消失
+    for (int node = 0; node < nodeCount; ++node) {
+        const bool isForeground = labels[m_band[node]] == foreground;
+        if (isForeground && !hardForeground && m_ring[node] == deepestForeground) {
+            m_graph.addEdge(m_graph.source(), node, HARD_CAPACITY, 0.0f);
+        } else if (!isForeground && !hardBackground && m_ring[node] == deepestBackground) {
+            m_graph.addEdge(node, m_graph.sink(), HARD_CAPACITY, 0.0f);
+        }
+    }
+
+    const double cut = m_graph.solve();
+
+    for (int node = 0; node < nodeCount; ++node) {
+        const int cell = m_band[node];
+        const int label = m_graph.isSourceSide(node) ? foreground : background;
+        if (labels[cell] != label) {
+            labels[cell] = label;
+            changedCells.push_back(cell);
+        }
+        m_nodeIndex[cell] = -1;
+    }
+    return cut;
+}
+
+size_t GraphCutRefiner::memoryBytes() const
+{
+    return m_graph.memoryBytes()
+        + (m_nodeIndex.capacity() + m_band.capacity() + m_ring.capacity()) * sizeof(int);
+}
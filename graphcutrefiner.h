@@ -0,0 +1,62 @@
+/**
+ * @file graphcutrefiner.h
+ * @brief 用图割把两个标签之间的边界吸附到特征边
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef GRAPHCUTREFINER_H
+#define GRAPHCUTREFINER_H
+
+#include "maxflowgraph.h"
+
+#include <vector>
+
+class MeshAdjacency;
+
+/**
+ * @brief 图割边界细化
+ *
+ * 在前景/背景两个标签交界处取若干圈单元作为待定带，带外的单元作为硬约束
+ * （与源点/汇点合并），在单元对偶图上求最小割。割开一条共边的代价是
+ * 公共边长 × exp(-(1 - cosθ) / (1 - cos特征角))，θ 为两侧面片法向夹角，
+ * 因此边界会沿尖锐的特征边走，平坦区域则取最短。只有带内单元进入图，
+ * 内存和求解时间与带的大小有关，与网格规模无关。
+ */
+class GraphCutRefiner {
+public:
+    static constexpr int DEFAULT_BAND_RINGS = 8;    ///< 默认带宽（交界向两侧扩展的圈数）
+
+    /**
+     * @brief 细化前景与背景之间的边界
+     * @param adjacency 网格邻接关系（需要 buildCellGeometry() 的法向和公共边长）
+     * @param labels 每个单元的标签，原地修改（只会在前景和背景之间改变）
+     * @param foreground 前景标签
+     * @param background 背景标签
+     * @param bandRings 待定带宽：交界单元向两侧扩展的圈数
+     * @param featureAngle 特征角（度），夹角达到该值的边代价降为 1/e
+     * @param changedCells 输出标签改变的单元
+     * @return 最小割的代价（没有交界时为0）
+     */
+    double refine(const MeshAdjacency& adjacency, std::vector<int>& labels,
+                  int foreground, int background, int bandRings, double featureAngle,
+                  std::vector<int>& changedCells);
+
+    /**
+     * @brief 上一次 refine() 的待定带单元数
+     */
+    int bandSize() const { return static_cast<int>(m_band.size()); }
+
+    /**
+     * @brief 缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    MaxFlowGraph m_graph;          ///< 最大流图（复用缓冲区）
+    std::vector<int> m_nodeIndex;  ///< 单元 -> 带内节点编号（-1 表示不在带内）
+    std::vector<int> m_band;       ///< 带内单元（节点编号即下标）
+    std::vector<int> m_ring;       ///< 带内单元到交界的圈数
+};
+
+#endif // GRAPHCUTREFINER_H
@@ -2,7 +2,7 @@
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -17,12 +17,55 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     main.cpp \
+    brushpipeline.cpp \
+    chunkedmesh.cpp \
+    geodesicengine.cpp \
+    graphcutrefiner.cpp \
+    labelarray.cpp \
+    labelcomponents.cpp \
+    labelhistogramwidget.cpp \
+    labelsmoother.cpp \
+    labelstatistics.cpp \
+    latencyprofiler.cpp \
     mainwindow.cpp \
-    meshlabeler.cpp
+    maxflowgraph.cpp \
+    memoryreport.cpp \
+    meshadjacency.cpp \
+    meshgenerator.cpp \
+    meshlabelcore.cpp \
+    meshlabeler.cpp \
+    parallelutils.cpp \
+    pointlabels.cpp \
+    renderchunks.cpp \
+    renderscheduler.cpp \
+    trianglebvh.cpp
 
 HEADERS += \
+    brushpipeline.h \
+    chunkedmesh.h \
+    geodesicengine.h \
+    graphcutrefiner.h \
+    labelarray.h \
+    labelcomponents.h \
+    labelhistogramwidget.h \
+    labelmask.h \
+    labelsmoother.h \
+    labelstatistics.h \
+    latencyprofiler.h \
     mainwindow.h \
-    meshlabeler.h
+    maxflowgraph.h \
+    memoryreport.h \
+    meshadjacency.h \
+    meshgenerator.h \
+    meshlabelcore.h \
+    meshlabeler.h \
+    parallelutils.h \
+    pointlabels.h \
+    regiongrower.h \
+    renderchunks.h \
+    renderscheduler.h \
+    trianglebvh.h \
+    visitstamps.h
 
 FORMS += \
     mainwindow.ui
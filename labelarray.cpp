@@ -0,0 +1,119 @@
+/**
+ * @file labelarray.cpp
+ * @brief LabelArray 紧凑标签存储的实现
+ */
+
+#include "labelarray.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <vtkDataArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnsignedShortArray.h>
+
+int LabelArray::storageType(int capacity)
+{
+    return capacity <= COMPACT_CAPACITY ? VTK_UNSIGNED_CHAR : VTK_UNSIGNED_SHORT;
+}
+
+vtkSmartPointer<vtkDataArray> LabelArray::create(int capacity, vtkIdType count)
+{
+    vtkSmartPointer<vtkDataArray> array;
+    if (storageType(capacity) == VTK_UNSIGNED_CHAR) {
+        array = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    } else {
+        array = vtkSmartPointer<vtkUnsignedShortArray>::New();
+    }
+    array->SetName("Label");
+    array->SetNumberOfTuples(count);
+    array->FillComponent(0, 0.0);
+    return array;
+}
+
+vtkSmartPointer<vtkDataArray> LabelArray::convert(vtkDataArray* array, int capacity)
+{
+    if (array->GetDataType() == storageType(capacity) && array->GetNumberOfComponents() == 1) {
+        return array;
+    }
+
+    int minLabel;
+    int maxLabel;
+    range(array, minLabel, maxLabel);
+    if (minLabel <= maxLabel && (minLabel < 0 || maxLabel >= capacity)) {
+        return nullptr;
+    }
+
+    const vtkIdType count = array->GetNumberOfTuples();
+    vtkSmartPointer<vtkDataArray> converted = create(capacity, count);
+    const LabelView source(array);
+    const LabelView target(converted);
+    if (source.isValid()) {
+        ParallelUtils::forChunks(0, count, ParallelUtils::DEFAULT_MIN_CHUNK,
+            [&source, &target](int64_t begin, int64_t end, int) {
+                for (int64_t i = begin; i < end; ++i) {
+                    target.set(i, source.get(i));
+                }
+            });
+    } else {
+        for (vtkIdType i = 0; i < count; ++i) {
+            target.set(i, static_cast<int>(array->GetComponent(i, 0)));
+        }
+    }
+    return converted;
+}
+
+void LabelArray::range(vtkDataArray* array, int& minLabel, int& maxLabel)
+{
+    minLabel = std::numeric_limits<int>::max();
+    maxLabel = std::numeric_limits<int>::min();
+    const vtkIdType count = array ? array->GetNumberOfTuples() : 0;
+    if (count == 0) {
+        return;
+    }
+
+    const LabelView view(array);
+    if (!view.isValid()) {
+        for (vtkIdType i = 0; i < count; ++i) {
+            const int label = static_cast<int>(array->GetComponent(i, 0));
+            minLabel = std::min(minLabel, label);
+            maxLabel = std::max(maxLabel, label);
+        }
+        return;
+    }
+
+    const int chunks = ParallelUtils::chunkCount(0, count);
+    std::vector<int> chunkMin(chunks, std::numeric_limits<int>::max());
+    std::vector<int> chunkMax(chunks, std::numeric_limits<int>::min());
+    ParallelUtils::forChunks(0, count, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int chunk) {
+            int low = chunkMin[chunk];
+            int high = chunkMax[chunk];
+            for (int64_t i = begin; i < end; ++i) {
+                const int label = view.get(i);
+                low = std::min(low, label);
+                high = std::max(high, label);
+            }
+            chunkMin[chunk] = low;
+            chunkMax[chunk] = high;
+        });
+    minLabel = *std::min_element(chunkMin.begin(), chunkMin.end());
+    maxLabel = *std::max_element(chunkMax.begin(), chunkMax.end());
+}
+
+// ==================== LabelView ====================
+
+LabelView::LabelView(vtkDataArray* array)
+    : m_data(nullptr)
+    , m_type(VTK_VOID)
+{
+    if (!array || array->GetNumberOfComponents() != 1) {
+        return;
+    }
+    m_type = array->GetDataType();
+    if (m_type == VTK_UNSIGNED_CHAR || m_type == VTK_UNSIGNED_SHORT || m_type == VTK_FLOAT) {
+        m_data = array->GetVoidPointer(0);
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file labelarray.h
+ * @brief 标签数组的紧凑存储（按标签容量选择 8 位或 16 位整数）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELARRAY_H
+#define LABELARRAY_H
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+class vtkDataArray;
+
+/**
+ * @brief 标签数组的创建和存储类型转换
+ *
+ * 标签容量不超过 256 时用 vtkUnsignedCharArray（每个标签1字节），否则用 vtkUnsignedShortArray
+ * （2字节，最多 65536 个标签）。旧版本保存的 float 标签在加载时转换为紧凑类型。
+ */
+class LabelArray {
+public:
+    static constexpr int MAX_CAPACITY = 65536;      ///< 标签容量上限（标签值 0~65535）
+    static constexpr int COMPACT_CAPACITY = 256;    ///< 8 位存储的容量上限
+
+    /**
+     * @brief 容量对应的存储类型（VTK_UNSIGNED_CHAR 或 VTK_UNSIGNED_SHORT）
+     */
+    static int storageType(int capacity);
+
+    /**
+     * @brief 创建名为 Label 的单分量标签数组（全部为0）
+     * @param capacity 标签容量
+     * @param count 元素数量
+     */
+    static vtkSmartPointer<vtkDataArray> create(int capacity, vtkIdType count);
+
+    /**
+     * @brief 把标签数组转换为容量对应的存储类型（并行）
+     * @param array 标签数组（任意数值类型，取第一个分量）
+     * @param capacity 标签容量
+     * @return 新数组；已是该类型时返回原数组；有超出 [0, capacity) 的标签时返回空
+     */
+    static vtkSmartPointer<vtkDataArray> convert(vtkDataArray* array, int capacity);
+
+    /**
+     * @brief 标签数组中的最小和最大标签（并行；空数组时 minLabel > maxLabel）
+     */
+    static void range(vtkDataArray* array, int& minLabel, int& maxLabel);
+};
+
+/**
+ * @brief 单分量标签数组的直接访问（8/16 位整数或 float）
+ *
+ * 不经过 GetTuple1 的虚调用和共享的元组缓冲区，可在多个线程上同时读取。
+ * 其它类型或多分量数组 isValid() 为 false，调用方改用 vtkDataArray 接口。
+ */
+class LabelView {
+public:
+    explicit LabelView(vtkDataArray* array);
+
+    /**
+     * @brief 是否支持直接访问
+     */
+    bool isValid() const { return m_data != nullptr; }
+
+    /**
+     * @brief 读取一个标签
+     */
+    int get(vtkIdType id) const
+    {
+        switch (m_type) {
+        case VTK_UNSIGNED_CHAR:
+            return static_cast<const unsigned char*>(m_data)[id];
+        case VTK_UNSIGNED_SHORT:
+            return static_cast<const unsigned short*>(m_data)[id];
+        default:
+            return static_cast<int>(static_cast<const float*>(m_data)[id]);
+        }
+    }
+
+    /**
+     * @brief 写入一个标签（不同元素可在不同线程上同时写入）
+     */
+    void set(vtkIdType id, int label) const
+    {
+        switch (m_type) {
+        case VTK_UNSIGNED_CHAR:
+            static_cast<unsigned char*>(m_data)[id] = static_cast<unsigned char>(label);
+            break;
+        case VTK_UNSIGNED_SHORT:
+            static_cast<unsigned short*>(m_data)[id] = static_cast<unsigned short>(label);
+            break;
+        default:
+            static_cast<float*>(m_data)[id] = static_cast<float>(label);
+            break;
+        }
+    }
+
+private:
+    void* m_data;   ///< 数组数据（不支持的类型为空）
+    int m_type;     ///< VTK 数据类型
+};
+
+#endif // LABELARRAY_H
@@ -0,0 +1,240 @@
+/**
+ * @file labelcomponents.cpp
+ * @brief LabelComponents 连通分量分析的实现
+ */
+
+#include "labelcomponents.h"
+#include "meshadjacency.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+void LabelComponents::clear()
+{
+    m_parent.reset();
+    m_parentSize = 0;
+    std::vector<int>().swap(m_cellComponent);
+    std::vector<LabelComponent>().swap(m_components);
+}
+
+int LabelComponents::find(int cell) const
+{
+    // 路径减半：顺带把经过的节点指向祖父节点，并发时丢失的更新不影响正确性
+    int parent = m_parent[cell].load(std::memory_order_relaxed);
+    while (parent != cell) {
+        const int grandparent = m_parent[parent].load(std::memory_order_relaxed);
+        if (grandparent != parent) {
+            m_parent[cell].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        }
+        cell = grandparent;
+        parent = m_parent[cell].load(std::memory_order_relaxed);
+    }
+    return cell;
+}
+
+void LabelComponents::unite(int a, int b) const
+{
+    while (true) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return;
+        }
+        // 编号大的根挂到编号小的根下；失败说明 a 已不是根，重新查找
+        if (a < b) {
+            std::swap(a, b);
+        }
+        int expected = a;
+        if (m_parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void LabelComponents::compute(const MeshAdjacency& adjacency, const std::vector<int>& labels)
+{
+    const int cellCount = adjacency.cellCount();
+    m_components.clear();
+    m_cellComponent.resize(cellCount);
+    if (cellCount == 0 || static_cast<int>(labels.size()) < cellCount) {
+        m_cellComponent.clear();
+        return;
+    }
+
+    if (m_parentSize < cellCount) {
+        m_parent.reset(new std::atomic<int>[cellCount]);
+        m_parentSize = cellCount;
+    }
+
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [this](int64_t begin, int64_t end, int) {
+            for (int64_t cell = begin; cell < end; ++cell) {
+                m_parent[cell].store(static_cast<int>(cell), std::memory_order_relaxed);
+            }
+        });
+
+    // 每条共边只从编号小的一侧处理一次
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [this, &adjacency, &labels](int64_t begin, int64_t end, int) {
+            for (int cell = static_cast<int>(begin); cell < end; ++cell) {
+                const int label = labels[cell];
+                for (const int* it = adjacency.cellNeighborsBegin(cell);
+                     it != adjacency.cellNeighborsEnd(cell); ++it) {
+                    if (*it > cell && labels[*it] == label) {
+                        unite(cell, *it);
+                    }
+                }
+            }
+        });
+
+    // 所有线程结束后根已固定，并行求根
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [this](int64_t begin, int64_t end, int) {
+            for (int cell = static_cast<int>(begin); cell < end; ++cell) {
+                m_cellComponent[cell] = find(cell);
+            }
+        });
+
+    // 根是分量中编号最小的单元，按编号顺序遍历时根总是先出现
+    for (int cell = 0; cell < cellCount; ++cell) {
+        const int root = m_cellComponent[cell];
+        int component;
+        if (root == cell) {
+            component = static_cast<int>(m_components.size());
+            LabelComponent entry;
+            entry.label = labels[cell];
+            entry.firstCell = cell;
+            m_components.push_back(entry);
+        } else {
+            component = m_cellComponent[root];
+        }
+        m_cellComponent[cell] = component;
+        ++m_components[component].cellCount;
+    }
+}
+
+std::vector<LabelComponentSummary> LabelComponents::summaries(int minCells) const
+{
+    std::map<int, LabelComponentSummary> byLabel;
+    for (const LabelComponent& component : m_components) {
+        LabelComponentSummary& summary = byLabel[component.label];
+        if (summary.componentCount == 0) {
+            summary.label = component.label;
+            summary.smallest = component.cellCount;
+        }
+        ++summary.componentCount;
+        summary.largest = std::max(summary.largest, component.cellCount);
+        summary.smallest = std::min(summary.smallest, component.cellCount);
+        if (component.cellCount < minCells) {
+            ++summary.fragmentCount;
+            summary.fragmentCells += component.cellCount;
+        }
+    }
+
+    std::vector<LabelComponentSummary> result;
+    result.reserve(byLabel.size());
+    for (const auto& entry : byLabel) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+int LabelComponents::fragmentMerges(const MeshAdjacency& adjacency, int minCells,
+                                    std::vector<int>& cells, std::vector<int>& newLabels) const
+{
+    cells.clear();
+    newLabels.clear();
+    if (minCells <= 0 || m_components.empty()) {
+        return 0;
+    }
+
+    // 碎片的单元按分量分组（计数排序）
+    std::vector<int> fragmentIndex(m_components.size(), -1);
+    std::vector<int> offsets(1, 0);
+    for (size_t component = 0; component < m_components.size(); ++component) {
+        if (m_components[component].cellCount < minCells) {
+            fragmentIndex[component] = static_cast<int>(offsets.size()) - 1;
+            offsets.push_back(offsets.back() + m_components[component].cellCount);
+        }
+    }
+    const int fragmentCount = static_cast<int>(offsets.size()) - 1;
+    if (fragmentCount == 0) {
+        return 0;
+    }
+
+    std::vector<int> fragmentCells(offsets.back());
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (int cell = 0; cell < static_cast<int>(m_cellComponent.size()); ++cell) {
+        const int fragment = fragmentIndex[m_cellComponent[cell]];
+        if (fragment >= 0) {
+            fragmentCells[cursor[fragment]++] = cell;
+        }
+    }
+
+    // 统计每个碎片边界外的邻居标签，取共边最多的
+    int merged = 0;
+    std::vector<std::pair<int, int>> votes;  // (标签, 共边数)
+    for (int fragment = 0; fragment < fragmentCount; ++fragment) {
+        const int* begin = fragmentCells.data() + offsets[fragment];
+        const int* end = fragmentCells.data() + offsets[fragment + 1];
+        const int component = m_cellComponent[*begin];
+        const int label = m_components[component].label;
+
+        votes.clear();
+        for (const int* cell = begin; cell != end; ++cell) {
+            for (const int* it = adjacency.cellNeighborsBegin(*cell);
+                 it != adjacency.cellNeighborsEnd(*cell); ++it) {
+                const int neighborLabel = m_components[m_cellComponent[*it]].label;
+                if (neighborLabel == label) {
+                    continue;
+                }
+                auto vote = std::find_if(votes.begin(), votes.end(),
+                    [neighborLabel](const std::pair<int, int>& v) { return v.first == neighborLabel; });
+                if (vote == votes.end()) {
+                    votes.emplace_back(neighborLabel, 1);
+                } else {
+                    ++vote->second;
+                }
+            }
+        }
+        if (votes.empty()) {
+            continue;
+        }
+
+        std::pair<int, int> best = votes.front();
+        for (const auto& vote : votes) {
+            if (vote.second > best.second || (vote.second == best.second && vote.first < best.first)) {
+                best = vote;
+            }
+        }
+        for (const int* cell = begin; cell != end; ++cell) {
+            cells.push_back(*cell);
+            newLabels.push_back(best.first);
+        }
+        ++merged;
+    }
+    return merged;
+}
+
+QByteArray LabelComponents::toCsv(const std::vector<LabelComponentSummary>& summaries)
+{
+    QByteArray csv("label,components,largest,smallest,fragments,fragment_cells\n");
+    for (const LabelComponentSummary& summary : summaries) {
+        csv += QByteArray::number(summary.label) + ','
+            + QByteArray::number(summary.componentCount) + ','
+            + QByteArray::number(summary.largest) + ','
+            + QByteArray::number(summary.smallest) + ','
+            + QByteArray::number(summary.fragmentCount) + ','
+            + QByteArray::number(summary.fragmentCells) + '\n';
+    }
+    return csv;
+}
+
+size_t LabelComponents::memoryBytes() const
+{
+    return m_cellComponent.capacity() * sizeof(int)
+        + m_components.capacity() * sizeof(LabelComponent)
+        + static_cast<size_t>(m_parentSize) * sizeof(std::atomic<int>);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file labelcomponents.h
+ * @brief 标签区域的连通分量分析（孤岛、碎片检查与合并）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELCOMPONENTS_H
+#define LABELCOMPONENTS_H
+
+#include <QByteArray>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class MeshAdjacency;
+
+/**
+ * @brief 单个连通分量
+ */
+struct LabelComponent {
+    int label = 0;          ///< 标签值
+    int cellCount = 0;      ///< 单元数量
+    int firstCell = 0;      ///< 编号最小的单元（可作为填充、定位的种子）
+};
+
+/**
+ * @brief 单个标签的连通分量汇总
+ */
+struct LabelComponentSummary {
+    int label = 0;              ///< 标签值
+    int componentCount = 0;     ///< 连通分量数量
+    int largest = 0;            ///< 最大分量的单元数
+    int smallest = 0;           ///< 最小分量的单元数
+    int fragmentCount = 0;      ///< 小于阈值的分量数量
+    int fragmentCells = 0;      ///< 小于阈值的分量的单元总数
+};
+
+/**
+ * @brief 标签连通分量分析
+ *
+ * 相邻（共边）且标签相同的单元属于同一分量。用无锁并集查找并行合并：
+ * 每个线程处理一段单元，合并时总是把编号大的根挂到编号小的根下（CAS），
+ * 因此不会成环，且每个分量的根就是其中编号最小的单元；
+ * 最后按单元编号顺序一次遍历即可得到连续的分量编号。
+ */
+class LabelComponents {
+public:
+    /**
+     * @brief 计算连通分量
+     * @param adjacency 网格邻接关系（需包含共边单元）
+     * @param labels 每个单元的标签（长度为 adjacency.cellCount()）
+     */
+    void compute(const MeshAdjacency& adjacency, const std::vector<int>& labels);
+
+    /**
+     * @brief 清空结果
+     */
+    void clear();
+
+    /**
+     * @brief 所有连通分量（按 firstCell 递增）
+     */
+    const std::vector<LabelComponent>& components() const { return m_components; }
+
+    /**
+     * @brief 单元所属的分量编号
+     */
+    int componentOf(int cell) const { return m_cellComponent[cell]; }
+
+    /**
+     * @brief 按标签汇总（只包含有单元的标签，按标签值递增）
+     * @param minCells 碎片阈值：单元数小于该值的分量计为碎片（<= 0 不统计碎片）
+     */
+    std::vector<LabelComponentSummary> summaries(int minCells) const;
+
+    /**
+     * @brief 计算把碎片合并到周围标签需要的修改
+     *
+     * 每个碎片改为与它共边最多的其它标签（并列时取较小的标签），
+     * 没有其它标签邻居的碎片（独立的壳体）保持不变。
+     *
+     * @param adjacency 网格邻接关系（与 compute() 相同）
+     * @param minCells 碎片阈值（单元数小于该值）
+     * @param cells 输出需要修改的单元
+     * @param newLabels 输出对应的新标签
+     * @return 被合并的碎片数量
+     */
+    int fragmentMerges(const MeshAdjacency& adjacency, int minCells,
+                       std::vector<int>& cells, std::vector<int>& newLabels) const;
+
+    /**
+     * @brief 生成 CSV 文本
+     */
+    static QByteArray toCsv(const std::vector<LabelComponentSummary>& summaries);
+
+    /**
+     * @brief 分析结果和缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    /**
+     * @brief 查找根（路径减半）
+     */
+    int find(int cell) const;
+
+    /**
+     * @brief 合并两个单元所在的集合
+     */
+    void unite(int a, int b) const;
+
+    std::unique_ptr<std::atomic<int>[]> m_parent;  ///< 并集查找的父节点（计算期间使用）
+    int m_parentSize = 0;                          ///< m_parent 的容量
+    std::vector<int> m_cellComponent;              ///< 单元 -> 分量编号
+    std::vector<LabelComponent> m_components;      ///< 连通分量
+};
+
+#endif // LABELCOMPONENTS_H
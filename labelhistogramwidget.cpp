@@ -0,0 +1,156 @@
+/**
+ * @file labelhistogramwidget.cpp
+ * @brief LabelHistogramWidget 标签直方图控件的实现
+ */
+
+#include "labelhistogramwidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+#include <algorithm>
+
+LabelHistogramWidget::LabelHistogramWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_totalCells(0)
+    , m_totalArea(0.0)
+    , m_currentLabel(-1)
+{
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Minimum);
+    updateRows();
+}
+
+void LabelHistogramWidget::setLabelColors(const std::vector<QColor>& colors)
+{
+    m_colors = colors;
+    update();
+}
+
+void LabelHistogramWidget::setStatistics(const std::vector<int>& cellCounts,
+                                         const std::vector<double>& areas,
+                                         int totalCells, double totalArea)
+{
+    m_cellCounts = cellCounts;
+    m_areas = areas;
+    m_totalCells = totalCells;
+    m_totalArea = totalArea;
+    updateRows();
+    update();
+}
+
+void LabelHistogramWidget::setCurrentLabel(int label)
+{
+    if (m_currentLabel != label) {
+        m_currentLabel = label;
+        updateRows();
+        update();
+    }
+}
+
+void LabelHistogramWidget::setLabelMasks(const LabelMask& locked, const LabelMask& hidden)
+{
+    m_lockedLabels = locked;
+    m_hiddenLabels = hidden;
+    updateRows();
+    update();
+}
+
+void LabelHistogramWidget::updateRows()
+{
+    std::vector<int> rows;
+    const int labelCount = static_cast<int>(m_cellCounts.size());
+    for (int label = 0; label < std::max(labelCount, FIXED_ROWS); ++label) {
+        if (label < FIXED_ROWS || label == m_currentLabel || m_cellCounts[label] > 0) {
+            rows.push_back(label);
+        }
+    }
+    if (m_currentLabel >= std::max(labelCount, FIXED_ROWS)) {
+        rows.push_back(m_currentLabel);
+    }
+    // 锁定/隐藏的空标签也显示，便于确认状态
+    for (const LabelMask* mask : { &m_lockedLabels, &m_hiddenLabels }) {
+        for (int label : mask->labels()) {
+            if (label >= FIXED_ROWS) {
+                rows.push_back(label);
+            }
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    if (rows.size() != m_rows.size()) {
+        m_rows.swap(rows);
+        updateGeometry();
+    } else {
+        m_rows.swap(rows);
+    }
+}
+
+QSize LabelHistogramWidget::sizeHint() const
+{
+    const int rows = static_cast<int>(m_rows.size());
+    return QSize(260, 2 * MARGIN + std::max(rows, 1) * ROW_HEIGHT);
+}
+
+void LabelHistogramWidget::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    const QFontMetrics metrics = painter.fontMetrics();
+    const int digits = m_rows.empty() ? 2 : std::max(2, QString::number(m_rows.back()).size());
+    const QString lockMark = tr(" 锁");
+    const int labelWidth = metrics.boundingRect(QString(digits, QLatin1Char('0'))
+                                                + (m_lockedLabels.any() ? lockMark : QString())).width() + MARGIN;
+    const int textWidth = metrics.boundingRect("0000000 (100.0%)").width() + MARGIN;
+    const int swatchSize = ROW_HEIGHT - 2 * MARGIN;
+    const int barLeft = MARGIN + swatchSize + MARGIN + labelWidth;
+    const int barWidth = std::max(width() - barLeft - textWidth - MARGIN, 10);
+
+    for (size_t row = 0; row < m_rows.size(); ++row) {
+        const size_t label = static_cast<size_t>(m_rows[row]);
+        const int top = MARGIN + static_cast<int>(row) * ROW_HEIGHT;
+        const QColor color = label < m_colors.size() ? m_colors[label] : QColor(Qt::gray);
+        const int cellCount = label < m_cellCounts.size() ? m_cellCounts[label] : 0;
+
+        if (static_cast<int>(label) == m_currentLabel) {
+            painter.fillRect(QRect(0, top, width(), ROW_HEIGHT),
+                             palette().highlight().color().lighter(170));
+        }
+
+        // 颜色块和标签号（隐藏的标签只画边框，锁定的标签加标记）
+        const bool hidden = m_hiddenLabels.test(static_cast<int>(label));
+        if (!hidden) {
+            painter.fillRect(QRect(MARGIN, top + MARGIN, swatchSize, swatchSize), color);
+        }
+        painter.setPen(hidden ? palette().color(QPalette::Disabled, QPalette::Text)
+                              : palette().text().color());
+        painter.drawRect(QRect(MARGIN, top + MARGIN, swatchSize, swatchSize));
+        QString labelText = QString::number(label);
+        if (m_lockedLabels.test(static_cast<int>(label))) {
+            labelText += lockMark;
+        }
+        painter.drawText(QRect(MARGIN + swatchSize + MARGIN, top, labelWidth, ROW_HEIGHT),
+                         Qt::AlignVCenter | Qt::AlignLeft, labelText);
+
+        // 单元数量占比（粗条）和表面积占比（细条）
+        const double cellFraction = m_totalCells > 0
+            ? static_cast<double>(cellCount) / m_totalCells : 0.0;
+        const double areaFraction = (m_totalArea > 0.0 && label < m_areas.size())
+            ? m_areas[label] / m_totalArea : 0.0;
+        const int barHeight = ROW_HEIGHT - 2 * MARGIN;
+        painter.fillRect(QRect(barLeft, top + MARGIN,
+                               static_cast<int>(cellFraction * barWidth), barHeight - 3),
+                         color.darker(110));
+        painter.fillRect(QRect(barLeft, top + MARGIN + barHeight - 2,
+                               static_cast<int>(areaFraction * barWidth), 2),
+                         palette().text().color());
+
+        painter.drawText(QRect(barLeft + barWidth + MARGIN, top, textWidth, ROW_HEIGHT),
+                         Qt::AlignVCenter | Qt::AlignRight,
+                         QString("%1 (%2%)").arg(cellCount)
+                             .arg(areaFraction * 100.0, 0, 'f', 1));
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file labelhistogramwidget.h
+ * @brief 每个标签的单元数量/表面积直方图控件
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELHISTOGRAMWIDGET_H
+#define LABELHISTOGRAMWIDGET_H
+
+#include <QWidget>
+#include <QColor>
+
+#include <vector>
+
+#include "labelmask.h"
+
+/**
+ * @brief 标签直方图控件
+ *
+ * 每行一个标签：颜色块、标签号、单元数量占比（粗条）和表面积占比（细条）。
+ * 数据来自增量维护的 LabelStatistics，刷新只复制每个标签的两个数值，与网格规模无关。
+ * 前 FIXED_ROWS 个标签、当前标签和锁定/隐藏的标签总是显示，更大的标签只显示有单元的，
+ * 标签容量很大时行数仍与实际用到的标签数相当。锁定的标签在标签号后标“锁”，
+ * 隐藏的标签只画颜色块的边框、文字变灰。
+ */
+class LabelHistogramWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit LabelHistogramWidget(QWidget* parent = nullptr);
+
+    /**
+     * @brief 设置每个标签的颜色
+     */
+    void setLabelColors(const std::vector<QColor>& colors);
+
+    /**
+     * @brief 设置统计数据
+     * @param cellCounts 每个标签的单元数量
+     * @param areas 每个标签的表面积
+     * @param totalCells 单元总数
+     * @param totalArea 总表面积
+     */
+    void setStatistics(const std::vector<int>& cellCounts, const std::vector<double>& areas,
+                       int totalCells, double totalArea);
+
+    /**
+     * @brief 设置当前标签（高亮显示）
+     */
+    void setCurrentLabel(int label);
+
+    /**
+     * @brief 设置锁定和隐藏的标签
+     */
+    void setLabelMasks(const LabelMask& locked, const LabelMask& hidden);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    static constexpr int ROW_HEIGHT = 20;      ///< 每行高度（像素）
+    static constexpr int MARGIN = 4;           ///< 边距（像素）
+    static constexpr int FIXED_ROWS = 20;      ///< 总是显示的标签数
+
+    /**
+     * @brief 重新确定要显示的标签行
+     */
+    void updateRows();
+
+    std::vector<QColor> m_colors;              ///< 标签颜色
+    std::vector<int> m_cellCounts;             ///< 每个标签的单元数量
+    std::vector<double> m_areas;               ///< 每个标签的表面积
+    int m_totalCells;                          ///< 单元总数
+    double m_totalArea;                        ///< 总表面积
+    int m_currentLabel;                        ///< 当前标签
+    std::vector<int> m_rows;                   ///< 要显示的标签（升序）
+    LabelMask m_lockedLabels;                  ///< 锁定的标签
+    LabelMask m_hiddenLabels;                  ///< 隐藏的标签
+};
+
+#endif // LABELHISTOGRAMWIDGET_H
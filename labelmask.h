@@ -0,0 +1,126 @@
+/**
+ * @file labelmask.h
+ * @brief 标签位掩码（锁定、隐藏的标签集合）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELMASK_H
+#define LABELMASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 标签集合的位掩码
+ *
+ * 每个标签一位，按需增长到集合中最大的标签。test() 只有一次移位和一次与运算，
+ * 不分配内存，可在画刷 BFS 等内层循环和多个线程上同时调用（调用期间不能修改）。
+ */
+class LabelMask {
+public:
+    /**
+     * @brief 标签是否在集合中（负数和超出范围的标签不在）
+     */
+    bool test(int label) const
+    {
+        const size_t word = static_cast<unsigned int>(label) >> 6;
+        return word < m_words.size() && ((m_words[word] >> (label & 63)) & 1u) != 0;
+    }
+
+    /**
+     * @brief 加入或移除一个标签
+     * @return 集合改变时返回true
+     */
+    bool set(int label, bool on)
+    {
+        if (label < 0 || test(label) == on) {
+            return false;
+        }
+        const size_t word = static_cast<size_t>(label) >> 6;
+        if (word >= m_words.size()) {
+            m_words.resize(word + 1, 0);
+        }
+        m_words[word] ^= uint64_t(1) << (label & 63);
+        m_count += on ? 1 : -1;
+        if (!on) {
+            // 去掉末尾的空字，相同的集合总有相同的表示
+            while (!m_words.empty() && m_words.back() == 0) {
+                m_words.pop_back();
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 集合是否非空
+     */
+    bool any() const { return m_count > 0; }
+
+    /**
+     * @brief 集合中的标签数
+     */
+    int count() const { return m_count; }
+
+    /**
+     * @brief 集合中的标签（升序）
+     */
+    std::vector<int> labels() const
+    {
+        std::vector<int> result;
+        result.reserve(m_count);
+        for (size_t word = 0; word < m_words.size(); ++word) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if ((m_words[word] >> bit) & 1u) {
+                    result.push_back(static_cast<int>(word * 64 + bit));
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief 两个集合的并集
+     */
+    LabelMask united(const LabelMask& other) const
+    {
+        LabelMask result = m_words.size() >= other.m_words.size() ? *this : other;
+        const LabelMask& smaller = m_words.size() >= other.m_words.size() ? other : *this;
+        result.m_count = 0;
+        for (size_t word = 0; word < result.m_words.size(); ++word) {
+            if (word < smaller.m_words.size()) {
+                result.m_words[word] |= smaller.m_words[word];
+            }
+            result.m_count += popcount(result.m_words[word]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief 清空集合
+     */
+    void clear()
+    {
+        m_words.clear();
+        m_count = 0;
+    }
+
+    bool operator==(const LabelMask& other) const { return m_words == other.m_words; }
+    bool operator!=(const LabelMask& other) const { return m_words != other.m_words; }
+
+private:
+    static int popcount(uint64_t bits)
+    {
+        int count = 0;
+        for (; bits != 0; bits &= bits - 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<uint64_t> m_words;   ///< 每个字 64 个标签
+    int m_count = 0;                 ///< 集合中的标签数
+};
+
+#endif // LABELMASK_H
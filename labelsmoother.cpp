@@ -0,0 +1,196 @@
+/**
+ * @file labelsmoother.cpp
+ * @brief LabelSmoother 标签边界平滑的实现
+ */
+
+#include "labelsmoother.h"
+#include "meshadjacency.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+
+uint32_t LabelSmoother::advance(std::vector<uint32_t>& stamps, uint32_t& generation,
+                                int cellCount)
+{
+    if (static_cast<int>(stamps.size()) != cellCount) {
+        stamps.assign(cellCount, 0);
+        generation = 0;
+    }
+    if (++generation == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+    return generation;
+}
+
+int LabelSmoother::vote(const MeshAdjacency& adjacency, const std::vector<int>& labels, int cell)
+{
+    const int* begin = adjacency.cellNeighborsBegin(cell);
+    const int* end = adjacency.cellNeighborsEnd(cell);
+    const int neighborCount = static_cast<int>(end - begin);
+
+    // 邻居通常只有3个，逐个计数即可
+    for (const int* it = begin; it != end; ++it) {
+        const int label = labels[*it];
+        if (label == labels[cell]) {
+            continue;
+        }
+        int count = 0;
+        for (const int* other = begin; other != end; ++other) {
+            count += labels[*other] == label ? 1 : 0;
+        }
+        if (2 * count > neighborCount) {
+            return label;
+        }
+    }
+    return labels[cell];
+}
+
+int LabelSmoother::smooth(const MeshAdjacency& adjacency, std::vector<int>& labels,
+                          int iterations, int bandRings, std::vector<int>& changedCells)
+{
+    changedCells.clear();
+    const int cellCount = adjacency.cellCount();
+    if (cellCount == 0 || static_cast<int>(labels.size()) < cellCount || iterations <= 0) {
+        return 0;
+    }
+
+    // 边界单元：有标签不同的共边邻居（并行扫描，按块收集后拼接）
+    const int chunks = ParallelUtils::chunkCount(0, cellCount);
+    std::vector<std::vector<int>> boundary(chunks);
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&adjacency, &labels, &boundary](int64_t begin, int64_t end, int chunk) {
+            for (int cell = static_cast<int>(begin); cell < end; ++cell) {
+                for (const int* it = adjacency.cellNeighborsBegin(cell);
+                     it != adjacency.cellNeighborsEnd(cell); ++it) {
+                    if (labels[*it] != labels[cell]) {
+                        boundary[chunk].push_back(cell);
+                        break;
+                    }
+                }
+            }
+        });
+
+    // 带：边界单元向外扩展 bandRings 圈
+    const uint32_t band = advance(m_bandStamp, m_bandGeneration, cellCount);
+    m_band.clear();
+    for (const std::vector<int>& cells : boundary) {
+        for (int cell : cells) {
+            m_bandStamp[cell] = band;
+            m_band.push_back(cell);
+        }
+    }
+    size_t ringBegin = 0;
+    for (int ring = 0; ring < bandRings; ++ring) {
+        const size_t ringEnd = m_band.size();
+        for (size_t i = ringBegin; i < ringEnd; ++i) {
+            const int cell = m_band[i];
+            for (const int* it = adjacency.cellNeighborsBegin(cell);
+                 it != adjacency.cellNeighborsEnd(cell); ++it) {
+                if (m_bandStamp[*it] != band) {
+                    m_bandStamp[*it] = band;
+                    m_band.push_back(*it);
+                }
+            }
+        }
+        ringBegin = ringEnd;
+    }
+    if (m_band.empty()) {
+        return 0;
+    }
+
+    m_originalLabels.resize(cellCount);
+    for (int cell : m_band) {
+        m_originalLabels[cell] = labels[cell];
+    }
+
+    m_active = m_band;
+    int iteration = 0;
+    std::vector<int> changed;
+    std::vector<int> changedLabels;
+    std::vector<int> deferred;
+    while (iteration < iterations && !m_active.empty()) {
+        ++iteration;
+
+        // 先并行表决，再统一写入
+        m_proposed.resize(m_active.size());
+        ParallelUtils::forChunks(0, static_cast<int64_t>(m_active.size()),
+                                 ParallelUtils::DEFAULT_MIN_CHUNK,
+            [this, &adjacency, &labels](int64_t begin, int64_t end, int) {
+                for (int64_t i = begin; i < end; ++i) {
+                    m_proposed[i] = vote(adjacency, labels, m_active[i]);
+                }
+            });
+
+        // 相邻的两个单元同时改变可能互换标签、来回振荡：
+        // 只有没有编号更小的邻居同时提议改变的单元才写入，其余的留到下一轮重新表决
+        const uint32_t proposing = advance(m_proposingStamp, m_proposingGeneration, cellCount);
+        for (size_t i = 0; i < m_active.size(); ++i) {
+            if (m_proposed[i] != labels[m_active[i]]) {
+                m_proposingStamp[m_active[i]] = proposing;
+            }
+        }
+        changed.clear();
+        changedLabels.clear();
+        deferred.clear();
+        for (size_t i = 0; i < m_active.size(); ++i) {
+            const int cell = m_active[i];
+            if (m_proposingStamp[cell] != proposing) {
+                continue;
+            }
+            bool blocked = false;
+            for (const int* it = adjacency.cellNeighborsBegin(cell);
+                 it != adjacency.cellNeighborsEnd(cell); ++it) {
+                if (*it < cell && m_proposingStamp[*it] == proposing) {
+                    blocked = true;
+                    break;
+                }
+            }
+            if (blocked) {
+                deferred.push_back(cell);
+            } else {
+                changed.push_back(cell);
+                changedLabels.push_back(m_proposed[i]);
+            }
+        }
+        for (size_t i = 0; i < changed.size(); ++i) {
+            labels[changed[i]] = changedLabels[i];
+        }
+
+        // 下一轮只表决改变的单元、其带内邻居和被推迟的单元
+        const uint32_t active = advance(m_activeStamp, m_activeGeneration, cellCount);
+        m_active.clear();
+        for (int cell : deferred) {
+            m_activeStamp[cell] = active;
+            m_active.push_back(cell);
+        }
+        for (int cell : changed) {
+            if (m_activeStamp[cell] != active) {
+                m_activeStamp[cell] = active;
+                m_active.push_back(cell);
+            }
+            for (const int* it = adjacency.cellNeighborsBegin(cell);
+                 it != adjacency.cellNeighborsEnd(cell); ++it) {
+                if (m_bandStamp[*it] == band && m_activeStamp[*it] != active) {
+                    m_activeStamp[*it] = active;
+                    m_active.push_back(*it);
+                }
+            }
+        }
+    }
+
+    for (int cell : m_band) {
+        if (labels[cell] != m_originalLabels[cell]) {
+            changedCells.push_back(cell);
+        }
+    }
+    return iteration;
+}
+
+size_t LabelSmoother::memoryBytes() const
+{
+    return (m_bandStamp.capacity() + m_activeStamp.capacity() + m_proposingStamp.capacity())
+            * sizeof(uint32_t)
+        + (m_originalLabels.capacity() + m_band.capacity() + m_active.capacity()
+           + m_proposed.capacity()) * sizeof(int);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file labelsmoother.h
+ * @brief 标签边界平滑（去除沿三角形边的锯齿）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELSMOOTHER_H
+#define LABELSMOOTHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MeshAdjacency;
+
+/**
+ * @brief 标签边界平滑
+ *
+ * 多数表决：共边邻居中过半数属于另一个标签的单元改为该标签，
+ * 这正是画刷沿三角形边留下的锯齿。只在初始边界附近若干圈的带内修改，
+ * 每轮只重新表决上一轮改变的单元及其邻居；同一轮内先并行表决再统一写入（Jacobi 迭代），
+ * 结果与线程数无关。缓冲区在多次调用间复用。
+ */
+class LabelSmoother {
+public:
+    static constexpr int DEFAULT_ITERATIONS = 5;    ///< 默认迭代轮数
+    static constexpr int DEFAULT_BAND_RINGS = 2;    ///< 默认带宽（边界外扩的圈数）
+
+    /**
+     * @brief 平滑标签边界
+     * @param adjacency 网格邻接关系（需包含共边单元）
+     * @param labels 每个单元的标签，原地修改
+     * @param iterations 最大迭代轮数（没有单元改变时提前结束）
+     * @param bandRings 可修改的带宽：边界单元向外扩展的圈数（0 表示只改边界单元）
+     * @param changedCells 输出最终标签与原标签不同的单元
+     * @return 实际执行的轮数
+     */
+    int smooth(const MeshAdjacency& adjacency, std::vector<int>& labels,
+               int iterations, int bandRings, std::vector<int>& changedCells);
+
+    /**
+     * @brief 缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    /**
+     * @brief 推进标记数组的代号（必要时扩容；回绕时清零）
+     * @return 新代号
+     */
+    static uint32_t advance(std::vector<uint32_t>& stamps, uint32_t& generation, int cellCount);
+
+    /**
+     * @brief 表决单元的新标签（不改变时返回原标签）
+     */
+    static int vote(const MeshAdjacency& adjacency, const std::vector<int>& labels, int cell);
+
+    std::vector<uint32_t> m_bandStamp;     ///< 带内标记
+    std::vector<uint32_t> m_activeStamp;   ///< 本轮待表决标记
+    std::vector<uint32_t> m_proposingStamp; ///< 本轮提议改变标记
+    std::vector<int> m_originalLabels;     ///< 带内单元的原标签
+    std::vector<int> m_band;               ///< 带内单元
+    std::vector<int> m_active;             ///< 本轮待表决单元
+    std::vector<int> m_proposed;           ///< 本轮表决结果（与 m_active 对应）
+    uint32_t m_bandGeneration = 0;         ///< 带内标记的当前代号
+    uint32_t m_activeGeneration = 0;       ///< 待表决标记的当前代号
+    uint32_t m_proposingGeneration = 0;    ///< 提议改变标记的当前代号
+};
+
+#endif // LABELSMOOTHER_H
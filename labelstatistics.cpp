@@ -0,0 +1,542 @@
+/**
+ * @file labelstatistics.cpp
+ * @brief LabelStatistics 标签统计的实现
+ */
+
+#include "labelstatistics.h"
+#include "labelarray.h"
+#include "parallelutils.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+namespace {
+
+/**
+ * @brief 单个单元的几何量
+ */
+struct CellGeometry {
+    double area;
+    double centroid[3];
+    double bounds[6];
+};
+
+/**
+ * @brief 计算多边形单元的面积（扇形三角化）、顶点平均质心和包围盒
+ */
+void computeCellGeometry(vtkPoints* points, vtkIdType npts, const vtkIdType* pts,
+                         CellGeometry& geometry)
+{
+    double p0[3], prev[3], p[3];
+    points->GetPoint(pts[0], p0);
+    double normal[3] = { 0.0, 0.0, 0.0 };
+
+    for (int k = 0; k < 3; ++k) {
+        geometry.centroid[k] = p0[k];
+        geometry.bounds[2 * k] = p0[k];
+        geometry.bounds[2 * k + 1] = p0[k];
+        prev[k] = p0[k];
+    }
+
+    for (vtkIdType i = 1; i < npts; ++i) {
+        points->GetPoint(pts[i], p);
+        for (int k = 0; k < 3; ++k) {
+            geometry.centroid[k] += p[k];
+            geometry.bounds[2 * k] = std::min(geometry.bounds[2 * k], p[k]);
+            geometry.bounds[2 * k + 1] = std::max(geometry.bounds[2 * k + 1], p[k]);
+        }
+        if (i >= 2) {
+            // 面积 = |Σ (p_{i-1} - p_0) × (p_i - p_0)| / 2
+            const double u[3] = { prev[0] - p0[0], prev[1] - p0[1], prev[2] - p0[2] };
+            const double v[3] = { p[0] - p0[0], p[1] - p0[1], p[2] - p0[2] };
+            normal[0] += u[1] * v[2] - u[2] * v[1];
+            normal[1] += u[2] * v[0] - u[0] * v[2];
+            normal[2] += u[0] * v[1] - u[1] * v[0];
+        }
+        prev[0] = p[0];
+        prev[1] = p[1];
+        prev[2] = p[2];
+    }
+
+    for (int k = 0; k < 3; ++k) {
+        geometry.centroid[k] /= static_cast<double>(npts);
+    }
+    geometry.area = 0.5 * std::sqrt(normal[0] * normal[0]
+                                    + normal[1] * normal[1]
+                                    + normal[2] * normal[2]);
+}
+
+void expandBounds(double* bounds, const double* cellBounds)
+{
+    for (int k = 0; k < 3; ++k) {
+        bounds[2 * k] = std::min(bounds[2 * k], cellBounds[2 * k]);
+        bounds[2 * k + 1] = std::max(bounds[2 * k + 1], cellBounds[2 * k + 1]);
+    }
+}
+
+void resetBounds(double* bounds)
+{
+    for (int k = 0; k < 3; ++k) {
+        bounds[2 * k] = std::numeric_limits<double>::max();
+        bounds[2 * k + 1] = -std::numeric_limits<double>::max();
+    }
+}
+
+} // namespace
+
+// ==================== Totals ====================
+
+void LabelStatistics::Totals::reset(int labelCount)
+{
+    counts.assign(labelCount, 0);
+    areas.assign(labelCount, 0.0);
+    centroidSums.assign(3 * static_cast<size_t>(labelCount), 0.0);
+    bounds.resize(6 * static_cast<size_t>(labelCount));
+    for (int label = 0; label < labelCount; ++label) {
+        resetBounds(&bounds[6 * label]);
+    }
+}
+
+void LabelStatistics::Totals::grow(int labelCount)
+{
+    const int oldCount = static_cast<int>(counts.size());
+    if (labelCount <= oldCount) {
+        return;
+    }
+    counts.resize(labelCount, 0);
+    areas.resize(labelCount, 0.0);
+    centroidSums.resize(3 * static_cast<size_t>(labelCount), 0.0);
+    bounds.resize(6 * static_cast<size_t>(labelCount));
+    for (int label = oldCount; label < labelCount; ++label) {
+        resetBounds(&bounds[6 * label]);
+    }
+}
+
+void LabelStatistics::Totals::merge(const Totals& other)
+{
+    grow(static_cast<int>(other.counts.size()));
+    for (size_t label = 0; label < other.counts.size(); ++label) {
+        counts[label] += other.counts[label];
+        areas[label] += other.areas[label];
+        for (int k = 0; k < 3; ++k) {
+            centroidSums[3 * label + k] += other.centroidSums[3 * label + k];
+        }
+        expandBounds(&bounds[6 * label], &other.bounds[6 * label]);
+    }
+}
+
+// ==================== LabelStatistics ====================
+
+void LabelStatistics::clear()
+{
+    m_polyData = nullptr;
+    m_polyOffset = 0;
+    m_polyCount = 0;
+    m_labelLimit = 0;
+    m_totals.reset(0);
+    m_boundsDirty.clear();
+    m_totalArea = 0.0;
+    markAllChanged();
+}
+
+void LabelStatistics::recompute(vtkPolyData* polyData, int labelLimit)
+{
+    clear();
+    if (!polyData || labelLimit <= 0) {
+        return;
+    }
+
+    m_polyData = polyData;
+    // 单元编号依次为 verts、lines、polys、strips，只有多边形参与几何统计
+    m_polyOffset = polyData->GetNumberOfVerts() + polyData->GetNumberOfLines();
+    m_polyCount = polyData->GetNumberOfPolys();
+    m_labelLimit = labelLimit;
+    recount();
+}
+
+void LabelStatistics::recount()
+{
+    if (!m_polyData || m_labelLimit <= 0) {
+        return;
+    }
+
+    m_totalArea = reduce(m_totals);
+    m_boundsDirty.assign(m_totals.counts.size(), 0);
+    markAllChanged();
+}
+
+double LabelStatistics::reduce(Totals& totals) const
+{
+    const int labelLimit = m_labelLimit;
+    totals.reset(0);
+
+    vtkDataArray* scalars = m_polyData->GetCellData()->GetScalars();
+    vtkCellArray* polys = m_polyData->GetPolys();
+    vtkPoints* points = m_polyData->GetPoints();
+    if (!scalars || !polys || !points) {
+        return 0.0;
+    }
+
+    const vtkIdType cellCount = std::min(scalars->GetNumberOfTuples(),
+                                         m_polyData->GetNumberOfCells());
+
+    // 8/16 位或 float 标签直接读数组；其它类型逐个读取，只在单线程上进行
+    const LabelView labels(scalars);
+    const int64_t minChunk = labels.isValid() ? ParallelUtils::DEFAULT_MIN_CHUNK
+                                              : std::max<int64_t>(cellCount, 1);
+
+    const int chunks = ParallelUtils::chunkCount(0, cellCount, minChunk);
+    std::vector<Totals> partials(chunks);
+    std::vector<double> partialAreas(chunks, 0.0);
+
+    ParallelUtils::forChunks(0, cellCount, minChunk,
+        [&](int64_t begin, int64_t end, int chunk) {
+            // 每个线程使用独立的迭代器（vtkCellArray 的随机访问不是线程安全的）
+            vtkSmartPointer<vtkCellArrayIterator> iter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            // 每块的数组只扩展到本块出现过的最大标签
+            Totals& local = partials[chunk];
+            local.reset(0);
+            double total = 0.0;
+            CellGeometry geometry;
+
+            for (vtkIdType cellId = begin; cellId < end; ++cellId) {
+                const int label = labels.isValid()
+                    ? labels.get(cellId) : static_cast<int>(scalars->GetComponent(cellId, 0));
+                const vtkIdType polyId = cellId - m_polyOffset;
+                const bool isPoly = polyId >= 0 && polyId < m_polyCount;
+                const bool tracked = static_cast<unsigned>(label) < static_cast<unsigned>(labelLimit);
+                if (tracked && label >= static_cast<int>(local.counts.size())) {
+                    local.grow(label + 1);
+                }
+                if (!isPoly) {
+                    if (tracked) {
+                        ++local.counts[label];
+                    }
+                    continue;
+                }
+
+                vtkIdType npts;
+                const vtkIdType* pts;
+                iter->GetCellAtId(polyId, npts, pts);
+                if (npts < 3) {
+                    if (tracked) {
+                        ++local.counts[label];
+                    }
+                    continue;
+                }
+
+                computeCellGeometry(points, npts, pts, geometry);
+                total += geometry.area;
+                if (tracked) {
+                    ++local.counts[label];
+                    local.areas[label] += geometry.area;
+                    for (int k = 0; k < 3; ++k) {
+                        local.centroidSums[3 * label + k] += geometry.area * geometry.centroid[k];
+                    }
+                    expandBounds(&local.bounds[6 * label], geometry.bounds);
+                }
+            }
+            partialAreas[chunk] = total;
+        });
+
+    double totalArea = 0.0;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        totals.merge(partials[chunk]);
+        totalArea += partialAreas[chunk];
+    }
+    return totalArea;
+}
+
+void LabelStatistics::moveCell(vtkIdType cellId, int fromLabel, int toLabel)
+{
+    if (fromLabel == toLabel || !m_polyData) {
+        return;
+    }
+    const int changedId = static_cast<int>(cellId);
+    logChanges(&changedId, 1);
+
+    CellGeometry geometry;
+    bool hasGeometry = false;
+    const vtkIdType polyId = cellId - m_polyOffset;
+    if (polyId >= 0 && polyId < m_polyCount) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        m_polyData->GetPolys()->GetCellAtId(polyId, npts, pts);
+        if (npts >= 3) {
+            computeCellGeometry(m_polyData->GetPoints(), npts, pts, geometry);
+            hasGeometry = true;
+        }
+    }
+
+    if (isStored(fromLabel)) {
+        --m_totals.counts[fromLabel];
+        if (hasGeometry) {
+            m_totals.areas[fromLabel] -= geometry.area;
+            for (int k = 0; k < 3; ++k) {
+                m_totals.centroidSums[3 * fromLabel + k] -= geometry.area * geometry.centroid[k];
+            }
+            // 包围盒无法按增量缩小
+            m_boundsDirty[fromLabel] = 1;
+        }
+    }
+
+    if (isTracked(toLabel)) {
+        ensureLabel(toLabel);
+        ++m_totals.counts[toLabel];
+        if (hasGeometry) {
+            m_totals.areas[toLabel] += geometry.area;
+            for (int k = 0; k < 3; ++k) {
+                m_totals.centroidSums[3 * toLabel + k] += geometry.area * geometry.centroid[k];
+            }
+            expandBounds(&m_totals.bounds[6 * toLabel], geometry.bounds);
+        }
+    }
+}
+
+void LabelStatistics::moveCells(const std::vector<int>& cellIds, int fromLabel, int toLabel)
+{
+    if (fromLabel == toLabel || !m_polyData || cellIds.empty()) {
+        return;
+    }
+    logChanges(cellIds.data(), cellIds.size());
+
+    vtkCellArray* polys = m_polyData->GetPolys();
+    vtkPoints* points = m_polyData->GetPoints();
+    const int64_t count = static_cast<int64_t>(cellIds.size());
+
+    // 每块累加面积、面积加权质心和包围盒，最后合并为一次更新
+    struct Partial {
+        double area = 0.0;
+        double centroidSum[3] = { 0.0, 0.0, 0.0 };
+        double bounds[6];
+    };
+    std::vector<Partial> partials(ParallelUtils::chunkCount(0, count, ParallelUtils::DEFAULT_MIN_CHUNK));
+
+    ParallelUtils::forChunks(0, count, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int chunk) {
+            Partial& local = partials[chunk];
+            resetBounds(local.bounds);
+            if (!polys || !points) {
+                return;
+            }
+            vtkSmartPointer<vtkCellArrayIterator> iter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            CellGeometry geometry;
+            for (int64_t i = begin; i < end; ++i) {
+                const vtkIdType polyId = cellIds[i] - m_polyOffset;
+                if (polyId < 0 || polyId >= m_polyCount) {
+                    continue;
+                }
+                vtkIdType npts;
+                const vtkIdType* pts;
+                iter->GetCellAtId(polyId, npts, pts);
+                if (npts < 3) {
+                    continue;
+                }
+                computeCellGeometry(points, npts, pts, geometry);
+                local.area += geometry.area;
+                for (int k = 0; k < 3; ++k) {
+                    local.centroidSum[k] += geometry.area * geometry.centroid[k];
+                }
+                expandBounds(local.bounds, geometry.bounds);
+            }
+        });
+
+    Partial moved;
+    resetBounds(moved.bounds);
+    for (const Partial& partial : partials) {
+        moved.area += partial.area;
+        for (int k = 0; k < 3; ++k) {
+            moved.centroidSum[k] += partial.centroidSum[k];
+        }
+        expandBounds(moved.bounds, partial.bounds);
+    }
+
+    if (isStored(fromLabel)) {
+        m_totals.counts[fromLabel] -= static_cast<int>(count);
+        m_totals.areas[fromLabel] -= moved.area;
+        for (int k = 0; k < 3; ++k) {
+            m_totals.centroidSums[3 * fromLabel + k] -= moved.centroidSum[k];
+        }
+        m_boundsDirty[fromLabel] = 1;
+    }
+
+    if (isTracked(toLabel)) {
+        ensureLabel(toLabel);
+        m_totals.counts[toLabel] += static_cast<int>(count);
+        m_totals.areas[toLabel] += moved.area;
+        for (int k = 0; k < 3; ++k) {
+            m_totals.centroidSums[3 * toLabel + k] += moved.centroidSum[k];
+        }
+        expandBounds(&m_totals.bounds[6 * toLabel], moved.bounds);
+    }
+}
+
+void LabelStatistics::setChangeLogEnabled(bool enabled)
+{
+    m_changeLogEnabled = enabled;
+    m_changedCells.clear();
+    m_changedCells.shrink_to_fit();
+    m_allChanged = enabled;
+}
+
+bool LabelStatistics::takeChanges(std::vector<int>& cellIds)
+{
+    cellIds.clear();
+    if (m_allChanged) {
+        m_allChanged = false;
+        return true;
+    }
+    cellIds.swap(m_changedCells);
+    return false;
+}
+
+void LabelStatistics::logChanges(const int* cellIds, size_t count)
+{
+    if (!m_changeLogEnabled || m_allChanged) {
+        return;
+    }
+    m_changedCells.insert(m_changedCells.end(), cellIds, cellIds + count);
+    // 改变的单元太多时逐个同步不比全量同步快，改为全量同步并释放记录（小网格至少记录 1024 个）
+    if (static_cast<double>(m_changedCells.size()) > CHANGE_LOG_FULL_RATIO * m_polyCount + 1024) {
+        markAllChanged();
+    }
+}
+
+void LabelStatistics::markAllChanged()
+{
+    m_changedCells.clear();
+    m_allChanged = m_changeLogEnabled;
+}
+
+void LabelStatistics::ensureLabel(int label)
+{
+    if (label >= labelCount()) {
+        m_totals.grow(label + 1);
+        m_boundsDirty.resize(label + 1, 0);
+    }
+}
+
+bool LabelStatistics::verify() const
+{
+    if (!m_polyData || m_labelLimit <= 0) {
+        return m_totals.counts.empty();
+    }
+
+    Totals expected;
+    reduce(expected);
+    if (expected.counts.size() > m_totals.counts.size()) {
+        qWarning() << "Label statistics mismatch: recount has labels up to"
+                   << expected.counts.size() - 1 << ", incremental up to" << labelCount() - 1;
+        return false;
+    }
+    expected.grow(labelCount());
+
+    // 面积和质心经过多次增减会累积舍入误差，按总面积的相对误差比较
+    const double tolerance = 1e-6 * std::max(m_totalArea, 1.0);
+    bool consistent = true;
+    for (int label = 0; label < labelCount(); ++label) {
+        bool match = expected.counts[label] == m_totals.counts[label]
+            && std::abs(expected.areas[label] - m_totals.areas[label]) <= tolerance;
+        for (int k = 0; k < 3 && match; ++k) {
+            match = std::abs(expected.centroidSums[3 * label + k]
+                             - m_totals.centroidSums[3 * label + k])
+                <= tolerance * (1.0 + std::abs(expected.centroidSums[3 * label + k]));
+        }
+        if (match && !m_boundsDirty[label] && expected.counts[label] > 0) {
+            for (int k = 0; k < 6; ++k) {
+                match = match && expected.bounds[6 * label + k] == m_totals.bounds[6 * label + k];
+            }
+        }
+        if (!match) {
+            qWarning() << "Label statistics mismatch for label" << label
+                       << ": incremental" << m_totals.counts[label] << m_totals.areas[label]
+                       << ", recount" << expected.counts[label] << expected.areas[label];
+            consistent = false;
+        }
+    }
+    return consistent;
+}
+
+std::vector<LabelSummary> LabelStatistics::summaries()
+{
+    if (std::find(m_boundsDirty.begin(), m_boundsDirty.end(), 1) != m_boundsDirty.end()) {
+        recount();
+    }
+
+    std::vector<LabelSummary> result;
+    for (int label = 0; label < labelCount(); ++label) {
+        if (m_totals.counts[label] == 0) {
+            continue;
+        }
+
+        LabelSummary summary;
+        summary.label = label;
+        summary.cellCount = m_totals.counts[label];
+        summary.area = m_totals.areas[label];
+        for (int k = 0; k < 3; ++k) {
+            summary.centroid[k] = summary.area > 0.0
+                ? m_totals.centroidSums[3 * label + k] / summary.area : 0.0;
+        }
+        if (m_totals.bounds[6 * label] <= m_totals.bounds[6 * label + 1]) {
+            std::copy(&m_totals.bounds[6 * label], &m_totals.bounds[6 * label] + 6, summary.bounds);
+        }
+        result.push_back(summary);
+    }
+    return result;
+}
+
+QByteArray LabelStatistics::toCsv(const std::vector<LabelSummary>& summaries)
+{
+    QByteArray csv("label,cells,area,centroid_x,centroid_y,centroid_z,"
+                   "min_x,max_x,min_y,max_y,min_z,max_z\n");
+    for (const LabelSummary& s : summaries) {
+        csv += QByteArray::number(s.label) + ',' + QByteArray::number(s.cellCount) + ','
+            + QByteArray::number(s.area, 'g', 10);
+        for (double value : s.centroid) {
+            csv += ',' + QByteArray::number(value, 'g', 10);
+        }
+        for (double value : s.bounds) {
+            csv += ',' + QByteArray::number(value, 'g', 10);
+        }
+        csv += '\n';
+    }
+    return csv;
+}
+
+QByteArray LabelStatistics::toJson(const std::vector<LabelSummary>& summaries,
+                                   const QString& meshName, double totalArea)
+{
+    QJsonArray labels;
+    for (const LabelSummary& s : summaries) {
+        QJsonObject entry;
+        entry["label"] = s.label;
+        entry["cells"] = s.cellCount;
+        entry["area"] = s.area;
+        entry["centroid"] = QJsonArray { s.centroid[0], s.centroid[1], s.centroid[2] };
+        entry["bounds"] = QJsonArray { s.bounds[0], s.bounds[1], s.bounds[2],
+                                       s.bounds[3], s.bounds[4], s.bounds[5] };
+        labels.append(entry);
+    }
+
+    QJsonObject root;
+    root["mesh"] = meshName;
+    root["totalArea"] = totalArea;
+    root["labels"] = labels;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
@@ -0,0 +1,206 @@
+/**
+ * @file labelstatistics.h
+ * @brief 按标签增量维护的统计信息（单元数量、表面积、质心、包围盒）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LABELSTATISTICS_H
+#define LABELSTATISTICS_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstddef>
+#include <vector>
+
+#include <vtkType.h>
+
+class vtkPolyData;
+
+/**
+ * @brief 单个标签的统计结果
+ */
+struct LabelSummary {
+    int label = 0;                       ///< 标签值
+    int cellCount = 0;                   ///< 单元数量
+    double area = 0.0;                   ///< 表面积
+    double centroid[3] = { 0, 0, 0 };    ///< 面积加权质心
+    double bounds[6] = { 0, 0, 0, 0, 0, 0 }; ///< 包围盒 (xmin, xmax, ymin, ymax, zmin, zmax)
+};
+
+/**
+ * @brief 标签统计
+ *
+ * 加载时用一次并行归约（按线程分块累加后合并）计算每个标签的单元数量、表面积、
+ * 面积加权质心和包围盒；之后每次标签写入（绘制、撤销、重做）通过 moveCell() 按增量更新。
+ * 包围盒只能增量扩大：标签失去单元后其包围盒标记为过期，在 summaries() 时统一重新归约。
+ * 按标签的数组只覆盖出现过的最大标签（不按标签容量预先分配），遇到更大的标签时扩展；
+ * 超出 [0, labelLimit) 的标签值不计入统计。
+ */
+class LabelStatistics {
+public:
+    static constexpr double CHANGE_LOG_FULL_RATIO = 0.25;   ///< 改变记录超过多边形数的该比例时改为全量同步
+
+    /**
+     * @brief 清空统计（未加载网格）
+     */
+    void clear();
+
+    /**
+     * @brief 绑定网格并全量统计（并行）
+     * @param polyData 网格（标签取自单元标量；统计对象不持有网格）
+     * @param labelLimit 统计的标签上限（标签容量）
+     */
+    void recompute(vtkPolyData* polyData, int labelLimit);
+
+    /**
+     * @brief 对已绑定的网格全量重新统计（并行）
+     */
+    void recount();
+
+    /**
+     * @brief 用全量统计校验增量结果
+     * @return 一致返回true
+     */
+    bool verify() const;
+
+    /**
+     * @brief 单元标签由 fromLabel 改为 toLabel 时更新统计
+     */
+    void moveCell(vtkIdType cellId, int fromLabel, int toLabel);
+
+    /**
+     * @brief 一批单元的标签都由 fromLabel 改为 toLabel 时更新统计（并行累加几何量）
+     */
+    void moveCells(const std::vector<int>& cellIds, int fromLabel, int toLabel);
+
+    /**
+     * @brief 开启/关闭单元标签改变的记录（分块渲染据此只更新涉及的块）
+     *
+     * 开启后 moveCell()/moveCells() 记下单元ID；全量统计（recompute/recount）之后，
+     * 或记录的单元超过多边形数的 CHANGE_LOG_FULL_RATIO 时，只记为“全部改变”。
+     */
+    void setChangeLogEnabled(bool enabled);
+
+    /**
+     * @brief 取出上次取出之后标签改变的单元
+     * @param cellIds 输出单元ID（可能重复）
+     * @return 需要全量同步时返回true（此时 cellIds 为空）
+     */
+    bool takeChanges(std::vector<int>& cellIds);
+
+    /**
+     * @brief 按标签数组的长度（出现过的最大标签 + 1）
+     */
+    int labelCount() const { return static_cast<int>(m_totals.counts.size()); }
+
+    /**
+     * @brief 统计的标签上限
+     */
+    int labelLimit() const { return m_labelLimit; }
+
+    /**
+     * @brief 每个标签的单元数量（长度为 labelCount()）
+     */
+    const std::vector<int>& cellCounts() const { return m_totals.counts; }
+
+    /**
+     * @brief 每个标签的表面积
+     */
+    const std::vector<double>& areas() const { return m_totals.areas; }
+
+    /**
+     * @brief 指定标签的单元数量
+     */
+    int cellCount(int label) const { return isStored(label) ? m_totals.counts[label] : 0; }
+
+    /**
+     * @brief 指定标签的表面积
+     */
+    double area(int label) const { return isStored(label) ? m_totals.areas[label] : 0.0; }
+
+    /**
+     * @brief 网格总表面积
+     */
+    double totalArea() const { return m_totalArea; }
+
+    /**
+     * @brief 获取所有非空标签的完整统计（必要时先重新计算过期的包围盒）
+     */
+    std::vector<LabelSummary> summaries();
+
+    /**
+     * @brief 生成 CSV 文本
+     */
+    static QByteArray toCsv(const std::vector<LabelSummary>& summaries);
+
+    /**
+     * @brief 生成 JSON 文本
+     * @param summaries 标签统计
+     * @param meshName 网格名称（写入 "mesh" 字段）
+     * @param totalArea 网格总表面积
+     */
+    static QByteArray toJson(const std::vector<LabelSummary>& summaries,
+                             const QString& meshName, double totalArea);
+
+private:
+    /**
+     * @brief 按标签累加的归约结果
+     */
+    struct Totals {
+        std::vector<int> counts;            ///< 单元数量
+        std::vector<double> areas;          ///< 表面积
+        std::vector<double> centroidSums;   ///< 面积加权质心和（每标签3个）
+        std::vector<double> bounds;         ///< 包围盒（每标签6个）
+
+        void reset(int labelCount);
+        void grow(int labelCount);
+        void merge(const Totals& other);
+    };
+
+    bool isTracked(int label) const
+    {
+        return static_cast<unsigned>(label) < static_cast<unsigned>(m_labelLimit);
+    }
+
+    bool isStored(int label) const
+    {
+        return static_cast<unsigned>(label) < static_cast<unsigned>(m_totals.counts.size());
+    }
+
+    /**
+     * @brief 保证增量统计的数组能容纳 label
+     */
+    void ensureLabel(int label);
+
+    /**
+     * @brief 全量并行归约
+     * @param totals 输出
+     * @return 网格总表面积
+     */
+    double reduce(Totals& totals) const;
+
+    /**
+     * @brief 记录标签改变的单元
+     */
+    void logChanges(const int* cellIds, size_t count);
+
+    /**
+     * @brief 丢弃改变记录，改为“全部改变”（未开启记录时什么也不做）
+     */
+    void markAllChanged();
+
+    vtkPolyData* m_polyData = nullptr;  ///< 绑定的网格（不持有）
+    vtkIdType m_polyOffset = 0;         ///< 第一个多边形的单元ID（前面是 verts、lines）
+    vtkIdType m_polyCount = 0;          ///< 多边形数量
+    int m_labelLimit = 0;               ///< 统计的标签上限
+    Totals m_totals;                    ///< 增量维护的统计
+    std::vector<char> m_boundsDirty;    ///< 包围盒是否过期
+    double m_totalArea = 0.0;           ///< 总表面积
+    bool m_changeLogEnabled = false;    ///< 是否记录标签改变的单元
+    bool m_allChanged = false;          ///< 是否需要全量同步
+    std::vector<int> m_changedCells;    ///< 标签改变的单元
+};
+
+#endif // LABELSTATISTICS_H
@@ -0,0 +1,177 @@
+/**
+ * @file latencyprofiler.cpp
+ * @brief LatencyProfiler 延迟统计器的实现
+ */
+
+#include "latencyprofiler.h"
+
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+std::atomic<bool> LatencyProfiler::s_enabled(false);
+
+namespace {
+
+/**
+ * @brief 当前线程的紧凑编号（用于 Trace 中的 tid）
+ */
+uint32_t currentThreadId()
+{
+    return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffff);
+}
+
+} // namespace
+
+LatencyProfiler::LatencyProfiler()
+    : m_nextEvent(0)
+    , m_originNs(nowNs())
+{
+}
+
+LatencyProfiler& LatencyProfiler::instance()
+{
+    static LatencyProfiler profiler;
+    return profiler;
+}
+
+void LatencyProfiler::setEnabled(bool enabled)
+{
+    if (enabled && !isEnabled()) {
+        reset();
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t LatencyProfiler::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyProfiler::record(ProfileStage stage, int64_t startNs, int64_t durationNs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    StageSamples& samples = m_samples[static_cast<size_t>(stage)];
+    samples.durations[samples.next] = durationNs;
+    samples.next = (samples.next + 1) % SAMPLES_PER_STAGE;
+    samples.count = std::min(samples.count + 1, SAMPLES_PER_STAGE);
+
+    TraceEvent event { startNs, durationNs, currentThreadId(), stage };
+    if (m_events.size() < static_cast<size_t>(MAX_TRACE_EVENTS)) {
+        m_events.push_back(event);
+    } else {
+        m_events[m_nextEvent] = event;
+    }
+    m_nextEvent = (m_nextEvent + 1) % MAX_TRACE_EVENTS;
+}
+
+LatencyProfiler::StageSummary LatencyProfiler::summary(ProfileStage stage) const
+{
+    std::vector<int64_t> durations;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const StageSamples& samples = m_samples[static_cast<size_t>(stage)];
+        durations.assign(samples.durations.begin(), samples.durations.begin() + samples.count);
+    }
+
+    StageSummary result;
+    result.count = static_cast<int>(durations.size());
+    if (durations.empty()) {
+        return result;
+    }
+
+    auto percentile = [&durations](double q) {
+        size_t index = std::min(durations.size() - 1,
+                                static_cast<size_t>(q * static_cast<double>(durations.size())));
+        std::nth_element(durations.begin(), durations.begin() + index, durations.end());
+        return durations[index] / 1.0e6;
+    };
+
+    result.p50Ms = percentile(0.50);
+    result.p99Ms = percentile(0.99);
+    result.maxMs = *std::max_element(durations.begin(), durations.end()) / 1.0e6;
+    return result;
+}
+
+QString LatencyProfiler::summaryText() const
+{
+    QString text = QString("%1  %2  %3  %4\n")
+        .arg("stage", -14).arg("p50 ms", 8).arg("p99 ms", 8).arg("n", 5);
+    for (int i = 0; i < static_cast<int>(ProfileStage::Count); ++i) {
+        ProfileStage stage = static_cast<ProfileStage>(i);
+        StageSummary s = summary(stage);
+        if (s.count == 0) {
+            continue;
+        }
+        text += QString("%1  %2  %3  %4\n")
+            .arg(stageName(stage), -14)
+            .arg(s.p50Ms, 8, 'f', 2)
+            .arg(s.p99Ms, 8, 'f', 2)
+            .arg(s.count, 5);
+    }
+    return text;
+}
+
+bool LatencyProfiler::exportChromeTrace(const QString& filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    std::vector<TraceEvent> events;
+    int64_t originNs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        events = m_events;
+        originNs = m_originNs;
+    }
+    std::sort(events.begin(), events.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.startNs < b.startNs; });
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& e = events[i];
+        out << "{\"name\":\"" << stageName(e.stage) << "\",\"cat\":\"meshlabeler\",\"ph\":\"X\""
+            << ",\"ts\":" << QString::number((e.startNs - originNs) / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(e.durationNs / 1000.0, 'f', 3)
+            << ",\"pid\":1,\"tid\":" << e.threadId << "}"
+            << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+
+    return out.status() == QTextStream::Ok;
+}
+
+void LatencyProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (StageSamples& samples : m_samples) {
+        samples.next = 0;
+        samples.count = 0;
+    }
+    m_events.clear();
+    m_nextEvent = 0;
+    m_originNs = nowNs();
+}
+
+const char* LatencyProfiler::stageName(ProfileStage stage)
+{
+    switch (stage) {
+    case ProfileStage::MouseMove:       return "MouseMove";
+    case ProfileStage::LeftButtonPress: return "LeftButtonPress";
+    case ProfileStage::Pick:            return "Pick";
+    case ProfileStage::RegionQuery:     return "RegionQuery";
+    case ProfileStage::ScalarUpdate:    return "ScalarUpdate";
+    case ProfileStage::Render:          return "Render";
+    case ProfileStage::Count:           break;
+    }
+    return "Unknown";
+}
@@ -0,0 +1,170 @@
+/**
+ * @file latencyprofiler.h
+ * @brief 交互热点路径的延迟统计与 Chrome Trace 导出
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef LATENCYPROFILER_H
+#define LATENCYPROFILER_H
+
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 计时阶段
+ */
+enum class ProfileStage {
+    MouseMove = 0,       ///< MouseMoveCallback 整体
+    LeftButtonPress,     ///< LeftButtonPressCallback 整体
+    Pick,                ///< 拾取（vtkCellPicker）
+    RegionQuery,         ///< 区域查询（labelWithBFS 等）
+    ScalarUpdate,        ///< 标量写入（labelCells）
+    Render,              ///< 渲染（render()）
+    Count
+};
+
+/**
+ * @brief 延迟统计器（单例）
+ *
+ * 关闭时每个计时点只有一次原子读取的开销；
+ * 开启时记录每阶段最近的耗时样本（用于 p50/p99）和完整的事件序列（用于 Chrome Trace）。
+ */
+class LatencyProfiler {
+public:
+    static constexpr int SAMPLES_PER_STAGE = 1024;       ///< 每阶段保留的样本数
+    static constexpr int MAX_TRACE_EVENTS = 1 << 18;     ///< 保留的最大事件数（超出后覆盖最旧的）
+
+    /**
+     * @brief 单个阶段的统计结果
+     */
+    struct StageSummary {
+        int count = 0;          ///< 样本数
+        double p50Ms = 0.0;     ///< 中位数（毫秒）
+        double p99Ms = 0.0;     ///< 99 分位（毫秒）
+        double maxMs = 0.0;     ///< 最大值（毫秒）
+    };
+
+    /**
+     * @brief 获取全局实例
+     */
+    static LatencyProfiler& instance();
+
+    /**
+     * @brief 是否开启统计（热点路径上的唯一检查）
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 开启/关闭统计，开启时清空旧数据
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief 当前单调时钟（纳秒）
+     */
+    static int64_t nowNs();
+
+    /**
+     * @brief 记录一次阶段耗时
+     * @param stage 阶段
+     * @param startNs 开始时间（纳秒）
+     * @param durationNs 耗时（纳秒）
+     */
+    void record(ProfileStage stage, int64_t startNs, int64_t durationNs);
+
+    /**
+     * @brief 获取阶段统计
+     */
+    StageSummary summary(ProfileStage stage) const;
+
+    /**
+     * @brief 生成多行文本形式的统计摘要（用于屏幕显示）
+     */
+    QString summaryText() const;
+
+    /**
+     * @brief 导出 Chrome Trace JSON（可在 chrome://tracing 或 Perfetto 中打开）
+     * @param filename 文件路径
+     * @return 成功返回true
+     */
+    bool exportChromeTrace(const QString& filename) const;
+
+    /**
+     * @brief 清空所有样本和事件
+     */
+    void reset();
+
+    /**
+     * @brief 获取阶段名称
+     */
+    static const char* stageName(ProfileStage stage);
+
+private:
+    LatencyProfiler();
+
+    struct TraceEvent {
+        int64_t startNs;
+        int64_t durationNs;
+        uint32_t threadId;
+        ProfileStage stage;
+    };
+
+    struct StageSamples {
+        std::array<int64_t, SAMPLES_PER_STAGE> durations{};
+        int next = 0;
+        int count = 0;
+    };
+
+    static std::atomic<bool> s_enabled;
+
+    mutable std::mutex m_mutex;
+    std::array<StageSamples, static_cast<size_t>(ProfileStage::Count)> m_samples;
+    std::vector<TraceEvent> m_events;      ///< 环形事件缓冲
+    size_t m_nextEvent;                    ///< 下一个写入位置
+    int64_t m_originNs;                    ///< 事件时间原点
+};
+
+/**
+ * @brief 作用域计时器：构造时开始，析构时记录
+ */
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(ProfileStage stage)
+        : m_stage(stage)
+        , m_startNs(LatencyProfiler::isEnabled() ? LatencyProfiler::nowNs() : -1)
+    {
+    }
+
+    ~ScopedStageTimer()
+    {
+        if (m_startNs >= 0) {
+            LatencyProfiler::instance().record(m_stage, m_startNs,
+                                               LatencyProfiler::nowNs() - m_startNs);
+        }
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    ProfileStage m_stage;
+    int64_t m_startNs;
+};
+
+// 编译期可通过 MESHLABELER_DISABLE_PROFILING 完全移除计时点
+#ifndef MESHLABELER_DISABLE_PROFILING
+#define ML_PROFILE_CONCAT_INNER(a, b) a##b
+#define ML_PROFILE_CONCAT(a, b) ML_PROFILE_CONCAT_INNER(a, b)
+#define ML_PROFILE_SCOPE(stage) \
+    ScopedStageTimer ML_PROFILE_CONCAT(mlProfileScope, __LINE__)(stage)
+#else
+#define ML_PROFILE_SCOPE(stage) ((void)0)
+#endif
+
+#endif // LATENCYPROFILER_H
@@ -5,9 +5,21 @@
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "labelhistogramwidget.h"
 
+#include <QCheckBox>
+#include <QDockWidget>
+#include <QDoubleSpinBox>
 #include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QListWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
 #include <QDebug>
+#include <QShortcut>
+#include <QSpinBox>
+#include <QStatusBar>
 #include <QTextCodec>
 
 #pragma execution_character_set("utf-8")
@@ -17,6 +29,20 @@ MainWindow::MainWindow(QWidget *parent)
     , ui(new Ui::MainWindow)
     , m_labeler(nullptr)
     , m_autoSaveTimer(nullptr)
+    , m_statisticsDock(nullptr)
+    , m_histogram(nullptr)
+    , m_toolDock(nullptr)
+    , m_meshDock(nullptr)
+    , m_meshList(nullptr)
+    , m_featureAngleSpin(nullptr)
+    , m_normalAngleSpin(nullptr)
+    , m_curvatureSpin(nullptr)
+    , m_fragmentSpin(nullptr)
+    , m_smoothIterationsSpin(nullptr)
+    , m_backgroundLabelSpin(nullptr)
+    , m_labelCapacitySpin(nullptr)
+    , m_lockLabelCheck(nullptr)
+    , m_hideLabelCheck(nullptr)
 {
     ui->setupUi(this);
 
@@ -35,6 +61,135 @@ MainWindow::MainWindow(QWidget *parent)
     m_labeler->setupRenderer(ui->qvtkWidget->GetRenderWindow());
     m_labeler->initializeCallbacks();
 
+    // 标签统计直方图（停靠在右侧）
+    m_histogram = new LabelHistogramWidget(this);
+    updateLabelColors();
+    m_histogram->setCurrentLabel(m_labeler->getCurrentLabel());
+
+    m_statisticsDock = new QDockWidget(tr("标签统计（单元数 / 面积占比）"), this);
+    m_statisticsDock->setObjectName("statisticsDock");
+    QWidget* statisticsPanel = new QWidget(this);
+    QVBoxLayout* statisticsLayout = new QVBoxLayout(statisticsPanel);
+    statisticsLayout->setContentsMargins(0, 0, 0, 0);
+    statisticsLayout->addWidget(m_histogram);
+    QPushButton* exportStatisticsButton = new QPushButton(tr("导出统计..."), statisticsPanel);
+    statisticsLayout->addWidget(exportStatisticsButton);
+    QHBoxLayout* componentsLayout = new QHBoxLayout();
+    m_fragmentSpin = new QSpinBox(statisticsPanel);
+    m_fragmentSpin->setRange(1, 1000000);
+    m_fragmentSpin->setValue(50);
+    m_fragmentSpin->setPrefix(tr("碎片 < "));
+    m_fragmentSpin->setSuffix(tr(" 单元"));
+    componentsLayout->addWidget(m_fragmentSpin);
+    QPushButton* checkComponentsButton = new QPushButton(tr("检查孤岛"), statisticsPanel);
+    componentsLayout->addWidget(checkComponentsButton);
+    QPushButton* mergeFragmentsButton = new QPushButton(tr("合并碎片"), statisticsPanel);
+    componentsLayout->addWidget(mergeFragmentsButton);
+    statisticsLayout->addLayout(componentsLayout);
+    QPushButton* memoryButton = new QPushButton(tr("内存占用..."), statisticsPanel);
+    statisticsLayout->addWidget(memoryButton);
+    statisticsLayout->addStretch();
+    connect(exportStatisticsButton, &QPushButton::clicked,
+            this, &MainWindow::exportLabelStatistics);
+    connect(checkComponentsButton, &QPushButton::clicked,
+            this, &MainWindow::checkComponents);
+    connect(mergeFragmentsButton, &QPushButton::clicked,
+            this, &MainWindow::mergeFragments);
+    connect(memoryButton, &QPushButton::clicked,
+            this, &MainWindow::showMemoryReport);
+    m_statisticsDock->setWidget(statisticsPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_statisticsDock);
+
+    // 工具参数（魔棒停止条件，0 表示不启用）
+    const RegionGrowOptions& growOptions = m_labeler->regionGrowOptions();
+    m_toolDock = new QDockWidget(tr("工具参数"), this);
+    m_toolDock->setObjectName("toolDock");
+    QWidget* toolPanel = new QWidget(this);
+    QFormLayout* toolLayout = new QFormLayout(toolPanel);
+    m_featureAngleSpin = new QDoubleSpinBox(toolPanel);
+    m_featureAngleSpin->setRange(0.0, 180.0);
+    m_featureAngleSpin->setSuffix(tr(" 度"));
+    m_featureAngleSpin->setValue(growOptions.featureAngle);
+    toolLayout->addRow(tr("魔棒特征边角度"), m_featureAngleSpin);
+    m_normalAngleSpin = new QDoubleSpinBox(toolPanel);
+    m_normalAngleSpin->setRange(0.0, 180.0);
+    m_normalAngleSpin->setSuffix(tr(" 度"));
+    m_normalAngleSpin->setValue(growOptions.normalAngle);
+    toolLayout->addRow(tr("魔棒法向角度"), m_normalAngleSpin);
+    m_curvatureSpin = new QDoubleSpinBox(toolPanel);
+    m_curvatureSpin->setRange(0.0, 1000.0);
+    m_curvatureSpin->setDecimals(3);
+    m_curvatureSpin->setValue(growOptions.curvature);
+    toolLayout->addRow(tr("魔棒曲率阈值"), m_curvatureSpin);
+    for (QDoubleSpinBox* spin : { m_featureAngleSpin, m_normalAngleSpin, m_curvatureSpin }) {
+        connect(spin, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+                this, &MainWindow::updateRegionGrowOptions);
+    }
+    QHBoxLayout* smoothLayout = new QHBoxLayout();
+    m_smoothIterationsSpin = new QSpinBox(toolPanel);
+    m_smoothIterationsSpin->setRange(1, 100);
+    m_smoothIterationsSpin->setValue(LabelSmoother::DEFAULT_ITERATIONS);
+    m_smoothIterationsSpin->setSuffix(tr(" 轮"));
+    smoothLayout->addWidget(m_smoothIterationsSpin);
+    QPushButton* smoothButton = new QPushButton(tr("平滑边界"), toolPanel);
+    smoothLayout->addWidget(smoothButton);
+    toolLayout->addRow(tr("边界锯齿"), smoothLayout);
+    connect(smoothButton, &QPushButton::clicked, this, &MainWindow::smoothBoundaries);
+    QHBoxLayout* refineLayout = new QHBoxLayout();
+    m_backgroundLabelSpin = new QSpinBox(toolPanel);
+    m_backgroundLabelSpin->setRange(0, m_labeler->labelCapacity() - 1);
+    m_backgroundLabelSpin->setPrefix(tr("背景 "));
+    refineLayout->addWidget(m_backgroundLabelSpin);
+    QPushButton* refineButton = new QPushButton(tr("图割细化"), toolPanel);
+    refineLayout->addWidget(refineButton);
+    toolLayout->addRow(tr("当前标签边界"), refineLayout);
+    connect(refineButton, &QPushButton::clicked, this, &MainWindow::refineBoundary);
+    QPushButton* transferButton = new QPushButton(tr("从参考网格迁移..."), toolPanel);
+    toolLayout->addRow(tr("标签迁移"), transferButton);
+    connect(transferButton, &QPushButton::clicked, this, &MainWindow::transferLabels);
+    m_labelCapacitySpin = new QSpinBox(toolPanel);
+    m_labelCapacitySpin->setRange(1, MeshLabelCore::MAX_LABEL_CAPACITY);
+    m_labelCapacitySpin->setValue(m_labeler->labelCapacity());
+    m_labelCapacitySpin->setToolTip(tr("不超过 256 时每个标签占1字节，否则占2字节"));
+    toolLayout->addRow(tr("标签容量"), m_labelCapacitySpin);
+    connect(m_labelCapacitySpin, &QSpinBox::editingFinished,
+            this, &MainWindow::applyLabelCapacity);
+    QHBoxLayout* maskLayout = new QHBoxLayout();
+    m_lockLabelCheck = new QCheckBox(tr("锁定"), toolPanel);
+    m_lockLabelCheck->setToolTip(tr("锁定的标签不会被画刷、填充等工具覆盖 (L)"));
+    maskLayout->addWidget(m_lockLabelCheck);
+    m_hideLabelCheck = new QCheckBox(tr("隐藏"), toolPanel);
+    m_hideLabelCheck->setToolTip(tr("隐藏的标签不显示、不可拾取，也不会被覆盖 (X)"));
+    maskLayout->addWidget(m_hideLabelCheck);
+    QPushButton* showAllButton = new QPushButton(tr("全部显示"), toolPanel);
+    maskLayout->addWidget(showAllButton);
+    toolLayout->addRow(tr("当前标签"), maskLayout);
+    connect(m_lockLabelCheck, &QCheckBox::clicked, this, &MainWindow::lockCurrentLabel);
+    connect(m_hideLabelCheck, &QCheckBox::clicked, this, &MainWindow::hideCurrentLabel);
+    connect(showAllButton, &QPushButton::clicked, m_labeler, &MeshLabeler::showAllLabels);
+    m_toolDock->setWidget(toolPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_toolDock);
+
+    // 网格列表（多网格会话，编辑作用于选中的网格）
+    m_meshDock = new QDockWidget(tr("网格"), this);
+    m_meshDock->setObjectName("meshDock");
+    QWidget* meshPanel = new QWidget(this);
+    QVBoxLayout* meshLayout = new QVBoxLayout(meshPanel);
+    meshLayout->setContentsMargins(0, 0, 0, 0);
+    m_meshList = new QListWidget(meshPanel);
+    meshLayout->addWidget(m_meshList);
+    QHBoxLayout* meshButtonLayout = new QHBoxLayout();
+    QPushButton* addMeshButton = new QPushButton(tr("添加网格..."), meshPanel);
+    meshButtonLayout->addWidget(addMeshButton);
+    QPushButton* removeMeshButton = new QPushButton(tr("移除"), meshPanel);
+    meshButtonLayout->addWidget(removeMeshButton);
+    meshLayout->addLayout(meshButtonLayout);
+    connect(addMeshButton, &QPushButton::clicked, this, &MainWindow::addMesh);
+    connect(removeMeshButton, &QPushButton::clicked, this, &MainWindow::removeMesh);
+    connect(m_meshList, &QListWidget::currentRowChanged, this, &MainWindow::onMeshSelected);
+    m_meshDock->setWidget(meshPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_meshDock);
+
     // 连接信号和槽
     connect(m_labeler, &MeshLabeler::currentLabelChanged,
             this, &MainWindow::onLabelChanged);
@@ -42,6 +197,23 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onError);
     connect(m_labeler, &MeshLabeler::meshLoaded,
             this, &MainWindow::onMeshLoaded);
+    connect(m_labeler, &MeshLabeler::labelStatisticsChanged,
+            this, &MainWindow::updateLabelStatistics);
+    connect(m_labeler, &MeshLabeler::meshListChanged,
+            this, &MainWindow::updateMeshList);
+    connect(m_labeler, &MeshLabeler::activeMeshChanged,
+            this, &MainWindow::onActiveMeshChanged);
+    connect(m_labeler, &MeshLabeler::currentLabelChanged,
+            m_histogram, &LabelHistogramWidget::setCurrentLabel);
+    connect(m_labeler, &MeshLabeler::paletteChanged,
+            this, &MainWindow::updateLabelColors);
+    connect(m_labeler, &MeshLabeler::labelCapacityChanged,
+            this, &MainWindow::onLabelCapacityChanged);
+    connect(m_labeler, &MeshLabeler::labelMasksChanged,
+            this, &MainWindow::updateLabelMasks);
+    connect(m_labeler, &MeshLabeler::currentLabelChanged,
+            this, &MainWindow::updateLabelMasks);
+    onLabelCapacityChanged(m_labeler->labelCapacity());
 
     // 设置自动保存定时器
     m_autoSaveTimer = new QTimer(this);
@@ -50,6 +222,11 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::performAutoSave);
     m_autoSaveTimer->start();
 
+    // Ctrl+Shift+T 导出延迟统计
+    QShortcut* traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    connect(traceShortcut, &QShortcut::activated,
+            this, &MainWindow::exportLatencyTrace);
+
     qDebug() << "MainWindow initialized";
 }
 
@@ -164,6 +341,267 @@ void MainWindow::on_outPut_btn_clicked()
     }
 }
 
+void MainWindow::updateLabelStatistics()
+{
+    if (!m_labeler || !m_histogram) {
+        return;
+    }
+
+    const LabelStatistics& stats = m_labeler->labelStatistics();
+    m_histogram->setStatistics(stats.cellCounts(), stats.areas(),
+                               m_labeler->getCellCount(), stats.totalArea());
+}
+
+void MainWindow::updateLabelColors()
+{
+    std::vector<QColor> labelColors;
+    for (int i = 0; i < m_labeler->paletteSize(); ++i) {
+        double rgba[4];
+        m_labeler->getLookupTable()->GetTableValue(i, rgba);
+        labelColors.push_back(QColor::fromRgbF(rgba[0], rgba[1], rgba[2]));
+    }
+    m_histogram->setLabelColors(labelColors);
+}
+
+void MainWindow::applyLabelCapacity()
+{
+    const int capacity = m_labelCapacitySpin->value();
+    if (capacity != m_labeler->labelCapacity() && !m_labeler->setLabelCapacity(capacity)) {
+        m_labelCapacitySpin->setValue(m_labeler->labelCapacity());
+    }
+}
+
+void MainWindow::onLabelCapacityChanged(int capacity)
+{
+    ui->spinBox->setMaximum(capacity - 1);
+    m_backgroundLabelSpin->setMaximum(capacity - 1);
+    if (m_labelCapacitySpin->value() != capacity) {
+        m_labelCapacitySpin->setValue(capacity);
+    }
+}
+
+void MainWindow::lockCurrentLabel(bool locked)
+{
+    m_labeler->setLabelLocked(m_labeler->getCurrentLabel(), locked);
+}
+
+void MainWindow::hideCurrentLabel(bool hidden)
+{
+    m_labeler->setLabelHidden(m_labeler->getCurrentLabel(), hidden);
+}
+
+void MainWindow::updateLabelMasks()
+{
+    const int label = m_labeler->getCurrentLabel();
+    m_lockLabelCheck->setChecked(m_labeler->isLabelLocked(label));
+    m_hideLabelCheck->setChecked(m_labeler->isLabelHidden(label));
+    m_histogram->setLabelMasks(m_labeler->lockedLabels(), m_labeler->hiddenLabels());
+}
+
+void MainWindow::exportLabelStatistics()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("没有可导出的网格数据"));
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出标签统计"),
+        m_lastOpenPath,
+        "CSV Files(*.csv);;JSON Files(*.json)");
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (!fileName.endsWith(".csv", Qt::CaseInsensitive)
+        && !fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        fileName += ".csv";
+    }
+
+    if (m_labeler->exportLabelStatistics(fileName)) {
+        QMessageBox::information(this, tr("成功"), tr("标签统计已导出: %1").arg(fileName));
+    }
+}
+
+void MainWindow::checkComponents()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+
+    const int minCells = m_fragmentSpin->value();
+    const std::vector<LabelComponentSummary> summaries =
+        m_labeler->analyzeComponents().summaries(minCells);
+
+    // 只列出分裂成多块或含碎片的标签
+    QStringList lines;
+    for (const LabelComponentSummary& summary : summaries) {
+        if (summary.componentCount > 1 || summary.fragmentCount > 0) {
+            lines << tr("标签 %1：%2 块，最大 %3 单元，最小 %4 单元，碎片 %5 块（%6 单元）")
+                         .arg(summary.label)
+                         .arg(summary.componentCount)
+                         .arg(summary.largest)
+                         .arg(summary.smallest)
+                         .arg(summary.fragmentCount)
+                         .arg(summary.fragmentCells);
+        }
+    }
+
+    if (lines.isEmpty()) {
+        QMessageBox::information(this, tr("检查孤岛"), tr("每个标签都是一个连通区域"));
+    } else {
+        QMessageBox::information(this, tr("检查孤岛"), lines.join("\n"));
+    }
+}
+
+void MainWindow::mergeFragments()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+
+    const int merged = m_labeler->mergeSmallComponents(m_fragmentSpin->value());
+    QMessageBox::information(this, tr("合并碎片"),
+                             tr("已合并 %1 块碎片（可撤销）").arg(merged));
+}
+
+void MainWindow::showMemoryReport()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+
+    const MemoryReport report = m_labeler->memoryReport();
+    QMessageBox box(this);
+    box.setWindowTitle(tr("内存占用"));
+    box.setText(QString("<pre>%1</pre>").arg(report.toText().toHtmlEscaped()));
+    box.setInformativeText(tr("常驻 %1 字节/三角形，预算 %2 字节/三角形")
+                               .arg(report.residentBytesPerCell(), 0, 'f', 1)
+                               .arg(MeshLabelCore::MEMORY_BUDGET_PER_CELL));
+    box.exec();
+}
+
+void MainWindow::smoothBoundaries()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+
+    const int changed = m_labeler->smoothLabelBoundaries(m_smoothIterationsSpin->value());
+    statusBar()->showMessage(tr("边界平滑：改变 %1 个单元（可撤销）").arg(changed), 5000);
+}
+
+void MainWindow::refineBoundary()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+    if (m_backgroundLabelSpin->value() == m_labeler->getCurrentLabel()) {
+        QMessageBox::warning(this, tr("警告"), tr("背景标签不能与当前标签相同"));
+        return;
+    }
+
+    const int changed = m_labeler->refineWithGraphCut(m_backgroundLabelSpin->value());
+    statusBar()->showMessage(tr("图割细化：改变 %1 个单元（可撤销）").arg(changed), 5000);
+}
+
+void MainWindow::transferLabels()
+{
+    if (!m_labeler || !m_labeler->isMeshLoaded()) {
+        QMessageBox::warning(this, tr("警告"), tr("请先加载网格"));
+        return;
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(
+        this,
+        tr("选择已标注的参考网格"),
+        m_lastOpenPath,
+        "VTP Files(*.vtp)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    const int changed = m_labeler->transferLabelsFrom(fileName);
+    if (changed >= 0) {
+        statusBar()->showMessage(tr("标签迁移：改变 %1 个单元（可撤销）").arg(changed), 5000);
+    }
+}
+
+void MainWindow::addMesh()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this,
+        tr("添加网格文件"),
+        m_lastOpenPath,
+        "Mesh Files(*.stl *.vtp);;STL Files(*.stl);;VTP Files(*.vtp);;All Files(*.*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (m_labeler->addMesh(fileName)) {
+        m_lastOpenPath = QFileInfo(fileName).dir().path();
+        saveConfig();
+    }
+}
+
+void MainWindow::removeMesh()
+{
+    const int index = m_labeler->activeMesh();
+    if (index < 0) {
+        return;
+    }
+    if (m_labeler->canUndo()
+        && QMessageBox::question(this, tr("移除网格"),
+                                 tr("%1 有未保存的标注，确定移除？")
+                                     .arg(QFileInfo(m_labeler->meshFileName(index)).fileName()))
+               != QMessageBox::Yes) {
+        return;
+    }
+    m_labeler->removeMesh(index);
+}
+
+void MainWindow::updateMeshList()
+{
+    const QSignalBlocker blocker(m_meshList);
+    m_meshList->clear();
+    for (int i = 0; i < m_labeler->meshCount(); ++i) {
+        const QString fileName = m_labeler->meshFileName(i);
+        QListWidgetItem* item = new QListWidgetItem(QFileInfo(fileName).fileName(), m_meshList);
+        item->setToolTip(fileName);
+    }
+    m_meshList->setCurrentRow(m_labeler->activeMesh());
+}
+
+void MainWindow::onMeshSelected(int row)
+{
+    if (row >= 0 && row != m_labeler->activeMesh()) {
+        m_labeler->setActiveMesh(row);
+    }
+}
+
+void MainWindow::onActiveMeshChanged(int index)
+{
+    const QSignalBlocker blocker(m_meshList);
+    m_meshList->setCurrentRow(index);
+    ui->fileName_label->setText(m_labeler->meshFileName(index));
+}
+
+void MainWindow::updateRegionGrowOptions()
+{
+    RegionGrowOptions options = m_labeler->regionGrowOptions();
+    options.featureAngle = m_featureAngleSpin->value();
+    options.normalAngle = m_normalAngleSpin->value();
+    options.curvature = m_curvatureSpin->value();
+    m_labeler->setRegionGrowOptions(options);
+}
+
 void MainWindow::onLabelChanged(int newLabel)
 {
     // 更新 SpinBox 显示当前标签
@@ -210,3 +648,29 @@ void MainWindow::performAutoSave()
         m_labeler->performAutoSave();
     }
 }
+
+void MainWindow::exportLatencyTrace()
+{
+    if (!m_labeler) {
+        return;
+    }
+
+    if (!m_labeler->isProfilingEnabled()) {
+        QMessageBox::information(this, tr("提示"), tr("请先按 H 键开启延迟统计"));
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出延迟统计"),
+        m_lastOpenPath,
+        "Chrome Trace (*.json)");
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (m_labeler->exportLatencyTrace(fileName)) {
+        QMessageBox::information(this, tr("成功"), tr("延迟统计已导出: %1").arg(fileName));
+    }
+}
@@ -12,6 +12,13 @@
 #include <QMessageBox>
 #include "meshlabeler.h"
 
+class QCheckBox;
+class QDockWidget;
+class QDoubleSpinBox;
+class QListWidget;
+class QSpinBox;
+class LabelHistogramWidget;
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
@@ -81,6 +88,111 @@ private slots:
      */
     void performAutoSave();
 
+    /**
+     * @brief 导出延迟统计（Chrome Trace JSON）
+     */
+    void exportLatencyTrace();
+
+    /**
+     * @brief 刷新标签统计直方图
+     */
+    void updateLabelStatistics();
+
+    /**
+     * @brief 导出标签统计（CSV/JSON）
+     */
+    void exportLabelStatistics();
+
+    /**
+     * @brief 把工具参数面板的数值同步到魔棒停止条件
+     */
+    void updateRegionGrowOptions();
+
+    /**
+     * @brief 检查标签区域的连通分量（孤岛、碎片）
+     */
+    void checkComponents();
+
+    /**
+     * @brief 把小于阈值的碎片合并到周围标签
+     */
+    void mergeFragments();
+
+    /**
+     * @brief 显示各数据结构的内存占用
+     */
+    void showMemoryReport();
+
+    /**
+     * @brief 平滑标签边界
+     */
+    void smoothBoundaries();
+
+    /**
+     * @brief 图割细化当前标签与背景标签之间的边界
+     */
+    void refineBoundary();
+
+    /**
+     * @brief 从已标注的参考网格迁移标签
+     */
+    void transferLabels();
+
+    /**
+     * @brief 向会话中添加网格
+     */
+    void addMesh();
+
+    /**
+     * @brief 从会话中移除当前网格
+     */
+    void removeMesh();
+
+    /**
+     * @brief 刷新网格列表
+     */
+    void updateMeshList();
+
+    /**
+     * @brief 列表中选中的网格设为当前网格
+     */
+    void onMeshSelected(int row);
+
+    /**
+     * @brief 当前网格改变后同步列表选中项和文件名
+     */
+    void onActiveMeshChanged(int index);
+
+    /**
+     * @brief 颜色查找表改变后刷新直方图的标签颜色
+     */
+    void updateLabelColors();
+
+    /**
+     * @brief 应用输入框中的标签容量
+     */
+    void applyLabelCapacity();
+
+    /**
+     * @brief 标签容量改变后同步各个标签输入框的范围
+     */
+    void onLabelCapacityChanged(int capacity);
+
+    /**
+     * @brief 锁定或解锁当前标签
+     */
+    void lockCurrentLabel(bool locked);
+
+    /**
+     * @brief 隐藏或显示当前标签
+     */
+    void hideCurrentLabel(bool hidden);
+
+    /**
+     * @brief 同步当前标签的锁定/隐藏复选框和直方图中的标记
+     */
+    void updateLabelMasks();
+
 private:
     Ui::MainWindow *ui;                ///< UI对象
     QString m_appPath;                 ///< 程序路径
@@ -88,6 +200,20 @@ private:
     QSettings *m_config;               ///< 配置对象
     MeshLabeler *m_labeler;            ///< 标注器对象
     QTimer *m_autoSaveTimer;           ///< 自动保存定时器
+    QDockWidget *m_statisticsDock;     ///< 标签统计停靠窗口
+    LabelHistogramWidget *m_histogram; ///< 标签统计直方图
+    QDockWidget *m_toolDock;           ///< 工具参数停靠窗口
+    QDockWidget *m_meshDock;           ///< 网格列表停靠窗口
+    QListWidget *m_meshList;           ///< 会话中的网格
+    QDoubleSpinBox *m_featureAngleSpin;  ///< 魔棒特征边角度
+    QDoubleSpinBox *m_normalAngleSpin;   ///< 魔棒法向角度
+    QDoubleSpinBox *m_curvatureSpin;     ///< 魔棒曲率阈值
+    QSpinBox *m_fragmentSpin;            ///< 碎片阈值（单元数）
+    QSpinBox *m_smoothIterationsSpin;    ///< 边界平滑迭代轮数
+    QSpinBox *m_backgroundLabelSpin;     ///< 图割细化的背景标签
+    QSpinBox *m_labelCapacitySpin;       ///< 标签容量
+    QCheckBox *m_lockLabelCheck;         ///< 锁定当前标签
+    QCheckBox *m_hideLabelCheck;         ///< 隐藏当前标签
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,156 @@
+/**
+ * @file maxflowgraph.cpp
+ * @brief MaxFlowGraph 最大流求解器的实现
+ */
+
+#include "maxflowgraph.h"
+
+#include <algorithm>
+#include <limits>
+
+void MaxFlowGraph::reset(int nodeCount)
+{
+    m_nodeCount = nodeCount;
+    m_pending.clear();
+    m_arcTo.clear();
+    m_arcCapacity.clear();
+    m_arcReverse.clear();
+    m_level.assign(nodeCount + 2, -1);
+}
+
+void MaxFlowGraph::addEdge(int from, int to, float capacity, float reverseCapacity)
+{
+    if (from == to || (capacity <= 0.0f && reverseCapacity <= 0.0f)) {
+        return;
+    }
+    m_pending.push_back({ from, to, capacity, reverseCapacity });
+}
+
+void MaxFlowGraph::buildArcs()
+{
+    const int nodeTotal = m_nodeCount + 2;
+    m_offsets.assign(nodeTotal + 1, 0);
+    for (const PendingEdge& edge : m_pending) {
+        ++m_offsets[edge.from + 1];
+        ++m_offsets[edge.to + 1];
+    }
+    for (int node = 0; node < nodeTotal; ++node) {
+        m_offsets[node + 1] += m_offsets[node];
+    }
+
+    const size_t arcCount = m_offsets[nodeTotal];
+    m_arcTo.resize(arcCount);
+    m_arcCapacity.resize(arcCount);
+    m_arcReverse.resize(arcCount);
+    m_cursor.assign(m_offsets.begin(), m_offsets.end() - 1);
+    for (const PendingEdge& edge : m_pending) {
+        const int forward = m_cursor[edge.from]++;
+        const int backward = m_cursor[edge.to]++;
+        m_arcTo[forward] = edge.to;
+        m_arcCapacity[forward] = edge.capacity;
+        m_arcReverse[forward] = backward;
+        m_arcTo[backward] = edge.from;
+        m_arcCapacity[backward] = edge.reverseCapacity;
+        m_arcReverse[backward] = forward;
+    }
+
+    // 边已整理到 CSR，释放追加列表
+    std::vector<PendingEdge>().swap(m_pending);
+}
+
+bool MaxFlowGraph::buildLevels()
+{
+    std::fill(m_level.begin(), m_level.end(), -1);
+    m_queue.clear();
+    m_level[source()] = 0;
+    m_queue.push_back(source());
+    for (size_t head = 0; head < m_queue.size(); ++head) {
+        const int node = m_queue[head];
+        for (int arc = m_offsets[node]; arc < m_offsets[node + 1]; ++arc) {
+            const int next = m_arcTo[arc];
+            if (m_arcCapacity[arc] > 0.0f && m_level[next] < 0) {
+                m_level[next] = m_level[node] + 1;
+                m_queue.push_back(next);
+            }
+        }
+    }
+    return m_level[sink()] >= 0;
+}
+
+double MaxFlowGraph::blockingFlow()
+{
+    double total = 0.0;
+    m_cursor.assign(m_offsets.begin(), m_offsets.end() - 1);
+    m_path.clear();
+
+    int node = source();
+    while (true) {
+        if (node == sink()) {
+            // 沿路径增广瓶颈容量，退回到第一条饱和弧的起点
+            float bottleneck = std::numeric_limits<float>::max();
+            for (int arc : m_path) {
+                bottleneck = std::min(bottleneck, m_arcCapacity[arc]);
+            }
+            size_t firstSaturated = m_path.size();
+            for (size_t i = 0; i < m_path.size(); ++i) {
+                const int arc = m_path[i];
+                m_arcCapacity[arc] -= bottleneck;
+                m_arcCapacity[m_arcReverse[arc]] += bottleneck;
+                if (m_arcCapacity[arc] <= 0.0f && firstSaturated == m_path.size()) {
+                    firstSaturated = i;
+                }
+            }
+            total += bottleneck;
+            m_path.resize(firstSaturated);
+            node = m_path.empty() ? source() : m_arcTo[m_path.back()];
+            continue;
+        }
+
+        // 前进：沿分层图中下一层的非饱和弧
+        bool advanced = false;
+        for (int& arc = m_cursor[node]; arc < m_offsets[node + 1]; ++arc) {
+            const int next = m_arcTo[arc];
+            if (m_arcCapacity[arc] > 0.0f && m_level[next] == m_level[node] + 1) {
+                m_path.push_back(arc);
+                node = next;
+                advanced = true;
+                break;
+            }
+        }
+        if (advanced) {
+            continue;
+        }
+
+        // 后退：该节点已无出路，本轮不再经过它
+        if (node == source()) {
+            break;
+        }
+        m_level[node] = -1;
+        const int arc = m_path.back();
+        m_path.pop_back();
+        node = m_arcTo[m_arcReverse[arc]];
+        ++m_cursor[node];
+    }
+    return total;
+}
+
+double MaxFlowGraph::solve()
+{
+    buildArcs();
+
+    double flow = 0.0;
+    while (buildLevels()) {
+        flow += blockingFlow();
+    }
+    // 最后一次分层不可达汇点：m_level >= 0 的节点即源点一侧
+    return flow;
+}
+
+size_t MaxFlowGraph::memoryBytes() const
+{
+    return m_pending.capacity() * sizeof(PendingEdge)
+        + (m_offsets.capacity() + m_arcTo.capacity() + m_arcReverse.capacity()
+           + m_level.capacity() + m_cursor.capacity() + m_queue.capacity()
+           + m_path.capacity()) * sizeof(int)
+        + m_arcCapacity.capacity() * sizeof(float);
+}
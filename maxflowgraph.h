@@ -0,0 +1,99 @@
+/**
+ * @file maxflowgraph.h
+ * @brief 最大流 / 最小割求解器（Dinic，紧凑存储）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef MAXFLOWGRAPH_H
+#define MAXFLOWGRAPH_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 最大流图
+ *
+ * 节点 0..nodeCount-1 由调用方定义，另有源点 source() 和汇点 sink()。
+ * 边先追加到列表，solve() 时一次性整理为 CSR（每条弧只存终点、float 容量和反向弧下标），
+ * 然后用 Dinic 算法求最大流：BFS 分层后用显式栈做阻塞流，不会因路径过长而栈溢出。
+ * 缓冲区在多次求解间复用。
+ */
+class MaxFlowGraph {
+public:
+    /**
+     * @brief 清空图并设置节点数量
+     */
+    void reset(int nodeCount);
+
+    /**
+     * @brief 源点
+     */
+    int source() const { return m_nodeCount; }
+
+    /**
+     * @brief 汇点
+     */
+    int sink() const { return m_nodeCount + 1; }
+
+    /**
+     * @brief 添加边
+     * @param from 起点
+     * @param to 终点
+     * @param capacity 正向容量
+     * @param reverseCapacity 反向容量（无向边与正向相同）
+     */
+    void addEdge(int from, int to, float capacity, float reverseCapacity);
+
+    /**
+     * @brief 求最大流（等于最小割的容量）
+     */
+    double solve();
+
+    /**
+     * @brief solve() 之后节点是否在最小割的源点一侧
+     */
+    bool isSourceSide(int node) const { return m_level[node] >= 0; }
+
+    /**
+     * @brief 占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct PendingEdge {
+        int from;
+        int to;
+        float capacity;
+        float reverseCapacity;
+    };
+
+    /**
+     * @brief 把追加的边整理为 CSR
+     */
+    void buildArcs();
+
+    /**
+     * @brief 在残量图上从源点分层
+     * @return 汇点可达时返回true
+     */
+    bool buildLevels();
+
+    /**
+     * @brief 在当前分层上求阻塞流
+     */
+    double blockingFlow();
+
+    int m_nodeCount = 0;
+    std::vector<PendingEdge> m_pending;    ///< 追加的边
+    std::vector<int> m_offsets;            ///< 节点 -> 弧 偏移（nodeCount + 3）
+    std::vector<int> m_arcTo;              ///< 弧终点
+    std::vector<float> m_arcCapacity;      ///< 弧残量
+    std::vector<int> m_arcReverse;         ///< 反向弧下标
+    std::vector<int> m_level;              ///< BFS 层号（-1 表示不可达）
+    std::vector<int> m_cursor;             ///< 每个节点下一条待尝试的弧
+    std::vector<int> m_queue;              ///< BFS 队列
+    std::vector<int> m_path;               ///< 阻塞流的当前路径（弧下标）
+};
+
+#endif // MAXFLOWGRAPH_H
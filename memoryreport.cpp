@@ -0,0 +1,90 @@
+/**
+ * @file memoryreport.cpp
+ * @brief MemoryReport 内存占用报告的实现
+ */
+
+#include "memoryreport.h"
+
+#include <QStringList>
+
+namespace {
+
+QString formatBytes(size_t bytes)
+{
+    if (bytes >= 1024 * 1024) {
+        return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+} // namespace
+
+void MemoryReport::add(const QString& name, size_t bytes, bool onDemand)
+{
+    for (Entry& entry : m_entries) {
+        if (entry.name == name) {
+            entry.bytes += bytes;
+            return;
+        }
+    }
+    Entry entry;
+    entry.name = name;
+    entry.bytes = bytes;
+    entry.onDemand = onDemand;
+    m_entries.push_back(entry);
+}
+
+void MemoryReport::merge(const MemoryReport& other)
+{
+    for (const Entry& entry : other.m_entries) {
+        add(entry.name, entry.bytes, entry.onDemand);
+    }
+    m_cellCount += other.m_cellCount;
+}
+
+size_t MemoryReport::residentBytes() const
+{
+    size_t bytes = 0;
+    for (const Entry& entry : m_entries) {
+        bytes += entry.onDemand ? 0 : entry.bytes;
+    }
+    return bytes;
+}
+
+size_t MemoryReport::onDemandBytes() const
+{
+    size_t bytes = 0;
+    for (const Entry& entry : m_entries) {
+        bytes += entry.onDemand ? entry.bytes : 0;
+    }
+    return bytes;
+}
+
+double MemoryReport::residentBytesPerCell() const
+{
+    return m_cellCount > 0 ? static_cast<double>(residentBytes()) / m_cellCount : 0.0;
+}
+
+QString MemoryReport::toText() const
+{
+    const double cells = m_cellCount > 0 ? static_cast<double>(m_cellCount) : 1.0;
+    auto line = [cells](const QString& name, size_t bytes) {
+        return QString("%1 %2 %3 B/三角形")
+            .arg(name, -16)
+            .arg(formatBytes(bytes), 10)
+            .arg(bytes / cells, 7, 'f', 1);
+    };
+
+    QStringList lines;
+    lines << QString("%1 个三角形").arg(m_cellCount);
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool onDemand = pass == 1;
+        for (const Entry& entry : m_entries) {
+            if (entry.onDemand == onDemand) {
+                lines << line(entry.name, entry.bytes);
+            }
+        }
+        lines << line(onDemand ? "按需合计" : "常驻合计", onDemand ? onDemandBytes() : residentBytes());
+    }
+    return lines.join("\n");
+}
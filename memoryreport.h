@@ -0,0 +1,81 @@
+/**
+ * @file memoryreport.h
+ * @brief 内存占用报告（按数据结构分项的字节数和每三角形开销）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 内存占用报告
+ *
+ * 常驻项是加载后一直存在的结构（网格、链接、标签、渲染用的副本），
+ * 按需项是编辑时才构建、可随时释放的缓存（CSR 邻接、算法缓冲区、撤销历史）。
+ * 每三角形预算只约束常驻项。
+ */
+class MemoryReport {
+public:
+    /**
+     * @brief 一项数据结构
+     */
+    struct Entry {
+        QString name;          ///< 结构名称
+        size_t bytes = 0;      ///< 字节数
+        bool onDemand = false; ///< 是否为按需构建的缓存
+    };
+
+    /**
+     * @brief 添加一项（同名的项累加）
+     */
+    void add(const QString& name, size_t bytes, bool onDemand = false);
+
+    /**
+     * @brief 合并另一份报告（同名的项累加，单元数相加）
+     */
+    void merge(const MemoryReport& other);
+
+    void setCellCount(int64_t cellCount) { m_cellCount = cellCount; }
+    int64_t cellCount() const { return m_cellCount; }
+
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    /**
+     * @brief 常驻项合计（字节）
+     */
+    size_t residentBytes() const;
+
+    /**
+     * @brief 按需项合计（字节）
+     */
+    size_t onDemandBytes() const;
+
+    /**
+     * @brief 常驻项的每三角形字节数（没有单元时为0）
+     */
+    double residentBytesPerCell() const;
+
+    /**
+     * @brief 常驻项是否在每三角形预算之内
+     * @param bytesPerCell 预算（字节/三角形）
+     */
+    bool withinBudget(double bytesPerCell) const { return residentBytesPerCell() <= bytesPerCell; }
+
+    /**
+     * @brief 格式化为文本表格（每项的字节数和每三角形字节数）
+     */
+    QString toText() const;
+
+private:
+    std::vector<Entry> m_entries;
+    int64_t m_cellCount = 0;
+};
+
+#endif // MEMORYREPORT_H
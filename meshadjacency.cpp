@@ -0,0 +1,263 @@
+/**
+ * @file meshadjacency.cpp
+ * @brief MeshAdjacency 网格邻接关系的实现
+ */
+
+#include "meshadjacency.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+namespace {
+
+/**
+ * @brief 遍历单元的边（线段一条边，多边形首尾相接）
+ */
+template <typename Visit>
+void forEachEdge(vtkIdType npts, const vtkIdType* pts, Visit&& visit)
+{
+    if (npts == 2) {
+        visit(static_cast<int>(pts[0]), static_cast<int>(pts[1]));
+    } else if (npts >= 3) {
+        for (vtkIdType i = 0; i < npts; ++i) {
+            visit(static_cast<int>(pts[i]), static_cast<int>(pts[(i + 1) % npts]));
+        }
+    }
+}
+
+} // namespace
+
+void MeshAdjacency::clear()
+{
+    m_cellCount = 0;
+    std::vector<int>().swap(m_vertexCellOffsets);
+    std::vector<int>().swap(m_vertexCells);
+    std::vector<int>().swap(m_neighborOffsets);
+    std::vector<int>().swap(m_neighbors);
+    std::vector<float>().swap(m_edgeLengths);
+    std::vector<int>().swap(m_cellNeighborOffsets);
+    std::vector<int>().swap(m_cellNeighbors);
+    std::vector<float>().swap(m_cellNormals);
+    std::vector<float>().swap(m_cellCentroids);
+    std::vector<float>().swap(m_sharedEdgeLengths);
+}
+
+void MeshAdjacency::build(vtkPolyData* polyData)
+{
+    clear();
+    if (!polyData) {
+        return;
+    }
+
+    const int pointCount = static_cast<int>(polyData->GetNumberOfPoints());
+    m_cellCount = static_cast<int>(polyData->GetNumberOfCells());
+
+    // 第一遍：统计每个顶点的单元数和边数（边会重复，稍后去重）
+    std::vector<int> cellDegree(pointCount + 1, 0);
+    std::vector<int> edgeDegree(pointCount + 1, 0);
+
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+        polyData->GetCellPoints(cellId, npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i) {
+            ++cellDegree[pts[i] + 1];
+        }
+        forEachEdge(npts, pts, [&edgeDegree](int a, int b) {
+            ++edgeDegree[a + 1];
+            ++edgeDegree[b + 1];
+        });
+    }
+
+    for (int v = 0; v < pointCount; ++v) {
+        cellDegree[v + 1] += cellDegree[v];
+        edgeDegree[v + 1] += edgeDegree[v];
+    }
+
+    // 第二遍：填充
+    m_vertexCellOffsets = cellDegree;
+    m_vertexCells.resize(cellDegree[pointCount]);
+    std::vector<int> rawNeighbors(edgeDegree[pointCount]);
+    std::vector<int> cellCursor(cellDegree.begin(), cellDegree.end() - 1);
+    std::vector<int> edgeCursor(edgeDegree.begin(), edgeDegree.end() - 1);
+
+    for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+        polyData->GetCellPoints(cellId, npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i) {
+            m_vertexCells[cellCursor[pts[i]]++] = cellId;
+        }
+        forEachEdge(npts, pts, [&rawNeighbors, &edgeCursor](int a, int b) {
+            rawNeighbors[edgeCursor[a]++] = b;
+            rawNeighbors[edgeCursor[b]++] = a;
+        });
+    }
+
+    // 相邻顶点去重并计算边长
+    m_neighborOffsets.assign(pointCount + 1, 0);
+    m_neighbors.reserve(rawNeighbors.size() / 2 + 1);
+    m_edgeLengths.reserve(rawNeighbors.size() / 2 + 1);
+    double p[3], q[3];
+    for (int v = 0; v < pointCount; ++v) {
+        auto begin = rawNeighbors.begin() + edgeDegree[v];
+        auto end = rawNeighbors.begin() + edgeDegree[v + 1];
+        std::sort(begin, end);
+        end = std::unique(begin, end);
+
+        polyData->GetPoint(v, p);
+        for (auto it = begin; it != end; ++it) {
+            polyData->GetPoint(*it, q);
+            const double dx = p[0] - q[0];
+            const double dy = p[1] - q[1];
+            const double dz = p[2] - q[2];
+            m_neighbors.push_back(*it);
+            m_edgeLengths.push_back(static_cast<float>(std::sqrt(dx * dx + dy * dy + dz * dz)));
+        }
+        m_neighborOffsets[v + 1] = static_cast<int>(m_neighbors.size());
+    }
+    m_neighbors.shrink_to_fit();
+    m_edgeLengths.shrink_to_fit();
+
+    // 共边单元：两个端点的单元列表（按单元ID有序）求交
+    m_cellNeighborOffsets.assign(m_cellCount + 1, 0);
+    m_cellNeighbors.reserve(3 * static_cast<size_t>(m_cellCount));
+    for (int cellId = 0; cellId < m_cellCount; ++cellId) {
+        polyData->GetCellPoints(cellId, npts, pts);
+        const size_t first = m_cellNeighbors.size();
+        forEachEdge(npts, pts, [this, cellId, first](int a, int b) {
+            const int* ia = vertexCellsBegin(a);
+            const int* ea = vertexCellsEnd(a);
+            const int* ib = vertexCellsBegin(b);
+            const int* eb = vertexCellsEnd(b);
+            while (ia != ea && ib != eb) {
+                if (*ia < *ib) {
+                    ++ia;
+                } else if (*ib < *ia) {
+                    ++ib;
+                } else {
+                    if (*ia != cellId
+                        && std::find(m_cellNeighbors.begin() + first, m_cellNeighbors.end(), *ia)
+                            == m_cellNeighbors.end()) {
+                        m_cellNeighbors.push_back(*ia);
+                    }
+                    ++ia;
+                    ++ib;
+                }
+            }
+        });
+        m_cellNeighborOffsets[cellId + 1] = static_cast<int>(m_cellNeighbors.size());
+    }
+    m_cellNeighbors.shrink_to_fit();
+}
+
+void MeshAdjacency::buildCellGeometry(vtkPolyData* polyData)
+{
+    if (!polyData) {
+        return;
+    }
+
+    const vtkIdType cellCount = polyData->GetNumberOfCells();
+    m_cellNormals.assign(3 * static_cast<size_t>(cellCount), 0.0f);
+    m_cellCentroids.assign(3 * static_cast<size_t>(cellCount), 0.0f);
+    m_sharedEdgeLengths.assign(m_cellNeighbors.size(), 0.0f);
+
+    vtkCellArray* polys = polyData->GetPolys();
+    vtkPoints* points = polyData->GetPoints();
+    if (!polys || !points) {
+        return;
+    }
+
+    // 单元编号依次为 verts、lines、polys、strips，只有多边形有法向
+    const vtkIdType polyOffset = polyData->GetNumberOfVerts() + polyData->GetNumberOfLines();
+    ParallelUtils::forChunks(0, polys->GetNumberOfCells(), ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int) {
+            // 每个线程使用独立的迭代器（vtkCellArray 的随机访问不是线程安全的）
+            vtkSmartPointer<vtkCellArrayIterator> iter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            vtkSmartPointer<vtkCellArrayIterator> neighborIter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            for (vtkIdType i = begin; i < end; ++i) {
+                vtkIdType cellPointCount;
+                const vtkIdType* cellPoints;
+                iter->GetCellAtId(i, cellPointCount, cellPoints);
+                if (cellPointCount < 3) {
+                    continue;
+                }
+
+                // 公共边：本单元的边中两个端点都属于邻居的那一条
+                const int cell = static_cast<int>(polyOffset + i);
+                if (cell < m_cellCount) {
+                    for (int k = m_cellNeighborOffsets[cell]; k < m_cellNeighborOffsets[cell + 1]; ++k) {
+                        const vtkIdType neighborPoly = m_cellNeighbors[k] - polyOffset;
+                        if (neighborPoly < 0 || neighborPoly >= polys->GetNumberOfCells()) {
+                            continue;
+                        }
+                        vtkIdType neighborPointCount;
+                        const vtkIdType* neighborPoints;
+                        neighborIter->GetCellAtId(neighborPoly, neighborPointCount, neighborPoints);
+                        const vtkIdType* neighborEnd = neighborPoints + neighborPointCount;
+                        for (vtkIdType j = 0; j < cellPointCount; ++j) {
+                            const vtkIdType a = cellPoints[j];
+                            const vtkIdType b = cellPoints[(j + 1) % cellPointCount];
+                            if (std::find(neighborPoints, neighborEnd, a) != neighborEnd
+                                && std::find(neighborPoints, neighborEnd, b) != neighborEnd) {
+                                double pa[3], pb[3];
+                                points->GetPoint(a, pa);
+                                points->GetPoint(b, pb);
+                                m_sharedEdgeLengths[k] = static_cast<float>(std::sqrt(
+                                    (pa[0] - pb[0]) * (pa[0] - pb[0]) + (pa[1] - pb[1]) * (pa[1] - pb[1])
+                                    + (pa[2] - pb[2]) * (pa[2] - pb[2])));
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                double p0[3], prev[3], p[3];
+                double normal[3] = { 0.0, 0.0, 0.0 };
+                double centroid[3];
+                points->GetPoint(cellPoints[0], p0);
+                points->GetPoint(cellPoints[1], prev);
+                for (int k = 0; k < 3; ++k) {
+                    centroid[k] = p0[k] + prev[k];
+                }
+                for (vtkIdType j = 2; j < cellPointCount; ++j) {
+                    points->GetPoint(cellPoints[j], p);
+                    const double u[3] = { prev[0] - p0[0], prev[1] - p0[1], prev[2] - p0[2] };
+                    const double v[3] = { p[0] - p0[0], p[1] - p0[1], p[2] - p0[2] };
+                    normal[0] += u[1] * v[2] - u[2] * v[1];
+                    normal[1] += u[2] * v[0] - u[0] * v[2];
+                    normal[2] += u[0] * v[1] - u[1] * v[0];
+                    for (int k = 0; k < 3; ++k) {
+                        centroid[k] += p[k];
+                        prev[k] = p[k];
+                    }
+                }
+
+                const double length = std::sqrt(normal[0] * normal[0]
+                                                + normal[1] * normal[1]
+                                                + normal[2] * normal[2]);
+                const size_t base = 3 * static_cast<size_t>(polyOffset + i);
+                for (int k = 0; k < 3; ++k) {
+                    m_cellNormals[base + k] = length > 0.0
+                        ? static_cast<float>(normal[k] / length) : 0.0f;
+                    m_cellCentroids[base + k] = static_cast<float>(centroid[k] / cellPointCount);
+                }
+            }
+        });
+}
+
+size_t MeshAdjacency::memoryBytes() const
+{
+    return (m_vertexCellOffsets.capacity() + m_vertexCells.capacity()
+            + m_neighborOffsets.capacity() + m_neighbors.capacity()
+            + m_cellNeighborOffsets.capacity() + m_cellNeighbors.capacity()) * sizeof(int)
+        + (m_edgeLengths.capacity() + m_cellNormals.capacity()
+           + m_cellCentroids.capacity() + m_sharedEdgeLengths.capacity()) * sizeof(float);
+}
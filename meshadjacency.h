@@ -0,0 +1,98 @@
+/**
+ * @file meshadjacency.h
+ * @brief 压缩行存储（CSR）的网格邻接关系和面片几何
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+#include <cstddef>
+#include <vector>
+
+class vtkPolyData;
+
+/**
+ * @brief 网格邻接关系
+ *
+ * 用连续数组保存顶点到单元、顶点到相邻顶点（带边长）的映射，
+ * 区域算法在内层循环中只做数组下标访问，不经过 VTK 的虚函数和 vtkIdList。
+ * 由 MeshLabelCore 在第一次需要时构建，网格替换时失效。
+ */
+class MeshAdjacency {
+public:
+    /**
+     * @brief 从网格构建邻接关系（顶点 -> 单元、顶点 -> 顶点、单元 -> 共边单元）
+     * @param polyData 网格
+     */
+    void build(vtkPolyData* polyData);
+
+    /**
+     * @brief 并行计算每个单元的单位法向、质心和与共边单元的公共边长（区域生长、图割等使用）
+     * @param polyData 网格（与 build() 相同）
+     */
+    void buildCellGeometry(vtkPolyData* polyData);
+
+    /**
+     * @brief 释放所有数据
+     */
+    void clear();
+
+    /**
+     * @brief 是否已构建
+     */
+    bool isBuilt() const { return !m_vertexCellOffsets.empty(); }
+
+    /**
+     * @brief 顶点数量
+     */
+    int pointCount() const { return static_cast<int>(m_vertexCellOffsets.size()) - 1; }
+
+    /**
+     * @brief 单元数量
+     */
+    int cellCount() const { return m_cellCount; }
+
+    // ==================== 顶点 -> 单元 ====================
+    const int* vertexCellsBegin(int vertex) const { return m_vertexCells.data() + m_vertexCellOffsets[vertex]; }
+    const int* vertexCellsEnd(int vertex) const { return m_vertexCells.data() + m_vertexCellOffsets[vertex + 1]; }
+
+    // ==================== 顶点 -> 相邻顶点（沿网格边） ====================
+    int neighborBegin(int vertex) const { return m_neighborOffsets[vertex]; }
+    int neighborEnd(int vertex) const { return m_neighborOffsets[vertex + 1]; }
+    int neighbor(int index) const { return m_neighbors[index]; }
+    float edgeLength(int index) const { return m_edgeLengths[index]; }
+
+    // ==================== 单元 -> 共边单元 ====================
+    const int* cellNeighborsBegin(int cell) const { return m_cellNeighbors.data() + m_cellNeighborOffsets[cell]; }
+    const int* cellNeighborsEnd(int cell) const { return m_cellNeighbors.data() + m_cellNeighborOffsets[cell + 1]; }
+    int cellNeighborOffset(int cell) const { return m_cellNeighborOffsets[cell]; }
+
+    // ==================== 单元几何（buildCellGeometry 之后有效） ====================
+    bool hasCellGeometry() const { return !m_cellNormals.empty(); }
+    const float* cellNormal(int cell) const { return &m_cellNormals[3 * static_cast<size_t>(cell)]; }
+    const float* cellCentroid(int cell) const { return &m_cellCentroids[3 * static_cast<size_t>(cell)]; }
+    /// 与 cellNeighborsBegin(cell) 对齐的公共边长（下标为 cellNeighborOffset(cell) + i）
+    float sharedEdgeLength(int index) const { return m_sharedEdgeLengths[index]; }
+
+    /**
+     * @brief 占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+private:
+    int m_cellCount = 0;
+    std::vector<int> m_vertexCellOffsets;   ///< 顶点 -> 单元 偏移（pointCount + 1）
+    std::vector<int> m_vertexCells;         ///< 顶点 -> 单元 列表
+    std::vector<int> m_neighborOffsets;     ///< 顶点 -> 相邻顶点 偏移（pointCount + 1）
+    std::vector<int> m_neighbors;           ///< 相邻顶点列表
+    std::vector<float> m_edgeLengths;       ///< 与 m_neighbors 对应的边长
+    std::vector<int> m_cellNeighborOffsets; ///< 单元 -> 共边单元 偏移（cellCount + 1）
+    std::vector<int> m_cellNeighbors;       ///< 共边单元列表
+    std::vector<float> m_cellNormals;       ///< 单元单位法向（每单元3个）
+    std::vector<float> m_cellCentroids;     ///< 单元质心（每单元3个）
+    std::vector<float> m_sharedEdgeLengths; ///< 与 m_cellNeighbors 对应的公共边长
+};
+
+#endif // MESHADJACENCY_H
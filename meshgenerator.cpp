@@ -0,0 +1,460 @@
+/**
+ * @file meshgenerator.cpp
+ * @brief MeshGenerator 测试网格生成器的实现
+ */
+
+#include "meshgenerator.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkSTLWriter.h>
+#include <vtkXMLPolyDataWriter.h>
+
+namespace {
+
+/**
+ * @brief 生成过程中的三角形缓冲区
+ */
+struct MeshBuffers {
+    std::vector<float> points;             ///< 顶点坐标 (x, y, z)
+    std::vector<vtkIdType> connectivity;   ///< 三角形顶点索引（每 3 个一组）
+
+    vtkIdType pointCount() const { return static_cast<vtkIdType>(points.size() / 3); }
+};
+
+/**
+ * @brief 与平台无关的 [0, 1) 均匀随机数（std 分布的结果依赖实现，不可跨平台复现）
+ */
+double uniform(std::mt19937& rng)
+{
+    return rng() / 4294967296.0;
+}
+
+/**
+ * @brief 将缓冲区转换为 vtkPolyData（转换后释放缓冲区）
+ */
+vtkSmartPointer<vtkPolyData> toPolyData(MeshBuffers& buffers)
+{
+    const vtkIdType pointCount = buffers.pointCount();
+    const vtkIdType cellCount = static_cast<vtkIdType>(buffers.connectivity.size() / 3);
+
+    vtkNew<vtkFloatArray> coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(pointCount);
+    std::copy(buffers.points.begin(), buffers.points.end(), coords->GetPointer(0));
+    std::vector<float>().swap(buffers.points);
+
+    vtkNew<vtkPoints> points;
+    points->SetData(coords);
+
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfValues(cellCount + 1);
+    vtkIdType* offsetData = offsets->GetPointer(0);
+    for (vtkIdType i = 0; i <= cellCount; ++i) {
+        offsetData[i] = 3 * i;
+    }
+
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(static_cast<vtkIdType>(buffers.connectivity.size()));
+    std::copy(buffers.connectivity.begin(), buffers.connectivity.end(),
+              connectivity->GetPointer(0));
+    std::vector<vtkIdType>().swap(buffers.connectivity);
+
+    vtkNew<vtkCellArray> polys;
+    polys->SetData(offsets, connectivity);
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+    return polyData;
+}
+
+/**
+ * @brief 向缓冲区追加一个细分二十面体球
+ *
+ * 每个面按 frequency 细分为 frequency^2 个三角形，
+ * 棱和角上的顶点在相邻面之间共享（闭合流形）。
+ */
+void appendIcosphere(MeshBuffers& buffers, int frequency, double radius, const double center[3])
+{
+    const double t = (1.0 + std::sqrt(5.0)) / 2.0;
+    static const double baseVertices[12][3] = {
+        { -1,  t,  0 }, {  1,  t,  0 }, { -1, -t,  0 }, {  1, -t,  0 },
+        {  0, -1,  t }, {  0,  1,  t }, {  0, -1, -t }, {  0,  1, -t },
+        {  t,  0, -1 }, {  t,  0,  1 }, { -t,  0, -1 }, { -t,  0,  1 }
+    };
+    static const int baseFaces[20][3] = {
+        { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+        { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+        { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+        { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+    };
+
+    const int f = std::max(1, frequency);
+
+    // 棱编号：(较小顶点, 较大顶点) -> 棱索引
+    std::map<std::pair<int, int>, int> edgeIndex;
+    for (const auto& face : baseFaces) {
+        for (int k = 0; k < 3; ++k) {
+            int a = face[k];
+            int b = face[(k + 1) % 3];
+            auto key = std::make_pair(std::min(a, b), std::max(a, b));
+            if (edgeIndex.find(key) == edgeIndex.end()) {
+                int index = static_cast<int>(edgeIndex.size());
+                edgeIndex[key] = index;
+            }
+        }
+    }
+
+    const vtkIdType base = buffers.pointCount();
+    const vtkIdType edgeBase = base + 12;
+    const vtkIdType edgeStride = f - 1;
+    const vtkIdType faceBase = edgeBase + 30 * edgeStride;
+    const vtkIdType faceStride = static_cast<vtkIdType>(f - 1) * (f - 2) / 2;
+    const vtkIdType totalPoints = faceBase + 20 * faceStride;
+
+    buffers.points.resize(static_cast<size_t>(totalPoints) * 3);
+    buffers.connectivity.reserve(buffers.connectivity.size()
+                                 + static_cast<size_t>(20) * f * f * 3);
+
+    auto setPoint = [&](vtkIdType id, const double p[3]) {
+        double len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        float* dst = &buffers.points[static_cast<size_t>(id) * 3];
+        dst[0] = static_cast<float>(center[0] + radius * p[0] / len);
+        dst[1] = static_cast<float>(center[1] + radius * p[1] / len);
+        dst[2] = static_cast<float>(center[2] + radius * p[2] / len);
+    };
+
+    // 棱上第 s 个点（从 from 端数起，1 <= s <= f-1）的全局索引
+    struct EdgeRef {
+        int edge;
+        bool forward;
+    };
+    auto edgeRef = [&](int from, int to) -> EdgeRef {
+        return { edgeIndex[std::make_pair(std::min(from, to), std::max(from, to))], from < to };
+    };
+    auto edgePoint = [&](const EdgeRef& ref, int s) -> vtkIdType {
+        int offset = ref.forward ? s : f - s;
+        return edgeBase + ref.edge * edgeStride + (offset - 1);
+    };
+
+    for (int faceId = 0; faceId < 20; ++faceId) {
+        const int a = baseFaces[faceId][0];
+        const int b = baseFaces[faceId][1];
+        const int c = baseFaces[faceId][2];
+        const double* pa = baseVertices[a];
+        const double* pb = baseVertices[b];
+        const double* pc = baseVertices[c];
+        const EdgeRef ab = edgeRef(a, b);
+        const EdgeRef ac = edgeRef(a, c);
+        const EdgeRef bc = edgeRef(b, c);
+
+        // 面内重心坐标网格 (i, j) -> 全局顶点索引
+        auto pointId = [&](int i, int j) -> vtkIdType {
+            if (i == 0 && j == 0) return base + a;
+            if (i == f) return base + b;
+            if (j == f) return base + c;
+            if (j == 0) return edgePoint(ab, i);
+            if (i == 0) return edgePoint(ac, j);
+            if (i + j == f) return edgePoint(bc, j);
+            vtkIdType local = static_cast<vtkIdType>(j - 1) * (f - 1)
+                              - static_cast<vtkIdType>(j - 1) * j / 2 + (i - 1);
+            return faceBase + faceId * faceStride + local;
+        };
+
+        for (int j = 0; j <= f; ++j) {
+            for (int i = 0; i + j <= f; ++i) {
+                double p[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = pa[k] + (pb[k] - pa[k]) * i / f + (pc[k] - pa[k]) * j / f;
+                }
+                // 共享顶点会被重复写入相同的值
+                setPoint(pointId(i, j), p);
+            }
+        }
+
+        for (int j = 0; j < f; ++j) {
+            for (int i = 0; i + j < f; ++i) {
+                buffers.connectivity.push_back(pointId(i, j));
+                buffers.connectivity.push_back(pointId(i + 1, j));
+                buffers.connectivity.push_back(pointId(i, j + 1));
+                if (i + j < f - 1) {
+                    buffers.connectivity.push_back(pointId(i + 1, j));
+                    buffers.connectivity.push_back(pointId(i + 1, j + 1));
+                    buffers.connectivity.push_back(pointId(i, j + 1));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 整数格点哈希噪声 [0, 1)
+ */
+double latticeNoise(int x, int y, unsigned int seed)
+{
+    uint32_t h = static_cast<uint32_t>(x) * 374761393u
+                 + static_cast<uint32_t>(y) * 668265263u
+                 + seed * 2246822519u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return h / 4294967296.0;
+}
+
+/**
+ * @brief 平滑插值的值噪声 [0, 1)
+ */
+double valueNoise(double x, double y, unsigned int seed)
+{
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    double fx = x - x0;
+    double fy = y - y0;
+    fx = fx * fx * (3.0 - 2.0 * fx);
+    fy = fy * fy * (3.0 - 2.0 * fy);
+
+    const double n00 = latticeNoise(x0, y0, seed);
+    const double n10 = latticeNoise(x0 + 1, y0, seed);
+    const double n01 = latticeNoise(x0, y0 + 1, seed);
+    const double n11 = latticeNoise(x0 + 1, y0 + 1, seed);
+
+    const double nx0 = n00 + (n10 - n00) * fx;
+    const double nx1 = n01 + (n11 - n01) * fx;
+    return nx0 + (nx1 - nx0) * fy;
+}
+
+} // namespace
+
+// ==================== MeshGenerator 实现 ====================
+
+vtkSmartPointer<vtkPolyData> MeshGenerator::generate(const MeshGeneratorOptions& options)
+{
+    const long long target = std::min(std::max(options.targetTriangles, MIN_TRIANGLES),
+                                      MAX_TRIANGLES);
+
+    vtkSmartPointer<vtkPolyData> polyData;
+    switch (options.shape) {
+    case MeshShape::Icosphere:
+        polyData = icosphere(std::max(1, static_cast<int>(std::lround(std::sqrt(target / 20.0)))));
+        break;
+    case MeshShape::Terrain:
+        polyData = terrain(std::max(1, static_cast<int>(std::lround(std::sqrt(target / 2.0)))),
+                           options.seed);
+        break;
+    case MeshShape::MultiShell:
+        polyData = multiShell(target, options.seed);
+        break;
+    }
+
+    if (polyData && options.labelCount > 0) {
+        assignLabels(polyData, options.labelCount, options.seed);
+    }
+
+    qDebug() << "Generated mesh:" << polyData->GetNumberOfPoints() << "points,"
+             << polyData->GetNumberOfCells() << "cells";
+    return polyData;
+}
+
+vtkSmartPointer<vtkPolyData> MeshGenerator::icosphere(int frequency, double radius)
+{
+    MeshBuffers buffers;
+    const double center[3] = { 0.0, 0.0, 0.0 };
+    appendIcosphere(buffers, frequency, radius, center);
+    return toPolyData(buffers);
+}
+
+vtkSmartPointer<vtkPolyData> MeshGenerator::terrain(int resolution, unsigned int seed)
+{
+    const int n = std::max(1, resolution);
+    const double size = 100.0;       // 地形边长
+    const double amplitude = 15.0;   // 起伏高度
+
+    MeshBuffers buffers;
+    buffers.points.resize(static_cast<size_t>(n + 1) * (n + 1) * 3);
+    for (int y = 0; y <= n; ++y) {
+        for (int x = 0; x <= n; ++x) {
+            const double u = static_cast<double>(x) / n;
+            const double v = static_cast<double>(y) / n;
+
+            // 4 个倍频程的分形噪声
+            double height = 0.0;
+            double frequency = 4.0;
+            double weight = 0.5;
+            for (int octave = 0; octave < 4; ++octave) {
+                height += weight * valueNoise(u * frequency, v * frequency, seed + octave);
+                frequency *= 2.0;
+                weight *= 0.5;
+            }
+
+            float* dst = &buffers.points[(static_cast<size_t>(y) * (n + 1) + x) * 3];
+            dst[0] = static_cast<float>(u * size);
+            dst[1] = static_cast<float>(v * size);
+            dst[2] = static_cast<float>(height * amplitude);
+        }
+    }
+
+    buffers.connectivity.reserve(static_cast<size_t>(n) * n * 6);
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            vtkIdType p0 = static_cast<vtkIdType>(y) * (n + 1) + x;
+            vtkIdType p1 = p0 + 1;
+            vtkIdType p2 = p0 + (n + 1);
+            vtkIdType p3 = p2 + 1;
+            buffers.connectivity.insert(buffers.connectivity.end(), { p0, p1, p3, p0, p3, p2 });
+        }
+    }
+
+    return toPolyData(buffers);
+}
+
+vtkSmartPointer<vtkPolyData> MeshGenerator::multiShell(long long targetTriangles, unsigned int seed)
+{
+    const double shellRadii[3] = { 50.0, 35.0, 20.0 };
+    const int fragmentCount = 24;
+    const double fragmentShare = 0.05;   // 碎片占总三角形数的比例
+
+    std::mt19937 rng(seed);
+    MeshBuffers buffers;
+
+    // 球壳按面积分配三角形
+    double areaSum = 0.0;
+    for (double r : shellRadii) {
+        areaSum += r * r;
+    }
+    const double shellBudget = targetTriangles * (1.0 - fragmentShare);
+    const double center[3] = { 0.0, 0.0, 0.0 };
+    for (double r : shellRadii) {
+        double budget = shellBudget * (r * r) / areaSum;
+        int frequency = std::max(1, static_cast<int>(std::lround(std::sqrt(budget / 20.0))));
+        appendIcosphere(buffers, frequency, r, center);
+    }
+
+    // 外层球壳附近漂浮的小碎片
+    const double fragmentBudget = targetTriangles * fragmentShare / fragmentCount;
+    const int fragmentFrequency = std::max(1, static_cast<int>(std::lround(std::sqrt(fragmentBudget / 20.0))));
+    for (int i = 0; i < fragmentCount; ++i) {
+        const double theta = 2.0 * vtkMath::Pi() * uniform(rng);
+        const double phi = std::acos(2.0 * uniform(rng) - 1.0);
+        const double distance = 55.0 + 15.0 * uniform(rng);
+        const double fragmentCenter[3] = {
+            distance * std::sin(phi) * std::cos(theta),
+            distance * std::sin(phi) * std::sin(theta),
+            distance * std::cos(phi)
+        };
+        appendIcosphere(buffers, fragmentFrequency, 1.0 + 2.0 * uniform(rng), fragmentCenter);
+    }
+
+    return toPolyData(buffers);
+}
+
+void MeshGenerator::assignLabels(vtkPolyData* polyData, int labelCount, unsigned int seed)
+{
+    if (!polyData || labelCount <= 0 || polyData->GetNumberOfCells() == 0) {
+        return;
+    }
+
+    vtkCellArray* polys = polyData->GetPolys();
+    vtkPoints* points = polyData->GetPoints();
+    const vtkIdType cellCount = polys->GetNumberOfCells();
+
+    // 计算单元质心
+    std::vector<float> centroids(static_cast<size_t>(cellCount) * 3);
+    auto iter = vtk::TakeSmartPointer(polys->NewIterator());
+    vtkIdType cellId = 0;
+    for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell(), ++cellId) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        iter->GetCurrentCell(npts, pts);
+
+        double c[3] = { 0.0, 0.0, 0.0 };
+        for (vtkIdType k = 0; k < npts; ++k) {
+            double p[3];
+            points->GetPoint(pts[k], p);
+            c[0] += p[0];
+            c[1] += p[1];
+            c[2] += p[2];
+        }
+        for (int k = 0; k < 3; ++k) {
+            centroids[static_cast<size_t>(cellId) * 3 + k] = static_cast<float>(c[k] / std::max<vtkIdType>(npts, 1));
+        }
+    }
+
+    // 随机选取种子单元
+    std::mt19937 rng(seed);
+    std::vector<std::array<float, 3>> seeds(labelCount);
+    for (auto& s : seeds) {
+        vtkIdType pick = static_cast<vtkIdType>(uniform(rng) * cellCount);
+        for (int k = 0; k < 3; ++k) {
+            s[k] = centroids[static_cast<size_t>(pick) * 3 + k];
+        }
+    }
+
+    vtkNew<vtkFloatArray> labels;
+    labels->SetName("Label");
+    labels->SetNumberOfTuples(cellCount);
+    float* labelData = labels->GetPointer(0);
+
+    for (vtkIdType i = 0; i < cellCount; ++i) {
+        const float* c = &centroids[static_cast<size_t>(i) * 3];
+        int best = 0;
+        float bestDist = std::numeric_limits<float>::max();
+        for (int s = 0; s < labelCount; ++s) {
+            float dx = c[0] - seeds[s][0];
+            float dy = c[1] - seeds[s][1];
+            float dz = c[2] - seeds[s][2];
+            float d = dx * dx + dy * dy + dz * dz;
+            if (d < bestDist) {
+                bestDist = d;
+                best = s;
+            }
+        }
+        labelData[i] = static_cast<float>(best);
+    }
+
+    polyData->GetCellData()->SetScalars(labels);
+}
+
+bool MeshGenerator::write(vtkPolyData* polyData, const QString& filename)
+{
+    if (!polyData) {
+        return false;
+    }
+
+    int result = 0;
+    if (filename.endsWith(".stl", Qt::CaseInsensitive)) {
+        vtkNew<vtkSTLWriter> writer;
+        writer->SetInputData(polyData);
+        writer->SetFileName(filename.toLocal8Bit().data());
+        writer->SetFileTypeToBinary();
+        result = writer->Write();
+    } else if (filename.endsWith(".vtp", Qt::CaseInsensitive)) {
+        vtkNew<vtkXMLPolyDataWriter> writer;
+        writer->SetInputData(polyData);
+        writer->SetFileName(filename.toLocal8Bit().data());
+        writer->SetDataModeToBinary();
+        result = writer->Write();
+    } else {
+        qWarning() << "Unsupported mesh file extension:" << filename;
+        return false;
+    }
+
+    return result != 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file meshgenerator.h
+ * @brief 程序生成的测试网格（用于可复现的性能测试）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef MESHGENERATOR_H
+#define MESHGENERATOR_H
+
+#include <QString>
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+/**
+ * @brief 生成网格的形状
+ */
+enum class MeshShape {
+    Icosphere = 0,   ///< 细分二十面体球（闭合、规则拓扑）
+    Terrain = 1,     ///< 带噪声的高度场（开放边界、起伏表面）
+    MultiShell = 2   ///< 多层同心球壳加离散碎片（多连通分量）
+};
+
+/**
+ * @brief 网格生成参数
+ */
+struct MeshGeneratorOptions {
+    MeshShape shape = MeshShape::Icosphere;  ///< 形状
+    long long targetTriangles = 100000;      ///< 目标三角形数量（实际数量会接近该值）
+    unsigned int seed = 1;                   ///< 随机种子（相同种子生成相同网格）
+    int labelCount = 0;                      ///< 预分配的标签数量（0 表示不生成标签）
+};
+
+/**
+ * @brief 测试网格生成器
+ *
+ * 生成规模可控（1千 ~ 2千万三角形）、可按种子复现的网格，
+ * 可选地按空间区域预先分配标签，并写出为 STL/VTP。
+ * 不依赖渲染模块，可用于基准测试和命令行工具。
+ */
+class MeshGenerator {
+public:
+    static constexpr long long MIN_TRIANGLES = 1000;         ///< 最小三角形数量
+    static constexpr long long MAX_TRIANGLES = 20000000;     ///< 最大三角形数量
+
+    /**
+     * @brief 按参数生成网格
+     * @param options 生成参数
+     * @return 生成的网格（若 labelCount > 0 则带 "Label" 单元标量）
+     */
+    static vtkSmartPointer<vtkPolyData> generate(const MeshGeneratorOptions& options);
+
+    /**
+     * @brief 生成细分二十面体球
+     * @param frequency 每条棱的细分次数（三角形数量为 20 * frequency^2）
+     * @param radius 球半径
+     */
+    static vtkSmartPointer<vtkPolyData> icosphere(int frequency, double radius = 50.0);
+
+    /**
+     * @brief 生成带噪声的地形高度场
+     * @param resolution 每个方向的格子数（三角形数量为 2 * resolution^2）
+     * @param seed 随机种子
+     */
+    static vtkSmartPointer<vtkPolyData> terrain(int resolution, unsigned int seed);
+
+    /**
+     * @brief 生成多层同心球壳加离散碎片
+     * @param targetTriangles 目标三角形数量
+     * @param seed 随机种子
+     */
+    static vtkSmartPointer<vtkPolyData> multiShell(long long targetTriangles, unsigned int seed);
+
+    /**
+     * @brief 按空间区域分配标签（以随机选取的单元为种子的 Voronoi 划分）
+     * @param polyData 网格
+     * @param labelCount 标签数量（标签值为 0 ~ labelCount-1）
+     * @param seed 随机种子
+     */
+    static void assignLabels(vtkPolyData* polyData, int labelCount, unsigned int seed);
+
+    /**
+     * @brief 写出网格文件（按扩展名选择 STL 或 VTP）
+     * @param polyData 网格
+     * @param filename 文件路径（.stl 或 .vtp）
+     * @return 成功返回true
+     */
+    static bool write(vtkPolyData* polyData, const QString& filename);
+};
+
+#endif // MESHGENERATOR_H
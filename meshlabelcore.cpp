@@ -0,0 +1,1950 @@
+/**
+ * @file meshlabelcore.cpp
+ * @brief MeshLabelCore 无界面核心类的实现
+ */
+
+#include "meshlabelcore.h"
+#include "latencyprofiler.h"
+#include "parallelutils.h"
+#include "pointlabels.h"
+#include "trianglebvh.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <QDateTime>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+#include <vtkSTLReader.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkCellData.h>
+#include <vtkCellArray.h>
+#include <vtkFieldData.h>
+#include <vtkPointData.h>
+#include <vtkIdList.h>
+#include <vtkCell.h>
+#include <vtkPoints.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkAbstractCellLinks.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkStaticPointLocator.h>
+#include <vtkUnsignedCharArray.h>
+
+// ==================== PaintCommand 实现 ====================
+
+PaintCommand::PaintCommand(vtkSmartPointer<vtkPolyData> polyData,
+                           const std::vector<int>& cellIds,
+                           int newLabel,
+                           LabelStatistics* statistics)
+    : m_polyData(polyData)
+    , m_newLabel(newLabel)
+    , m_statistics(statistics)
+{
+    append(cellIds);
+}
+
+void PaintCommand::append(const std::vector<int>& cellIds)
+{
+    // 保存旧标签值
+    m_cellIds.reserve(m_cellIds.size() + cellIds.size());
+    m_oldLabels.reserve(m_oldLabels.size() + cellIds.size());
+    for (int cellId : cellIds) {
+        int oldLabel = static_cast<int>(
+            m_polyData->GetCellData()->GetScalars()->GetTuple1(cellId));
+        m_cellIds.push_back(cellId);
+        m_oldLabels.push_back(oldLabel);
+    }
+}
+
+void PaintCommand::execute()
+{
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    for (size_t i = 0; i < m_cellIds.size(); ++i) {
+        if (m_statistics) {
+            m_statistics->moveCell(m_cellIds[i],
+                                   static_cast<int>(labels->GetTuple1(m_cellIds[i])),
+                                   m_newLabel);
+        }
+        labels->SetTuple1(m_cellIds[i], m_newLabel);
+    }
+    labels->Modified();
+    m_polyData->GetCellData()->Modified();
+}
+
+void PaintCommand::undo()
+{
+    // 逆序恢复，保证同一单元多次出现时恢复到最早的值
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    for (size_t i = m_cellIds.size(); i-- > 0;) {
+        if (m_statistics) {
+            m_statistics->moveCell(m_cellIds[i],
+                                   static_cast<int>(labels->GetTuple1(m_cellIds[i])),
+                                   m_oldLabels[i]);
+        }
+        labels->SetTuple1(m_cellIds[i], m_oldLabels[i]);
+    }
+    labels->Modified();
+    m_polyData->GetCellData()->Modified();
+}
+
+QString PaintCommand::description() const
+{
+    return QString("Paint %1 cells with label %2")
+        .arg(m_cellIds.size())
+        .arg(m_newLabel);
+}
+
+size_t PaintCommand::memoryBytes() const
+{
+    return (m_cellIds.capacity() + m_oldLabels.capacity()) * sizeof(int);
+}
+
+// ==================== FillCommand 实现 ====================
+
+FillCommand::FillCommand(vtkSmartPointer<vtkPolyData> polyData,
+                         std::vector<int>&& cellIds,
+                         int oldLabel,
+                         int newLabel,
+                         LabelStatistics* statistics)
+    : m_polyData(polyData)
+    , m_cellIds(std::move(cellIds))
+    , m_oldLabel(oldLabel)
+    , m_newLabel(newLabel)
+    , m_statistics(statistics)
+{
+    m_cellIds.shrink_to_fit();
+}
+
+void FillCommand::execute()
+{
+    apply(m_oldLabel, m_newLabel);
+}
+
+void FillCommand::undo()
+{
+    apply(m_newLabel, m_oldLabel);
+}
+
+void FillCommand::apply(int fromLabel, int toLabel)
+{
+    ML_PROFILE_SCOPE(ProfileStage::ScalarUpdate);
+
+    if (m_statistics) {
+        m_statistics->moveCells(m_cellIds, fromLabel, toLabel);
+    }
+
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    const LabelView view(labels);
+    if (view.isValid()) {
+        // 各单元互不相同，可以直接并行写入
+        ParallelUtils::forChunks(0, static_cast<int64_t>(m_cellIds.size()),
+                                 ParallelUtils::DEFAULT_MIN_CHUNK,
+            [this, &view, toLabel](int64_t begin, int64_t end, int) {
+                for (int64_t i = begin; i < end; ++i) {
+                    view.set(m_cellIds[i], toLabel);
+                }
+            });
+    } else {
+        for (int cellId : m_cellIds) {
+            labels->SetTuple1(cellId, toLabel);
+        }
+    }
+    labels->Modified();
+    m_polyData->GetCellData()->Modified();
+}
+
+QString FillCommand::description() const
+{
+    return QString("Fill %1 cells from label %2 to label %3")
+        .arg(m_cellIds.size())
+        .arg(m_oldLabel)
+        .arg(m_newLabel);
+}
+
+size_t FillCommand::memoryBytes() const
+{
+    return m_cellIds.capacity() * sizeof(int);
+}
+
+// ==================== RelabelCommand 实现 ====================
+
+RelabelCommand::RelabelCommand(vtkSmartPointer<vtkPolyData> polyData,
+                               std::vector<int>&& cellIds,
+                               std::vector<int>&& newLabels,
+                               LabelStatistics* statistics)
+    : m_polyData(polyData)
+    , m_cellIds(std::move(cellIds))
+    , m_newLabels(std::move(newLabels))
+    , m_statistics(statistics)
+{
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    m_oldLabels.reserve(m_cellIds.size());
+    for (int cellId : m_cellIds) {
+        m_oldLabels.push_back(static_cast<int>(labels->GetTuple1(cellId)));
+    }
+}
+
+void RelabelCommand::execute()
+{
+    apply(m_newLabels);
+}
+
+void RelabelCommand::undo()
+{
+    apply(m_oldLabels);
+}
+
+void RelabelCommand::apply(const std::vector<int>& values)
+{
+    ML_PROFILE_SCOPE(ProfileStage::ScalarUpdate);
+
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    for (size_t i = 0; i < m_cellIds.size(); ++i) {
+        if (m_statistics) {
+            m_statistics->moveCell(m_cellIds[i],
+                                   static_cast<int>(labels->GetTuple1(m_cellIds[i])),
+                                   values[i]);
+        }
+        labels->SetTuple1(m_cellIds[i], values[i]);
+    }
+    labels->Modified();
+    m_polyData->GetCellData()->Modified();
+}
+
+QString RelabelCommand::description() const
+{
+    return QString("Relabel %1 cells").arg(m_cellIds.size());
+}
+
+size_t RelabelCommand::memoryBytes() const
+{
+    return (m_cellIds.capacity() + m_oldLabels.capacity() + m_newLabels.capacity()) * sizeof(int);
+}
+
+// ==================== PointPaintCommand 实现 ====================
+
+PointPaintCommand::PointPaintCommand(vtkSmartPointer<vtkPolyData> polyData,
+                                     const std::vector<int>& pointIds,
+                                     int newLabel,
+                                     LabelStatistics* statistics)
+    : m_polyData(polyData)
+    , m_newLabel(newLabel)
+    , m_statistics(statistics)
+{
+    append(pointIds);
+}
+
+void PointPaintCommand::append(const std::vector<int>& pointIds)
+{
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    m_pointIds.reserve(m_pointIds.size() + pointIds.size());
+    m_oldLabels.reserve(m_oldLabels.size() + pointIds.size());
+    for (int pointId : pointIds) {
+        m_pointIds.push_back(pointId);
+        m_oldLabels.push_back(static_cast<int>(labels->GetTuple1(pointId)));
+    }
+}
+
+void PointPaintCommand::execute()
+{
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    for (int pointId : m_pointIds) {
+        labels->SetTuple1(pointId, m_newLabel);
+    }
+    labels->Modified();
+    m_polyData->GetPointData()->Modified();
+    PointLabels::updateCells(m_polyData, m_pointIds, m_statistics);
+}
+
+void PointPaintCommand::undo()
+{
+    // 逆序恢复，保证同一顶点多次出现时恢复到最早的值
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    for (size_t i = m_pointIds.size(); i-- > 0;) {
+        labels->SetTuple1(m_pointIds[i], m_oldLabels[i]);
+    }
+    labels->Modified();
+    m_polyData->GetPointData()->Modified();
+    PointLabels::updateCells(m_polyData, m_pointIds, m_statistics);
+}
+
+QString PointPaintCommand::description() const
+{
+    return QString("Paint %1 points with label %2")
+        .arg(m_pointIds.size())
+        .arg(m_newLabel);
+}
+
+size_t PointPaintCommand::memoryBytes() const
+{
+    return (m_pointIds.capacity() + m_oldLabels.capacity()) * sizeof(int);
+}
+
+namespace {
+
+/**
+ * @brief 点定位器占用的内存（估计值：每个顶点一条 (顶点, 桶) 记录加桶偏移）
+ */
+size_t pointLocatorBytes(vtkStaticPointLocator* locator, vtkPolyData* polyData)
+{
+    return locator ? static_cast<size_t>(polyData->GetNumberOfPoints()) * 3 * sizeof(vtkIdType) : 0;
+}
+
+} // namespace
+
+// ==================== MeshLabelCore 实现 ====================
+
+MeshLabelCore::MeshLabelCore()
+    : m_labelLocation(LabelLocation::Cell)
+    , m_labelCapacity(DEFAULT_LABEL_CAPACITY)
+    , m_parallelBfsFrontier(PARALLEL_BFS_FRONTIER)
+    , m_visibilityArrayEnabled(true)
+    , m_hasClipBox(false)
+    , m_strokeActive(false)
+{
+    std::fill(m_clipBox, m_clipBox + 6, 0.0);
+}
+
+MeshLabelCore::~MeshLabelCore() = default;
+
+void MeshLabelCore::initializeCellData()
+{
+    if (!m_polyData) {
+        qWarning() << "Cannot initialize cell data: polyData is null";
+        return;
+    }
+
+    m_polyData->GetCellData()->SetScalars(
+        LabelArray::create(m_labelCapacity, m_polyData->GetNumberOfCells()));
+
+    qDebug() << "Initialized" << m_polyData->GetNumberOfCells() << "cells";
+}
+
+void MeshLabelCore::buildAdjacency()
+{
+    if (m_polyData) {
+        m_polyData->BuildLinks();
+    }
+}
+
+void MeshLabelCore::ensureEditingResources()
+{
+    if (m_polyData && !m_polyData->GetLinks()) {
+        buildAdjacency();
+    }
+    if (m_polyData && m_labelLocation == LabelLocation::Point && !m_pointLocator) {
+        buildPointLocator();
+    }
+}
+
+void MeshLabelCore::releaseEditingResources()
+{
+    if (m_polyData) {
+        // 渲染只用 polys 连接数组；单元数组和链接在下次 GetCell/GetPointCells 时会重建
+        m_polyData->DeleteLinks();
+        m_polyData->DeleteCells();
+    }
+    m_adjacency.clear();
+    m_components.clear();
+    m_geodesic = GeodesicEngine();
+    m_regionGrower = RegionGrower();
+    m_bfsVisits.clear();
+    m_smoother = LabelSmoother();
+    m_graphCut = GraphCutRefiner();
+    std::vector<int>().swap(m_labelBuffer);
+    m_pointLocator = nullptr;
+}
+
+size_t MeshLabelCore::editingMemoryBytes() const
+{
+    size_t bytes = m_adjacency.memoryBytes() + m_labelBuffer.capacity() * sizeof(int)
+        + m_geodesic.memoryBytes() + m_regionGrower.memoryBytes() + m_bfsVisits.memoryBytes()
+        + m_components.memoryBytes() + m_smoother.memoryBytes() + m_graphCut.memoryBytes()
+        + pointLocatorBytes(m_pointLocator, m_polyData);
+    if (m_polyData && m_polyData->GetLinks()) {
+        bytes += static_cast<size_t>(m_polyData->GetLinks()->GetActualMemorySize()) * 1024;
+    }
+    return bytes;
+}
+
+MemoryReport MeshLabelCore::memoryReport() const
+{
+    MemoryReport report;
+    if (!m_polyData) {
+        return report;
+    }
+    report.setCellCount(m_polyData->GetNumberOfCells());
+
+    // VTK 的 GetActualMemorySize() 以 KiB 为单位
+    auto kib = [](unsigned long size) { return static_cast<size_t>(size) * 1024; };
+
+    const size_t points = m_polyData->GetPoints()
+        ? kib(m_polyData->GetPoints()->GetData()->GetActualMemorySize()) : 0;
+    size_t connectivity = 0;
+    for (vtkCellArray* cells : { m_polyData->GetVerts(), m_polyData->GetLines(),
+                                 m_polyData->GetPolys(), m_polyData->GetStrips() }) {
+        connectivity += cells ? kib(cells->GetActualMemorySize()) : 0;
+    }
+    const size_t links = m_polyData->GetLinks() ? kib(m_polyData->GetLinks()->GetActualMemorySize()) : 0;
+    vtkDataArray* scalars = m_polyData->GetCellData()->GetScalars();
+    vtkDataArray* pointScalars = m_labelLocation == LabelLocation::Point
+        ? m_polyData->GetPointData()->GetScalars() : nullptr;
+    const size_t labels = (scalars ? kib(scalars->GetActualMemorySize()) : 0)
+        + (pointScalars ? kib(pointScalars->GetActualMemorySize()) : 0);
+    const size_t arrays = kib(m_polyData->GetCellData()->GetActualMemorySize())
+        + kib(m_polyData->GetPointData()->GetActualMemorySize())
+        + kib(m_polyData->GetFieldData()->GetActualMemorySize());
+    const size_t otherArrays = arrays > labels ? arrays - labels : 0;
+
+    // 单元索引（BuildCells 建立的单元类型/位置表）没有单独的接口，用整体减去其它各项
+    const size_t total = kib(m_polyData->GetActualMemorySize());
+    const size_t known = points + connectivity + links + labels + otherArrays;
+
+    report.add("网格顶点", points);
+    report.add("单元连接", connectivity);
+    report.add("单元索引", total > known ? total - known : 0);
+    report.add("点-单元链接", links);
+    report.add("标签", labels);
+    report.add("其它数据数组", otherArrays);
+
+    report.add("CSR 邻接", m_adjacency.memoryBytes(), true);
+    report.add("点定位器", pointLocatorBytes(m_pointLocator, m_polyData), true);
+    report.add("连通分量", m_components.memoryBytes(), true);
+    report.add("算法缓冲区", m_labelBuffer.capacity() * sizeof(int) + m_geodesic.memoryBytes()
+                   + m_regionGrower.memoryBytes() + m_bfsVisits.memoryBytes()
+                   + m_smoother.memoryBytes() + m_graphCut.memoryBytes(), true);
+
+    // std::stack 不能遍历，复制一份（只复制指针）
+    size_t history = (m_strokeCommand ? m_strokeCommand->memoryBytes() : 0)
+        + (m_pointStrokeCommand ? m_pointStrokeCommand->memoryBytes() : 0);
+    for (std::stack<std::shared_ptr<LabelCommand>> stack : { m_undoStack, m_redoStack }) {
+        for (; !stack.empty(); stack.pop()) {
+            history += stack.top()->memoryBytes();
+        }
+    }
+    report.add("撤销历史", history, true);
+    return report;
+}
+
+void MeshLabelCore::resetMesh(vtkSmartPointer<vtkPolyData> polyData, const QString& filename)
+{
+    m_strokeCommand.reset();
+    m_pointStrokeCommand.reset();
+    m_strokeActive = false;
+    clearHistory();
+    m_pointLocator = nullptr;
+
+    m_polyData = polyData;
+    m_currentFileName = filename;
+    m_adjacency.clear();
+    m_components.clear();
+
+    if (!m_polyData->GetCellData()->GetScalars()) {
+        qDebug() << "No label data found, initializing...";
+        initializeCellData();
+    }
+    // 读取器按倍增预留顶点和连接数组，加载后释放多余的容量
+    m_polyData->Squeeze();
+    buildAdjacency();
+
+    // 文件中的标签超出当前容量时自动扩大容量
+    vtkDataArray* pointLabels = m_polyData->GetPointData()->GetArray("Label");
+    int minLabel;
+    int maxLabel;
+    LabelArray::range(pointLabels ? pointLabels : m_polyData->GetCellData()->GetScalars(),
+                      minLabel, maxLabel);
+    if (maxLabel >= m_labelCapacity && maxLabel < MAX_LABEL_CAPACITY) {
+        m_labelCapacity = maxLabel + 1;
+        qDebug() << "Label capacity raised to" << m_labelCapacity;
+    }
+
+    // 点数据中有 Label 数组：顶点标签模式，单元标签由顶点标签重新计算
+    if (pointLabels) {
+        std::vector<int> values(m_polyData->GetNumberOfPoints());
+        int invalid = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<int>(pointLabels->GetComponent(i, 0));
+            if (values[i] < 0 || values[i] >= m_labelCapacity) {
+                values[i] = 0;
+                ++invalid;
+            }
+        }
+        if (invalid > 0) {
+            qWarning() << invalid << "vertex labels outside [0," << m_labelCapacity << ") reset to 0";
+        }
+        m_labelLocation = LabelLocation::Point;
+        applyPointLabels(values);
+        buildPointLocator();
+        qDebug() << "Loaded vertex labels";
+    } else {
+        m_labelLocation = LabelLocation::Cell;
+        // 旧版本的 float 标签转换为 8/16 位存储
+        if (!compactLabels()) {
+            qWarning() << "Labels outside [0," << m_labelCapacity << ") kept in original storage";
+        }
+        m_statistics.recompute(m_polyData, m_labelCapacity);
+    }
+    syncVisibility();
+
+    const MemoryReport report = memoryReport();
+    qDebug() << "Mesh memory:" << report.residentBytes() / (1024 * 1024) << "MB resident,"
+             << report.residentBytesPerCell() << "bytes/triangle";
+    if (!report.withinBudget(MEMORY_BUDGET_PER_CELL)) {
+        qWarning() << "Mesh memory exceeds budget of" << MEMORY_BUDGET_PER_CELL << "bytes/triangle";
+    }
+}
+
+bool MeshLabelCore::loadSTL(const QString& filename)
+{
+    if (filename.isEmpty()) {
+        m_lastError = "文件名为空";
+        return false;
+    }
+
+    QFileInfo fileInfo(filename);
+    if (!fileInfo.exists()) {
+        m_lastError = QString("文件不存在: %1").arg(filename);
+        return false;
+    }
+
+    vtkNew<vtkSTLReader> reader;
+    reader->SetFileName(filename.toLocal8Bit().data());
+    reader->Update();
+
+    if (!reader->GetOutput() || reader->GetOutput()->GetNumberOfPoints() == 0) {
+        m_lastError = QString("无法加载STL文件: %1").arg(filename);
+        return false;
+    }
+
+    // STL 不含标签数据，总是重新初始化
+    vtkSmartPointer<vtkPolyData> polyData = reader->GetOutput();
+    polyData->GetCellData()->SetScalars(nullptr);
+    resetMesh(polyData, filename);
+
+    qDebug() << "Loaded STL file:" << filename;
+    qDebug() << "Points:" << m_polyData->GetNumberOfPoints();
+    qDebug() << "Cells:" << m_polyData->GetNumberOfCells();
+
+    return true;
+}
+
+bool MeshLabelCore::loadVTP(const QString& filename)
+{
+    if (filename.isEmpty()) {
+        m_lastError = "文件名为空";
+        return false;
+    }
+
+    QFileInfo fileInfo(filename);
+    if (!fileInfo.exists()) {
+        m_lastError = QString("文件不存在: %1").arg(filename);
+        return false;
+    }
+
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(filename.toLocal8Bit().data());
+    reader->Update();
+
+    if (!reader->GetOutput() || reader->GetOutput()->GetNumberOfPoints() == 0) {
+        m_lastError = QString("无法加载VTP文件: %1").arg(filename);
+        return false;
+    }
+
+    resetMesh(reader->GetOutput(), filename);
+
+    qDebug() << "Loaded VTP file:" << filename;
+    qDebug() << "Points:" << m_polyData->GetNumberOfPoints();
+    qDebug() << "Cells:" << m_polyData->GetNumberOfCells();
+
+    return true;
+}
+
+bool MeshLabelCore::setMesh(vtkSmartPointer<vtkPolyData> polyData)
+{
+    if (!polyData || polyData->GetNumberOfPoints() == 0) {
+        m_lastError = "网格数据为空";
+        return false;
+    }
+
+    resetMesh(polyData, QString());
+    return true;
+}
+
+bool MeshLabelCore::saveVTP(const QString& filename)
+{
+    if (!m_polyData) {
+        m_lastError = "没有可保存的网格数据";
+        return false;
+    }
+
+    if (filename.isEmpty()) {
+        m_lastError = "文件名为空";
+        return false;
+    }
+
+    // 设置标签名称
+    m_polyData->GetCellData()->GetScalars()->SetName("Label");
+    m_polyData->GetCellData()->GetScalars()->Modified();
+
+    // 可见性数组只用于显示，不写入文件
+    vtkCellData* cellData = m_polyData->GetCellData();
+    vtkSmartPointer<vtkDataArray> ghosts = cellData->GetArray(vtkDataSetAttributes::GhostArrayName());
+    if (ghosts) {
+        cellData->RemoveArray(vtkDataSetAttributes::GhostArrayName());
+    }
+
+    vtkNew<vtkXMLPolyDataWriter> writer;
+    writer->SetInputData(m_polyData);
+    writer->SetFileName(filename.toLocal8Bit().data());
+    writer->SetDataModeToAscii();
+
+    int result = writer->Write();
+    if (ghosts) {
+        cellData->AddArray(ghosts);
+    }
+    if (result == 0) {
+        m_lastError = QString("保存VTP文件失败: %1").arg(filename);
+        return false;
+    }
+
+    m_currentFileName = filename;
+    qDebug() << "Saved VTP file:" << filename;
+
+    return true;
+}
+
+bool MeshLabelCore::saveToTempFile()
+{
+    if (!m_polyData) {
+        return false;
+    }
+
+    QString tempPath = QFileInfo(m_currentFileName).dir().path();
+    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
+    m_tempFileName = QString("%1/autosave_%2.vtp").arg(tempPath).arg(timestamp);
+
+    bool result = saveVTP(m_tempFileName);
+    if (result) {
+        qDebug() << "Auto-saved to:" << m_tempFileName;
+    }
+
+    return result;
+}
+
+bool MeshLabelCore::setLabelLocation(LabelLocation location)
+{
+    if (!m_polyData) {
+        m_lastError = "没有网格数据";
+        return false;
+    }
+    if (location == m_labelLocation) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    endStroke();
+    clearHistory();
+    if (!m_polyData->GetLinks()) {
+        buildAdjacency();
+    }
+
+    if (location == LabelLocation::Point) {
+        readLabels(m_labelBuffer);
+        std::vector<int> pointLabels;
+        PointLabels::cellsToPoints(m_polyData, m_labelBuffer, pointLabels);
+        m_labelLocation = LabelLocation::Point;
+        applyPointLabels(pointLabels);
+        buildPointLocator();
+    } else {
+        // 单元标签一直与顶点标签同步，直接沿用
+        m_polyData->GetPointData()->RemoveArray("Label");
+        m_pointLocator = nullptr;
+        m_labelLocation = LabelLocation::Cell;
+    }
+    syncVisibility();
+
+    qDebug() << "Label location:" << (location == LabelLocation::Point ? "points" : "cells")
+             << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void MeshLabelCore::applyPointLabels(const std::vector<int>& pointLabels)
+{
+    auto store = [this](const std::vector<int>& values) {
+        vtkSmartPointer<vtkDataArray> array =
+            LabelArray::create(m_labelCapacity, static_cast<vtkIdType>(values.size()));
+        const LabelView view(array);
+        for (size_t i = 0; i < values.size(); ++i) {
+            view.set(i, values[i]);
+        }
+        return array;
+    };
+
+    m_polyData->GetPointData()->SetScalars(store(pointLabels));
+
+    std::vector<int> cellLabels;
+    PointLabels::pointsToCells(m_polyData, pointLabels, cellLabels);
+    m_polyData->GetCellData()->SetScalars(store(cellLabels));
+
+    m_statistics.recompute(m_polyData, m_labelCapacity);
+}
+
+bool MeshLabelCore::setLabelCapacity(int capacity)
+{
+    if (capacity < 1 || capacity > MAX_LABEL_CAPACITY) {
+        m_lastError = QString("标签容量必须在 1 ~ %1 之间").arg(MAX_LABEL_CAPACITY);
+        return false;
+    }
+    if (capacity == m_labelCapacity) {
+        return true;
+    }
+    if (!m_polyData) {
+        m_labelCapacity = capacity;
+        return true;
+    }
+
+    const int highest = maxLabel();
+    if (highest >= capacity) {
+        m_lastError = QString("网格中已有标签 %1，标签容量至少为 %2").arg(highest).arg(highest + 1);
+        return false;
+    }
+
+    endStroke();
+    if (capacity < m_labelCapacity) {
+        clearHistory();
+    }
+    m_labelCapacity = capacity;
+    compactLabels();
+    m_statistics.recompute(m_polyData, m_labelCapacity);
+
+    qDebug() << "Label capacity:" << capacity << "("
+             << (LabelArray::storageType(capacity) == VTK_UNSIGNED_CHAR ? 8 : 16) << "-bit labels)";
+    return true;
+}
+
+int MeshLabelCore::maxLabel() const
+{
+    if (!m_polyData) {
+        return -1;
+    }
+
+    int minLabel;
+    int highest;
+    LabelArray::range(m_polyData->GetCellData()->GetScalars(), minLabel, highest);
+    if (m_labelLocation == LabelLocation::Point) {
+        int highestPoint;
+        LabelArray::range(m_polyData->GetPointData()->GetScalars(), minLabel, highestPoint);
+        highest = std::max(highest, highestPoint);
+    }
+    return std::max(highest, -1);
+}
+
+bool MeshLabelCore::compactLabels()
+{
+    vtkDataSetAttributes* attributes[] = {
+        m_polyData->GetCellData(),
+        m_labelLocation == LabelLocation::Point ? m_polyData->GetPointData() : nullptr
+    };
+
+    bool compacted = true;
+    for (vtkDataSetAttributes* data : attributes) {
+        vtkDataArray* labels = data ? data->GetScalars() : nullptr;
+        if (!labels) {
+            continue;
+        }
+        vtkSmartPointer<vtkDataArray> converted = LabelArray::convert(labels, m_labelCapacity);
+        if (!converted) {
+            compacted = false;
+        } else if (converted != labels) {
+            data->SetScalars(converted);
+        }
+    }
+    return compacted;
+}
+
+void MeshLabelCore::buildPointLocator()
+{
+    m_pointLocator = vtkSmartPointer<vtkStaticPointLocator>::New();
+    m_pointLocator->SetDataSet(m_polyData);
+    m_pointLocator->BuildLocator();
+}
+
+bool MeshLabelCore::requireCellLabels()
+{
+    if (m_labelLocation == LabelLocation::Cell) {
+        return true;
+    }
+    m_lastError = "顶点标签模式下不可用，请先切换回单元标签";
+    return false;
+}
+
+void MeshLabelCore::setLockedLabels(const LabelMask& labels)
+{
+    m_lockedLabels = labels;
+    m_protectedLabels = m_lockedLabels.united(m_hiddenLabels);
+}
+
+void MeshLabelCore::setHiddenLabels(const LabelMask& labels)
+{
+    if (labels == m_hiddenLabels) {
+        return;
+    }
+    m_hiddenLabels = labels;
+    m_protectedLabels = m_lockedLabels.united(m_hiddenLabels);
+    updateVisibility();
+}
+
+bool MeshLabelCore::isCellHidden(int cellId) const
+{
+    // 超出范围的单元 getCellLabel() 返回-1，不在掩码中
+    return m_hiddenLabels.any() && m_hiddenLabels.test(getCellLabel(cellId));
+}
+
+int MeshLabelCore::hiddenCellCount() const
+{
+    int count = 0;
+    for (int label : m_hiddenLabels.labels()) {
+        count += m_statistics.cellCount(label);
+    }
+    return count;
+}
+
+void MeshLabelCore::setVisibilityArrayEnabled(bool enabled)
+{
+    if (enabled == m_visibilityArrayEnabled) {
+        return;
+    }
+    m_visibilityArrayEnabled = enabled;
+    updateVisibility();
+}
+
+void MeshLabelCore::updateVisibility()
+{
+    if (!m_polyData) {
+        return;
+    }
+
+    vtkCellData* cellData = m_polyData->GetCellData();
+    if (!m_hiddenLabels.any() || !m_visibilityArrayEnabled) {
+        if (cellData->HasArray(vtkDataSetAttributes::GhostArrayName())) {
+            cellData->RemoveArray(vtkDataSetAttributes::GhostArrayName());
+            cellData->Modified();
+        }
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const vtkIdType cellCount = m_polyData->GetNumberOfCells();
+    vtkSmartPointer<vtkUnsignedCharArray> ghosts = vtkUnsignedCharArray::SafeDownCast(
+        cellData->GetArray(vtkDataSetAttributes::GhostArrayName()));
+    if (!ghosts || ghosts->GetNumberOfTuples() != cellCount) {
+        ghosts = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+        ghosts->SetNumberOfTuples(cellCount);
+        cellData->AddArray(ghosts);
+    }
+
+    // 每个单元一次位掩码查询，写入1字节的可见性标记
+    unsigned char* flags = ghosts->GetPointer(0);
+    vtkDataArray* scalars = cellData->GetScalars();
+    const LabelView labels(scalars);
+    const int chunks = ParallelUtils::chunkCount(0, cellCount);
+    std::vector<int> chunkHidden(chunks, 0);
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int chunk) {
+            int hidden = 0;
+            for (int64_t cellId = begin; cellId < end; ++cellId) {
+                const int label = labels.isValid() ? labels.get(cellId)
+                                                   : static_cast<int>(scalars->GetComponent(cellId, 0));
+                const bool hide = m_hiddenLabels.test(label);
+                flags[cellId] = hide ? vtkDataSetAttributes::HIDDENCELL : 0;
+                hidden += hide ? 1 : 0;
+            }
+            chunkHidden[chunk] = hidden;
+        });
+    int hiddenCells = 0;
+    for (int hidden : chunkHidden) {
+        hiddenCells += hidden;
+    }
+    ghosts->Modified();
+    cellData->Modified();
+
+    qDebug() << "Visibility updated:" << hiddenCells << "of" << cellCount
+             << "cells hidden in" << timer.elapsed() << "ms";
+}
+
+void MeshLabelCore::syncVisibility()
+{
+    if (m_hiddenLabels.any() && m_visibilityArrayEnabled) {
+        updateVisibility();
+    }
+}
+
+void MeshLabelCore::setClipBox(const double bounds[6])
+{
+    std::copy(bounds, bounds + 6, m_clipBox);
+    m_hasClipBox = true;
+}
+
+void MeshLabelCore::clearClipBox()
+{
+    m_hasClipBox = false;
+}
+
+bool MeshLabelCore::isCellInClipBox(int cellId) const
+{
+    if (!m_hasClipBox) {
+        return true;
+    }
+    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+        return false;
+    }
+
+    vtkNew<vtkIdList> pointIds;
+    return isCellInClipBox(cellId, pointIds);
+}
+
+bool MeshLabelCore::isCellInClipBox(int cellId, vtkIdList* pointIds) const
+{
+    if (!m_hasClipBox) {
+        return true;
+    }
+    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+        return false;
+    }
+
+    m_polyData->GetCellPoints(cellId, pointIds);
+    return areCellPointsInClipBox(pointIds->GetNumberOfIds(), pointIds->GetPointer(0));
+}
+
+bool MeshLabelCore::areCellPointsInClipBox(vtkIdType npts, const vtkIdType* pts) const
+{
+    if (!m_hasClipBox) {
+        return true;
+    }
+
+    vtkPoints* points = m_polyData->GetPoints();
+    for (vtkIdType i = 0; i < npts; ++i) {
+        double p[3];
+        points->GetPoint(pts[i], p);
+        if (isPointInClipBox(p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MeshLabelCore::dropProtectedCells(std::vector<int>& cellIds, std::vector<int>& newLabels) const
+{
+    if (!m_protectedLabels.any() && !m_hasClipBox) {
+        return;
+    }
+
+    vtkDataArray* scalars = m_polyData->GetCellData()->GetScalars();
+    const LabelView labels(scalars);
+    vtkNew<vtkIdList> pointIds;
+    size_t kept = 0;
+    for (size_t i = 0; i < cellIds.size(); ++i) {
+        const int label = labels.isValid() ? labels.get(cellIds[i])
+                                           : static_cast<int>(scalars->GetComponent(cellIds[i], 0));
+        if (!m_protectedLabels.test(label) && isCellInClipBox(cellIds[i], pointIds)) {
+            cellIds[kept] = cellIds[i];
+            newLabels[kept] = newLabels[i];
+            ++kept;
+        }
+    }
+    cellIds.resize(kept);
+    newLabels.resize(kept);
+}
+
+bool MeshLabelCore::isCellInSphere(const double* position, double radius, int cellId) const
+{
+    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+        return false;
+    }
+
+    vtkCell* cell = m_polyData->GetCell(cellId);
+    vtkPoints* points = cell->GetPoints();
+
+    double radiusSquared = radius * radius;
+
+    for (int i = 0; i < points->GetNumberOfPoints(); ++i) {
+        double* pt = points->GetPoint(i);
+        double distSquared = vtkMath::Distance2BetweenPoints(position, pt);
+        if (distSquared < radiusSquared) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<int> MeshLabelCore::labelWithBFS(const double* position, int startCellId,
+                                             double radius, int label)
+{
+    ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+    std::vector<int> affectedCells;
+
+    if (!m_polyData || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()) {
+        return affectedCells;
+    }
+
+    // 访问标记按代号复用：首次使用后每个样本只与区域大小有关
+    m_bfsVisits.begin(static_cast<size_t>(m_polyData->GetNumberOfCells()));
+
+    // 输出之外另用一个数组做 BFS 队列，队列的剩余部分可以直接交给并行阶段
+    std::vector<int> queue;
+    queue.push_back(startCellId);
+    m_bfsVisits.claim(startCellId);
+
+    // 只用线程安全的只读接口（画刷流水线在工作线程上调用，同时 GUI 线程在拾取和渲染）：
+    // 顶点编号和相邻单元都复制到本函数的 vtkIdList 中
+    vtkNew<vtkIdList> pointIds;
+    vtkNew<vtkIdList> cellIds;
+    vtkPoints* points = m_polyData->GetPoints();
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    const double radiusSquared = radius * radius;
+
+    const bool canExpandInParallel = LabelView(labels).isValid() && ParallelUtils::threadCount() > 1;
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        if (canExpandInParallel
+            && queue.size() - head >= static_cast<size_t>(m_parallelBfsFrontier)) {
+            // 大半径画刷：剩余部分交给多个线程扩展
+            expandBFSParallel(position, radius, label, queue.data() + head,
+                              queue.size() - head, affectedCells);
+            break;
+        }
+
+        const int cellId = queue[head];
+
+        // 检查是否在球体内（任一顶点在球内，与 isCellInSphere() 相同）
+        m_polyData->GetCellPoints(cellId, pointIds);
+        bool inside = false;
+        for (vtkIdType i = 0; i < pointIds->GetNumberOfIds() && !inside; ++i) {
+            double p[3];
+            points->GetPoint(pointIds->GetId(i), p);
+            inside = vtkMath::Distance2BetweenPoints(position, p) < radiusSquared;
+        }
+        if (!inside
+            || !areCellPointsInClipBox(pointIds->GetNumberOfIds(), pointIds->GetPointer(0))) {
+            continue;
+        }
+
+        // 检查是否已经是目标标签，或是锁定/隐藏的标签（一次位掩码查询）
+        int currentLabel = static_cast<int>(labels->GetComponent(cellId, 0));
+
+        if (currentLabel == label || m_protectedLabels.test(currentLabel)) {
+            continue;
+        }
+
+        // 标记为受影响的单元
+        affectedCells.push_back(cellId);
+
+        // 获取邻居单元
+        for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i) {
+            m_polyData->GetPointCells(pointIds->GetId(i), cellIds);
+            for (vtkIdType j = 0; j < cellIds->GetNumberOfIds(); ++j) {
+                const int neighborId = static_cast<int>(cellIds->GetId(j));
+                if (m_bfsVisits.claim(neighborId)) {
+                    queue.push_back(neighborId);
+                }
+            }
+        }
+    }
+
+    return affectedCells;
+}
+
+void MeshLabelCore::setParallelBfsFrontier(int cells)
+{
+    m_parallelBfsFrontier = cells > 0 ? cells : PARALLEL_BFS_FRONTIER;
+}
+
+void MeshLabelCore::expandBFSParallel(const double* position, double radius, int label,
+                                      const int* frontier, size_t frontierSize,
+                                      std::vector<int>& affectedCells)
+{
+    vtkPolyData* polyData = m_polyData;
+    vtkPoints* points = polyData->GetPoints();
+    vtkCellArray* polys = polyData->GetPolys();
+    const vtkIdType polyOffset = polyData->GetNumberOfVerts() + polyData->GetNumberOfLines();
+    const vtkIdType polyCount = polys->GetNumberOfCells();
+    const LabelView labels(polyData->GetCellData()->GetScalars());
+    const LabelMask& protectedLabels = m_protectedLabels;
+    VisitStamps& visits = m_bfsVisits;
+    const double radiusSquared = radius * radius;
+
+    // 前沿按线程数分段，每个线程从自己的一段出发做完整的 BFS，邻居用原子标记认领
+    // （与串行阶段共用标记），认领成功的线程负责检查和继续扩展它。
+    // 线程只在这里启动一次，各线程之间没有按层的同步。
+    const int64_t size = static_cast<int64_t>(frontierSize);
+    const int chunks = ParallelUtils::chunkCount(0, size, 1);
+    std::vector<std::vector<int>> chunkAffected(chunks);
+    ParallelUtils::forChunks(0, size, 1, [&](int64_t begin, int64_t end, int chunk) {
+        // 多边形用每个线程自己的迭代器读取（vtkCellArray 的随机访问不是线程安全的），
+        // 其它类型的单元复制到本线程的 vtkIdList；点-单元链接是只读数组，
+        // GetPointCells 的指针版本直接返回其中的地址
+        vtkSmartPointer<vtkCellArrayIterator> iter =
+            vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+        vtkNew<vtkIdList> cellPoints;
+        std::vector<int> queue(frontier + begin, frontier + end);
+        std::vector<int>& affected = chunkAffected[chunk];
+
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int cellId = queue[head];
+            const int cellLabel = labels.get(cellId);
+            if (cellLabel == label || protectedLabels.test(cellLabel)) {
+                continue;
+            }
+
+            vtkIdType npts;
+            const vtkIdType* pts;
+            const vtkIdType polyId = cellId - polyOffset;
+            if (polyId >= 0 && polyId < polyCount) {
+                iter->GetCellAtId(polyId, npts, pts);
+            } else {
+                polyData->GetCellPoints(cellId, cellPoints);
+                npts = cellPoints->GetNumberOfIds();
+                pts = cellPoints->GetPointer(0);
+            }
+            bool inside = false;
+            for (vtkIdType k = 0; k < npts && !inside; ++k) {
+                double p[3];
+                points->GetPoint(pts[k], p);
+                inside = vtkMath::Distance2BetweenPoints(position, p) < radiusSquared;
+            }
+            if (!inside || !areCellPointsInClipBox(npts, pts)) {
+                continue;
+            }
+
+            affected.push_back(cellId);
+            for (vtkIdType k = 0; k < npts; ++k) {
+                vtkIdType ncells;
+                vtkIdType* cells;
+                polyData->GetPointCells(pts[k], ncells, cells);
+                for (vtkIdType j = 0; j < ncells; ++j) {
+                    if (visits.claim(static_cast<size_t>(cells[j]))) {
+                        queue.push_back(static_cast<int>(cells[j]));
+                    }
+                }
+            }
+        }
+    });
+
+    for (const std::vector<int>& affected : chunkAffected) {
+        affectedCells.insert(affectedCells.end(), affected.begin(), affected.end());
+    }
+}
+
+int MeshLabelCore::bucketFill(int startCellId, int label)
+{
+    if (!m_polyData || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()
+        || !requireCellLabels()) {
+        return 0;
+    }
+
+    vtkDataArray* scalars = m_polyData->GetCellData()->GetScalars();
+    const int oldLabel = static_cast<int>(scalars->GetTuple1(startCellId));
+    if (oldLabel == label || !isCellInClipBox(startCellId)) {
+        return 0;
+    }
+    if (m_protectedLabels.test(oldLabel)) {
+        m_lastError = QString("标签 %1 已锁定或隐藏").arg(oldLabel);
+        return 0;
+    }
+
+    std::vector<int> region;
+    {
+        ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+        const MeshAdjacency& adjacency = meshAdjacency();
+        const LabelView labels(scalars);
+        vtkNew<vtkIdList> pointIds;
+
+        // 感兴趣区域外的单元不进入区域，生长在盒边界停止
+        m_regionGrower.grow(adjacency, startCellId,
+            [this, &labels, scalars, oldLabel, &pointIds](int, int toCell) {
+                const int toLabel = labels.isValid() ? labels.get(toCell)
+                                                     : static_cast<int>(scalars->GetTuple1(toCell));
+                return toLabel == oldLabel && isCellInClipBox(toCell, pointIds);
+            },
+            region);
+    }
+
+    const int filled = static_cast<int>(region.size());
+    addEditCommand(std::make_shared<FillCommand>(m_polyData, std::move(region), oldLabel, label,
+                                                 &m_statistics));
+    return filled;
+}
+
+const LabelComponents& MeshLabelCore::analyzeComponents()
+{
+    if (!m_polyData) {
+        m_components.clear();
+        return m_components;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const MeshAdjacency& adjacency = meshAdjacency();
+    readLabels(m_labelBuffer);
+    m_components.compute(adjacency, m_labelBuffer);
+    qDebug() << "Analyzed components:" << m_components.components().size()
+             << "in" << timer.elapsed() << "ms";
+    return m_components;
+}
+
+int MeshLabelCore::mergeSmallComponents(int minCells)
+{
+    if (!m_polyData || minCells <= 0 || !requireCellLabels()) {
+        return 0;
+    }
+
+    analyzeComponents();
+    std::vector<int> cellIds;
+    std::vector<int> newLabels;
+    const int merged = m_components.fragmentMerges(m_adjacency, minCells, cellIds, newLabels);
+    dropProtectedCells(cellIds, newLabels);
+    const int changed = commitRelabel(cellIds, newLabels);
+    if (changed == 0) {
+        return 0;
+    }
+    qDebug() << "Merged" << merged << "fragments," << changed << "cells";
+    return merged;
+}
+
+int MeshLabelCore::smoothLabelBoundaries(int iterations, int bandRings)
+{
+    if (!m_polyData || !requireCellLabels()) {
+        return 0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const MeshAdjacency& adjacency = meshAdjacency();
+    readLabels(m_labelBuffer);
+    std::vector<int> cellIds;
+    const int rounds = m_smoother.smooth(adjacency, m_labelBuffer, iterations, bandRings, cellIds);
+    qDebug() << "Smoothed label boundaries:" << cellIds.size() << "cells," << rounds
+             << "rounds in" << timer.elapsed() << "ms";
+    return commitBufferLabels(cellIds);
+}
+
+int MeshLabelCore::refineWithGraphCut(int foreground, int background, int bandRings)
+{
+    if (!m_polyData || foreground == background || !requireCellLabels()) {
+        return 0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const MeshAdjacency& adjacency = meshAdjacency(true);
+    readLabels(m_labelBuffer);
+    std::vector<int> cellIds;
+    const double cut = m_graphCut.refine(adjacency, m_labelBuffer, foreground, background,
+                                         bandRings, FEATURE_ANGLE, cellIds);
+    qDebug() << "Graph cut refine:" << cellIds.size() << "cells changed, band"
+             << m_graphCut.bandSize() << "cells, cut" << cut << "in" << timer.elapsed() << "ms";
+    return commitBufferLabels(cellIds);
+}
+
+int MeshLabelCore::transferLabelsFrom(const QString& referenceFile, double maxDistance)
+{
+    if (!m_polyData) {
+        m_lastError = "没有网格数据";
+        return -1;
+    }
+    if (!requireCellLabels()) {
+        return -1;
+    }
+    if (referenceFile.isEmpty()) {
+        m_lastError = "文件名为空";
+        return -1;
+    }
+    if (!QFileInfo(referenceFile).exists()) {
+        m_lastError = QString("文件不存在: %1").arg(referenceFile);
+        return -1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(referenceFile.toLocal8Bit().data());
+    reader->Update();
+    vtkPolyData* reference = reader->GetOutput();
+    if (!reference || reference->GetNumberOfPoints() == 0 || !reference->GetPolys()
+        || reference->GetPolys()->GetNumberOfCells() == 0) {
+        m_lastError = QString("无法加载VTP文件: %1").arg(referenceFile);
+        return -1;
+    }
+    vtkDataArray* referenceScalars = reference->GetCellData()->GetScalars();
+    if (!referenceScalars) {
+        referenceScalars = reference->GetCellData()->GetArray("Label");
+    }
+    if (!referenceScalars || referenceScalars->GetNumberOfTuples() < reference->GetNumberOfCells()) {
+        m_lastError = QString("参考网格没有标签数据: %1").arg(referenceFile);
+        return -1;
+    }
+    // 先读成整数数组：vtkDataArray::GetTuple1 使用内部缓冲区，不能多线程调用
+    std::vector<int> referenceLabels(reference->GetNumberOfCells());
+    for (vtkIdType i = 0; i < reference->GetNumberOfCells(); ++i) {
+        referenceLabels[i] = static_cast<int>(referenceScalars->GetTuple1(i));
+    }
+    // 参考网格的标签可以超出当前容量（超出上限的标签不迁移），确有单元改变时才扩大容量
+    const int referenceMax = referenceLabels.empty()
+        ? -1 : *std::max_element(referenceLabels.begin(), referenceLabels.end());
+    const int referenceCapacity = std::min(referenceMax + 1, static_cast<int>(MAX_LABEL_CAPACITY));
+    const int transferCapacity = std::max(m_labelCapacity, referenceCapacity);
+
+    // 参考网格的多边形扇形三角化后建 BVH，三角形编号记为参考单元ID
+    vtkPoints* referencePoints = reference->GetPoints();
+    std::vector<float> vertices(3 * static_cast<size_t>(referencePoints->GetNumberOfPoints()));
+    for (vtkIdType i = 0; i < referencePoints->GetNumberOfPoints(); ++i) {
+        double p[3];
+        referencePoints->GetPoint(i, p);
+        for (int k = 0; k < 3; ++k) {
+            vertices[3 * i + k] = static_cast<float>(p[k]);
+        }
+    }
+    std::vector<int> triangles;
+    std::vector<int> triangleIds;
+    triangles.reserve(3 * static_cast<size_t>(reference->GetPolys()->GetNumberOfCells()));
+    triangleIds.reserve(reference->GetPolys()->GetNumberOfCells());
+    const vtkIdType referenceOffset = reference->GetNumberOfVerts() + reference->GetNumberOfLines();
+    vtkSmartPointer<vtkCellArrayIterator> iter =
+        vtkSmartPointer<vtkCellArrayIterator>::Take(reference->GetPolys()->NewIterator());
+    vtkIdType polyId = 0;
+    for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell(), ++polyId) {
+        vtkIdType pointCount;
+        const vtkIdType* cellPoints;
+        iter->GetCurrentCell(pointCount, cellPoints);
+        for (vtkIdType j = 2; j < pointCount; ++j) {
+            triangles.push_back(static_cast<int>(cellPoints[0]));
+            triangles.push_back(static_cast<int>(cellPoints[j - 1]));
+            triangles.push_back(static_cast<int>(cellPoints[j]));
+            triangleIds.push_back(static_cast<int>(referenceOffset + polyId));
+        }
+    }
+    TriangleBvh bvh;
+    bvh.build(vertices, triangles, triangleIds);
+    std::vector<float>().swap(vertices);
+    std::vector<int>().swap(triangles);
+    std::vector<int>().swap(triangleIds);
+    const qint64 buildTime = timer.elapsed();
+
+    // 只有多边形单元有质心；各线程独立查询，按块收集改变的单元后拼接
+    const MeshAdjacency& adjacency = meshAdjacency(true);
+    readLabels(m_labelBuffer);
+    const vtkIdType polyOffset = m_polyData->GetNumberOfVerts() + m_polyData->GetNumberOfLines();
+    const vtkIdType polyEnd = std::min<vtkIdType>(polyOffset + m_polyData->GetPolys()->GetNumberOfCells(),
+                                                  adjacency.cellCount());
+    const double maxDistance2 = maxDistance > 0.0 ? maxDistance * maxDistance : -1.0;
+    const int chunks = ParallelUtils::chunkCount(polyOffset, polyEnd);
+    std::vector<std::vector<int>> chunkCells(chunks);
+    std::vector<std::vector<int>> chunkLabels(chunks);
+    ParallelUtils::forChunks(polyOffset, polyEnd, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int chunk) {
+            vtkNew<vtkIdList> pointIds;
+            for (int cell = static_cast<int>(begin); cell < end; ++cell) {
+                // 感兴趣区域外的单元不查询最近面片
+                if (!isCellInClipBox(cell, pointIds)) {
+                    continue;
+                }
+                const float* centroid = adjacency.cellCentroid(cell);
+                const double point[3] = { centroid[0], centroid[1], centroid[2] };
+                double distance2;
+                const int referenceCell = bvh.nearest(point, &distance2);
+                if (referenceCell < 0 || (maxDistance2 >= 0.0 && distance2 > maxDistance2)) {
+                    continue;
+                }
+                const int label = referenceLabels[referenceCell];
+                if (label >= 0 && label < transferCapacity && label != m_labelBuffer[cell]
+                    && !m_protectedLabels.test(m_labelBuffer[cell])) {
+                    chunkCells[chunk].push_back(cell);
+                    chunkLabels[chunk].push_back(label);
+                }
+            }
+        });
+
+    std::vector<int> cellIds;
+    std::vector<int> newLabels;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        cellIds.insert(cellIds.end(), chunkCells[chunk].begin(), chunkCells[chunk].end());
+        newLabels.insert(newLabels.end(), chunkLabels[chunk].begin(), chunkLabels[chunk].end());
+    }
+    qDebug() << "Transferred labels from" << referenceFile << ":" << bvh.triangleCount()
+             << "reference triangles, BVH built in" << buildTime << "ms," << cellIds.size()
+             << "cells changed in" << timer.elapsed() << "ms";
+    if (cellIds.empty()) {
+        return 0;
+    }
+
+    // 扩大容量会转换标签数组的存储类型，不可撤销，所以只在迁移确实改变标签时进行
+    const int highest = *std::max_element(newLabels.begin(), newLabels.end());
+    if (highest >= m_labelCapacity) {
+        setLabelCapacity(highest + 1);
+    }
+    return commitRelabel(cellIds, newLabels);
+}
+
+void MeshLabelCore::readLabels(std::vector<int>& labels) const
+{
+    const vtkIdType cellCount = m_polyData->GetNumberOfCells();
+    labels.resize(cellCount);
+
+    vtkDataArray* scalars = m_polyData->GetCellData()->GetScalars();
+    const LabelView values(scalars);
+    if (values.isValid() && scalars->GetNumberOfTuples() >= cellCount) {
+        ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+            [&labels, &values](int64_t begin, int64_t end, int) {
+                for (int64_t i = begin; i < end; ++i) {
+                    labels[i] = values.get(i);
+                }
+            });
+        return;
+    }
+
+    for (vtkIdType i = 0; i < cellCount; ++i) {
+        labels[i] = scalars ? static_cast<int>(scalars->GetTuple1(i)) : 0;
+    }
+}
+
+const MeshAdjacency& MeshLabelCore::meshAdjacency(bool withCellGeometry)
+{
+    if (m_polyData && !m_adjacency.isBuilt()) {
+        m_adjacency.build(m_polyData);
+        qDebug() << "Built mesh adjacency:" << m_adjacency.memoryBytes() / (1024 * 1024) << "MB";
+    }
+    if (m_polyData && withCellGeometry && !m_adjacency.hasCellGeometry()) {
+        m_adjacency.buildCellGeometry(m_polyData);
+    }
+    return m_adjacency;
+}
+
+std::vector<int> MeshLabelCore::labelWithRegionGrow(int startCellId,
+                                                    const RegionGrowOptions& options, int label)
+{
+    ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+    std::vector<int> affectedCells;
+
+    if (!m_polyData || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()
+        || !isCellInClipBox(startCellId)) {
+        return affectedCells;
+    }
+
+    const MeshAdjacency& adjacency = meshAdjacency(true);
+
+    // 角度阈值预先换算为余弦，内层循环只做点积比较
+    const double degToRad = vtkMath::Pi() / 180.0;
+    const bool useFeature = options.featureAngle > 0.0;
+    const bool useNormal = options.normalAngle > 0.0;
+    const bool useCurvature = options.curvature > 0.0;
+    const double featureCos = std::cos(options.featureAngle * degToRad);
+    const double normalCos = std::cos(options.normalAngle * degToRad);
+    const float* seedNormal = adjacency.cellNormal(startCellId);
+
+    auto dot = [](const float* a, const float* b) {
+        return static_cast<double>(a[0]) * b[0] + static_cast<double>(a[1]) * b[1]
+            + static_cast<double>(a[2]) * b[2];
+    };
+
+    vtkNew<vtkIdList> pointIds;
+    auto accept = [&](int fromCell, int toCell) {
+        if (!isCellInClipBox(toCell, pointIds)) {
+            return false;
+        }
+        const float* fromNormal = adjacency.cellNormal(fromCell);
+        const float* toNormal = adjacency.cellNormal(toCell);
+        const double cosine = dot(fromNormal, toNormal);
+
+        if (useFeature && cosine < featureCos) {
+            return false;
+        }
+        if (useNormal && dot(seedNormal, toNormal) < normalCos) {
+            return false;
+        }
+        if (useCurvature) {
+            const float* a = adjacency.cellCentroid(fromCell);
+            const float* b = adjacency.cellCentroid(toCell);
+            const double dx = a[0] - b[0];
+            const double dy = a[1] - b[1];
+            const double dz = a[2] - b[2];
+            const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const double angle = std::acos(std::max(-1.0, std::min(1.0, cosine)));
+            if (distance > 0.0 && angle > options.curvature * distance) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<int> region;
+    m_regionGrower.grow(adjacency, startCellId, accept, region, options.maxCells);
+
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    affectedCells.reserve(region.size());
+    for (int cellId : region) {
+        const int cellLabel = static_cast<int>(labels->GetTuple1(cellId));
+        if (cellLabel != label && !m_protectedLabels.test(cellLabel)) {
+            affectedCells.push_back(cellId);
+        }
+    }
+
+    return affectedCells;
+}
+
+std::vector<int> MeshLabelCore::labelWithGeodesic(const double* position, int startCellId,
+                                                  double radius, int label)
+{
+    ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+    std::vector<int> affectedCells;
+
+    if (!m_polyData || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()) {
+        return affectedCells;
+    }
+
+    const MeshAdjacency& adjacency = runGeodesic(position, startCellId, radius);
+
+    std::vector<int> cells;
+    m_geodesic.collectCells(adjacency, cells);
+
+    // GetComponent 不经过共享的元组缓冲区，可在画刷流水线的工作线程上调用
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    vtkNew<vtkIdList> pointIds;
+    affectedCells.reserve(cells.size());
+    for (int cellId : cells) {
+        const int cellLabel = static_cast<int>(labels->GetComponent(cellId, 0));
+        if (cellLabel != label && !m_protectedLabels.test(cellLabel)
+            && isCellInClipBox(cellId, pointIds)) {
+            affectedCells.push_back(cellId);
+        }
+    }
+
+    return affectedCells;
+}
+
+std::vector<int> MeshLabelCore::labelPointsInSphere(const double* position, double radius,
+                                                    int label) const
+{
+    ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+    std::vector<int> affectedPoints;
+
+    if (!m_polyData || !m_pointLocator || m_labelLocation != LabelLocation::Point) {
+        return affectedPoints;
+    }
+
+    vtkNew<vtkIdList> pointIds;
+    m_pointLocator->FindPointsWithinRadius(radius, position, pointIds);
+
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    vtkPoints* points = m_polyData->GetPoints();
+    affectedPoints.reserve(pointIds->GetNumberOfIds());
+    for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i) {
+        const vtkIdType pointId = pointIds->GetId(i);
+        const int pointLabel = static_cast<int>(labels->GetComponent(pointId, 0));
+        if (pointLabel == label || m_protectedLabels.test(pointLabel)) {
+            continue;
+        }
+        double p[3];
+        points->GetPoint(pointId, p);
+        if (isPointInClipBox(p)) {
+            affectedPoints.push_back(static_cast<int>(pointId));
+        }
+    }
+
+    return affectedPoints;
+}
+
+std::vector<int> MeshLabelCore::labelPointsWithGeodesic(const double* position, int startCellId,
+                                                        double radius, int label)
+{
+    ML_PROFILE_SCOPE(ProfileStage::RegionQuery);
+
+    std::vector<int> affectedPoints;
+
+    if (!m_polyData || m_labelLocation != LabelLocation::Point
+        || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()) {
+        return affectedPoints;
+    }
+
+    runGeodesic(position, startCellId, radius);
+
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    vtkPoints* points = m_polyData->GetPoints();
+    const std::vector<int>& reached = m_geodesic.reachedVertices();
+    affectedPoints.reserve(reached.size());
+    for (int pointId : reached) {
+        const int pointLabel = static_cast<int>(labels->GetComponent(pointId, 0));
+        if (pointLabel == label || m_protectedLabels.test(pointLabel)) {
+            continue;
+        }
+        double p[3];
+        points->GetPoint(pointId, p);
+        if (isPointInClipBox(p)) {
+            affectedPoints.push_back(pointId);
+        }
+    }
+
+    return affectedPoints;
+}
+
+const MeshAdjacency& MeshLabelCore::runGeodesic(const double* position, int startCellId,
+                                                double radius)
+{
+    const MeshAdjacency& adjacency = meshAdjacency();
+
+    // 起点：拾取单元的各顶点，初始距离为拾取点到顶点的直线距离
+    // （在画刷工作线程上运行，顶点编号复制到 vtkIdList，不用单元数组共用的临时缓冲区）
+    vtkNew<vtkIdList> pointIds;
+    m_polyData->GetCellPoints(startCellId, pointIds);
+    constexpr int MAX_SEEDS = 16;
+    GeodesicSeed seeds[MAX_SEEDS];
+    int seedCount = 0;
+    for (vtkIdType i = 0; i < pointIds->GetNumberOfIds() && seedCount < MAX_SEEDS; ++i) {
+        const vtkIdType pointId = pointIds->GetId(i);
+        double point[3];
+        m_polyData->GetPoint(pointId, point);
+        seeds[seedCount++] = { static_cast<int>(pointId),
+                               std::sqrt(vtkMath::Distance2BetweenPoints(position, point)) };
+    }
+
+    m_geodesic.run(adjacency, seeds, seedCount, radius);
+    return adjacency;
+}
+
+void MeshLabelCore::labelCell(int cellId, int label)
+{
+    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+        return;
+    }
+
+    vtkDataArray* labels = m_polyData->GetCellData()->GetScalars();
+    m_statistics.moveCell(cellId, static_cast<int>(labels->GetTuple1(cellId)), label);
+    labels->SetTuple1(cellId, label);
+}
+
+void MeshLabelCore::labelCells(const std::vector<int>& cellIds, int label)
+{
+    ML_PROFILE_SCOPE(ProfileStage::ScalarUpdate);
+
+    if (!m_polyData) {
+        return;
+    }
+
+    for (int cellId : cellIds) {
+        labelCell(cellId, label);
+    }
+
+    // 有隐藏的标签时只更新这些单元的可见性标记
+    vtkUnsignedCharArray* ghosts = m_hiddenLabels.any() ? m_polyData->GetCellGhostArray() : nullptr;
+    if (ghosts) {
+        const unsigned char flag = m_hiddenLabels.test(label) ? vtkDataSetAttributes::HIDDENCELL : 0;
+        for (int cellId : cellIds) {
+            ghosts->SetValue(cellId, flag);
+        }
+        ghosts->Modified();
+    }
+
+    m_polyData->GetCellData()->Modified();
+    m_polyData->GetCellData()->GetScalars()->Modified();
+}
+
+void MeshLabelCore::paintCells(const std::vector<int>& cellIds, int label)
+{
+    if (!m_polyData || cellIds.empty() || !requireCellLabels()) {
+        return;
+    }
+
+    if (!m_strokeActive) {
+        auto command = std::make_shared<PaintCommand>(m_polyData, cellIds, label,
+                                                      &m_statistics);
+        labelCells(cellIds, label);
+        pushCommand(command);
+        return;
+    }
+
+    // 笔画中切换了标签：先提交之前的部分
+    if (m_strokeCommand && m_strokeCommand->newLabel() != label) {
+        flushStroke();
+    }
+
+    if (m_strokeCommand) {
+        m_strokeCommand->append(cellIds);
+    } else {
+        m_strokeCommand = std::make_shared<PaintCommand>(m_polyData, cellIds, label,
+                                                         &m_statistics);
+    }
+    labelCells(cellIds, label);
+}
+
+void MeshLabelCore::paintPoints(const std::vector<int>& pointIds, int label)
+{
+    if (!m_polyData || pointIds.empty() || m_labelLocation != LabelLocation::Point) {
+        return;
+    }
+
+    ML_PROFILE_SCOPE(ProfileStage::ScalarUpdate);
+
+    if (!m_strokeActive) {
+        addCommand(std::make_shared<PointPaintCommand>(m_polyData, pointIds, label,
+                                                       &m_statistics));
+        return;
+    }
+
+    // 笔画中切换了标签：先提交之前的部分
+    if (m_pointStrokeCommand && m_pointStrokeCommand->newLabel() != label) {
+        flushStroke();
+    }
+
+    if (m_pointStrokeCommand) {
+        m_pointStrokeCommand->append(pointIds);
+    } else {
+        m_pointStrokeCommand = std::make_shared<PointPaintCommand>(m_polyData, pointIds, label,
+                                                                   &m_statistics);
+    }
+
+    vtkDataArray* labels = m_polyData->GetPointData()->GetScalars();
+    for (int pointId : pointIds) {
+        labels->SetTuple1(pointId, label);
+    }
+    labels->Modified();
+    m_polyData->GetPointData()->Modified();
+    PointLabels::updateCells(m_polyData, pointIds, &m_statistics);
+    syncVisibility();
+}
+
+void MeshLabelCore::beginStroke()
+{
+    endStroke();
+    m_strokeActive = true;
+}
+
+void MeshLabelCore::endStroke()
+{
+    m_strokeActive = false;
+    flushStroke();
+}
+
+void MeshLabelCore::flushStroke()
+{
+    if (m_strokeCommand) {
+        pushCommand(m_strokeCommand);
+        m_strokeCommand.reset();
+    }
+    if (m_pointStrokeCommand) {
+        pushCommand(m_pointStrokeCommand);
+        m_pointStrokeCommand.reset();
+    }
+}
+
+void MeshLabelCore::addCommand(std::shared_ptr<LabelCommand> command)
+{
+    command->execute();
+    syncVisibility();
+    pushCommand(command);
+}
+
+void MeshLabelCore::addEditCommand(std::shared_ptr<LabelCommand> command)
+{
+    // 笔画中已有的绘制先单独提交，整体编辑自成一个撤销步骤
+    flushStroke();
+    addCommand(std::move(command));
+}
+
+int MeshLabelCore::commitRelabel(std::vector<int>& cellIds, std::vector<int>& newLabels)
+{
+    if (cellIds.empty()) {
+        return 0;
+    }
+    const int changed = static_cast<int>(cellIds.size());
+    addEditCommand(std::make_shared<RelabelCommand>(m_polyData, std::move(cellIds),
+                                                    std::move(newLabels), &m_statistics));
+    return changed;
+}
+
+int MeshLabelCore::commitBufferLabels(std::vector<int>& cellIds)
+{
+    std::vector<int> newLabels;
+    newLabels.reserve(cellIds.size());
+    for (int cellId : cellIds) {
+        newLabels.push_back(m_labelBuffer[cellId]);
+    }
+    dropProtectedCells(cellIds, newLabels);
+    return commitRelabel(cellIds, newLabels);
+}
+
+void MeshLabelCore::pushCommand(std::shared_ptr<LabelCommand> command)
+{
+    // 添加到撤销栈
+    m_undoStack.push(command);
+
+    // 清空重做栈
+    while (!m_redoStack.empty()) {
+        m_redoStack.pop();
+    }
+
+    // 限制历史大小
+    if (m_undoStack.size() > MAX_HISTORY_SIZE) {
+        // 移除最旧的命令（需要临时栈）
+        std::stack<std::shared_ptr<LabelCommand>> tempStack;
+        while (m_undoStack.size() > 1) {
+            tempStack.push(m_undoStack.top());
+            m_undoStack.pop();
+        }
+        m_undoStack.pop();  // 移除最旧的
+
+        while (!tempStack.empty()) {
+            m_undoStack.push(tempStack.top());
+            tempStack.pop();
+        }
+    }
+}
+
+bool MeshLabelCore::undo()
+{
+    endStroke();
+
+    if (m_undoStack.empty()) {
+        qDebug() << "Nothing to undo";
+        return false;
+    }
+
+    auto command = m_undoStack.top();
+    m_undoStack.pop();
+
+    command->undo();
+    syncVisibility();
+    m_redoStack.push(command);
+
+    qDebug() << "Undo:" << command->description();
+    return true;
+}
+
+bool MeshLabelCore::redo()
+{
+    endStroke();
+
+    if (m_redoStack.empty()) {
+        qDebug() << "Nothing to redo";
+        return false;
+    }
+
+    auto command = m_redoStack.top();
+    m_redoStack.pop();
+
+    command->execute();
+    syncVisibility();
+    m_undoStack.push(command);
+
+    qDebug() << "Redo:" << command->description();
+    return true;
+}
+
+void MeshLabelCore::clearHistory()
+{
+    while (!m_undoStack.empty()) {
+        m_undoStack.pop();
+    }
+    while (!m_redoStack.empty()) {
+        m_redoStack.pop();
+    }
+
+    qDebug() << "History cleared";
+}
+
+int MeshLabelCore::getCellCount() const
+{
+    return m_polyData ? m_polyData->GetNumberOfCells() : 0;
+}
+
+int MeshLabelCore::getCellLabel(int cellId) const
+{
+    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+        return -1;
+    }
+
+    return static_cast<int>(m_polyData->GetCellData()->GetScalars()->GetTuple1(cellId));
+}
+
+int MeshLabelCore::getPointCount() const
+{
+    return m_polyData ? m_polyData->GetNumberOfPoints() : 0;
+}
+
+int MeshLabelCore::getPointLabel(int pointId) const
+{
+    if (!m_polyData || m_labelLocation != LabelLocation::Point
+        || pointId < 0 || pointId >= m_polyData->GetNumberOfPoints()) {
+        return -1;
+    }
+
+    return static_cast<int>(m_polyData->GetPointData()->GetScalars()->GetTuple1(pointId));
+}
+
+std::vector<int> MeshLabelCore::getLabelStatistics() const
+{
+    if (!m_polyData) {
+        return std::vector<int>();
+    }
+
+    return m_statistics.cellCounts();
+}
+
+void MeshLabelCore::recountLabelStatistics()
+{
+    m_statistics.recount();
+}
+
+bool MeshLabelCore::verifyLabelStatistics() const
+{
+    return m_statistics.verify();
+}
+
+std::vector<LabelSummary> MeshLabelCore::labelSummaries()
+{
+    return m_statistics.summaries();
+}
+
+bool MeshLabelCore::exportLabelStatistics(const QString& filename)
+{
+    if (!m_polyData) {
+        m_lastError = "没有可导出的网格数据";
+        return false;
+    }
+
+    if (filename.isEmpty()) {
+        m_lastError = "文件名为空";
+        return false;
+    }
+
+    const std::vector<LabelSummary> summaries = labelSummaries();
+    const QByteArray content = filename.endsWith(".json", Qt::CaseInsensitive)
+        ? LabelStatistics::toJson(summaries, QFileInfo(m_currentFileName).fileName(),
+                                  m_statistics.totalArea())
+        : LabelStatistics::toCsv(summaries);
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(content) != content.size()) {
+        m_lastError = QString("导出标签统计失败: %1").arg(filename);
+        return false;
+    }
+
+    qDebug() << "Exported label statistics:" << filename;
+    return true;
+}
@@ -0,0 +1,947 @@
+/**
+ * @file meshlabelcore.h
+ * @brief 3D Mesh Labeling Tool - 无界面的标注核心（网格、标签、邻接、区域操作、历史、I/O）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef MESHLABELCORE_H
+#define MESHLABELCORE_H
+
+#include <QString>
+#include <memory>
+#include <vector>
+#include <stack>
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+#include "geodesicengine.h"
+#include "graphcutrefiner.h"
+#include "labelarray.h"
+#include "labelcomponents.h"
+#include "labelmask.h"
+#include "labelsmoother.h"
+#include "labelstatistics.h"
+#include "meshadjacency.h"
+#include "memoryreport.h"
+#include "regiongrower.h"
+#include "visitstamps.h"
+
+struct RegionGrowOptions;
+class vtkIdList;
+class vtkStaticPointLocator;
+
+/**
+ * @brief 标签存放的位置
+ */
+enum class LabelLocation {
+    Cell = 0,   ///< 单元标签（默认）：标签在单元数据中，所有工具都可用
+    Point = 1   ///< 顶点标签：标签在点数据中，单元标签由顶点多数表决得到并随之更新
+};
+
+/**
+ * @brief 标注操作命令基类（用于撤销/重做）
+ */
+class LabelCommand {
+public:
+    virtual ~LabelCommand() = default;
+
+    /**
+     * @brief 执行命令
+     */
+    virtual void execute() = 0;
+
+    /**
+     * @brief 撤销命令
+     */
+    virtual void undo() = 0;
+
+    /**
+     * @brief 获取命令描述
+     */
+    virtual QString description() const = 0;
+
+    /**
+     * @brief 撤销信息占用的内存（字节）
+     */
+    virtual size_t memoryBytes() const = 0;
+};
+
+/**
+ * @brief 绘制命令（用于撤销/重做）
+ *
+ * 一次笔画（按下到松开）中的所有绘制会合并到同一个命令中。
+ */
+class PaintCommand : public LabelCommand {
+public:
+    /**
+     * @param polyData 网格
+     * @param cellIds 受影响的单元ID列表
+     * @param newLabel 新标签值
+     * @param statistics 需要同步更新的标签统计（可为空）
+     */
+    PaintCommand(vtkSmartPointer<vtkPolyData> polyData,
+                 const std::vector<int>& cellIds,
+                 int newLabel,
+                 LabelStatistics* statistics = nullptr);
+
+    void execute() override;
+    void undo() override;
+    QString description() const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief 追加单元（记录旧标签，不执行）
+     * @param cellIds 追加的单元ID列表
+     */
+    void append(const std::vector<int>& cellIds);
+
+    /**
+     * @brief 获取新标签值
+     */
+    int newLabel() const { return m_newLabel; }
+
+private:
+    vtkSmartPointer<vtkPolyData> m_polyData;
+    std::vector<int> m_cellIds;      ///< 受影响的单元ID列表
+    std::vector<int> m_oldLabels;    ///< 旧标签值
+    int m_newLabel;                   ///< 新标签值
+    LabelStatistics* m_statistics;   ///< 标签统计（可为空）
+};
+
+/**
+ * @brief 填充命令（用于撤销/重做）
+ *
+ * 填充区域内的单元原来都是同一个标签，因此只保存单元ID和一个旧标签，
+ * 内存是 PaintCommand 的一半；执行和撤销都整批写入并整批更新统计。
+ */
+class FillCommand : public LabelCommand {
+public:
+    /**
+     * @param polyData 网格
+     * @param cellIds 区域内的单元ID列表（接管所有权）
+     * @param oldLabel 区域原来的标签
+     * @param newLabel 新标签值
+     * @param statistics 需要同步更新的标签统计（可为空）
+     */
+    FillCommand(vtkSmartPointer<vtkPolyData> polyData,
+                std::vector<int>&& cellIds,
+                int oldLabel,
+                int newLabel,
+                LabelStatistics* statistics = nullptr);
+
+    void execute() override;
+    void undo() override;
+    QString description() const override;
+    size_t memoryBytes() const override;
+
+private:
+    /**
+     * @brief 把所有单元写为指定标签
+     */
+    void apply(int fromLabel, int toLabel);
+
+    vtkSmartPointer<vtkPolyData> m_polyData;
+    std::vector<int> m_cellIds;      ///< 区域内的单元ID列表
+    int m_oldLabel;                   ///< 旧标签值
+    int m_newLabel;                   ///< 新标签值
+    LabelStatistics* m_statistics;   ///< 标签统计（可为空）
+};
+
+/**
+ * @brief 重新标注命令（每个单元各自的新标签，用于碎片合并等批量修改）
+ */
+class RelabelCommand : public LabelCommand {
+public:
+    /**
+     * @param polyData 网格
+     * @param cellIds 受影响的单元ID列表（每个单元只出现一次）
+     * @param newLabels 对应的新标签
+     * @param statistics 需要同步更新的标签统计（可为空）
+     */
+    RelabelCommand(vtkSmartPointer<vtkPolyData> polyData,
+                   std::vector<int>&& cellIds,
+                   std::vector<int>&& newLabels,
+                   LabelStatistics* statistics = nullptr);
+
+    void execute() override;
+    void undo() override;
+    QString description() const override;
+    size_t memoryBytes() const override;
+
+private:
+    /**
+     * @brief 写入标签并更新统计
+     */
+    void apply(const std::vector<int>& labels);
+
+    vtkSmartPointer<vtkPolyData> m_polyData;
+    std::vector<int> m_cellIds;      ///< 受影响的单元ID列表
+    std::vector<int> m_oldLabels;    ///< 旧标签值
+    std::vector<int> m_newLabels;    ///< 新标签值
+    LabelStatistics* m_statistics;   ///< 标签统计（可为空）
+};
+
+/**
+ * @brief 顶点绘制命令（顶点标签模式，用于撤销/重做）
+ *
+ * 与 PaintCommand 相同，一次笔画中的所有绘制合并到同一个命令中。
+ * 执行和撤销后重新计算受影响顶点相邻单元的标签（见 PointLabels::updateCells()）。
+ */
+class PointPaintCommand : public LabelCommand {
+public:
+    /**
+     * @param polyData 网格
+     * @param pointIds 受影响的顶点ID列表
+     * @param newLabel 新标签值
+     * @param statistics 需要同步更新的标签统计（可为空）
+     */
+    PointPaintCommand(vtkSmartPointer<vtkPolyData> polyData,
+                      const std::vector<int>& pointIds,
+                      int newLabel,
+                      LabelStatistics* statistics = nullptr);
+
+    void execute() override;
+    void undo() override;
+    QString description() const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief 追加顶点（记录旧标签，不执行）
+     * @param pointIds 追加的顶点ID列表
+     */
+    void append(const std::vector<int>& pointIds);
+
+    /**
+     * @brief 获取新标签值
+     */
+    int newLabel() const { return m_newLabel; }
+
+private:
+    vtkSmartPointer<vtkPolyData> m_polyData;
+    std::vector<int> m_pointIds;     ///< 受影响的顶点ID列表
+    std::vector<int> m_oldLabels;    ///< 旧标签值
+    int m_newLabel;                   ///< 新标签值
+    LabelStatistics* m_statistics;   ///< 标签统计（可为空）
+};
+
+/**
+ * @brief MeshLabeler 无界面核心类
+ *
+ * 持有网格、标签数组、邻接关系、区域操作、撤销/重做历史和文件读写，
+ * 不依赖任何渲染或窗口系统，可用于基准测试和批处理。
+ * 渲染与交互由 MeshLabeler 在其之上实现。
+ *
+ * 顶点标签模式（LabelLocation::Point）下标签存放在点数据的 Label 数组中，画刷通过点定位器
+ * 选取球内的顶点；单元标签由顶点多数表决得到并随每次绘制增量更新，因此统计、平面着色和
+ * 导出的单元标签始终一致。依赖单元标签的工具（魔棒、填充、碎片合并、平滑、图割、迁移）
+ * 只在单元标签模式下可用。
+ *
+ * 标签容量（可用的标签数）默认为 DEFAULT_LABEL_CAPACITY，最大 65536：不超过 256 时标签按
+ * 8 位存储，否则按 16 位存储（见 LabelArray）。加载的文件中有更大的标签时容量自动扩大。
+ *
+ * 锁定和隐藏的标签不会被任何编辑工具覆盖：画刷、魔棒和填充在区域查询的内层循环里
+ * 用位掩码跳过它们，批量工具（碎片合并、平滑、图割、迁移）提交前去掉这些单元。
+ * 隐藏的标签另外写入单元的 vtkGhostType 数组（HIDDENCELL），渲染和拾取跳过这些单元；
+ * 切换隐藏只重建这个每单元1字节的数组，不改动网格。分块渲染时可见性由各块自己维护
+ * （见 RenderChunks），网格上的这个数组可以关闭（setVisibilityArrayEnabled()）。
+ *
+ * 感兴趣区域（setClipBox()）是一个轴对齐的裁剪盒：至少一个顶点在盒内的单元才可编辑。
+ * 画刷 BFS、魔棒和填充在盒边界停止扩展，因此一次区域查询的工作量只与盒内的区域有关；
+ * 测地画刷和顶点画刷去掉盒外的结果，批量工具提交前与受保护标签一起去掉盒外的单元。
+ */
+class MeshLabelCore {
+public:
+    // ==================== 常量定义 ====================
+    static constexpr int DEFAULT_LABEL_CAPACITY = 20;        ///< 默认标签容量
+    static constexpr int MAX_LABEL_CAPACITY = LabelArray::MAX_CAPACITY; ///< 标签容量上限
+    static constexpr int MAX_HISTORY_SIZE = 100;             ///< 最大历史记录数
+    static constexpr double FEATURE_ANGLE = 20.0;            ///< 特征边角度（度，显示与魔棒共用）
+    static constexpr double MEMORY_BUDGET_PER_CELL = 128.0;  ///< 常驻结构的每三角形内存预算（字节）
+    static constexpr int PARALLEL_BFS_FRONTIER = 4096;       ///< 画刷 BFS 队列超过该长度后改为多线程扩展（默认）
+
+    // ==================== 构造/析构 ====================
+    MeshLabelCore();
+    ~MeshLabelCore();
+
+    MeshLabelCore(const MeshLabelCore&) = delete;
+    MeshLabelCore& operator=(const MeshLabelCore&) = delete;
+
+    // ==================== 文件操作 ====================
+    /**
+     * @brief 加载STL网格文件
+     * @param filename 文件路径
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool loadSTL(const QString& filename);
+
+    /**
+     * @brief 加载VTP网格文件（带标注数据）
+     * @param filename 文件路径
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool loadVTP(const QString& filename);
+
+    /**
+     * @brief 直接使用已有的网格数据（用于程序生成的网格）
+     * @param polyData 网格数据
+     * @return 成功返回true，失败返回false
+     */
+    bool setMesh(vtkSmartPointer<vtkPolyData> polyData);
+
+    /**
+     * @brief 保存VTP文件
+     * @param filename 文件路径
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool saveVTP(const QString& filename);
+
+    /**
+     * @brief 保存到临时文件（自动保存）
+     * @return 成功返回true，失败返回false
+     */
+    bool saveToTempFile();
+
+    /**
+     * @brief 获取最近一次错误信息
+     */
+    const QString& lastError() const { return m_lastError; }
+
+    /**
+     * @brief 获取当前文件名
+     */
+    const QString& currentFileName() const { return m_currentFileName; }
+
+    /**
+     * @brief 构建邻接关系（点到单元的链接）
+     *
+     * 加载网格时自动调用，公开以便基准测试单独测量。
+     */
+    void buildAdjacency();
+
+    /**
+     * @brief 确保编辑所需的点-单元链接已构建（已有时不重复构建）
+     */
+    void ensureEditingResources();
+
+    /**
+     * @brief 释放编辑用的结构：点-单元链接、单元数组、CSR 邻接和各算法的缓冲区
+     *
+     * 网格、标签、统计和撤销历史保留，之后的编辑操作会按需重新构建。
+     * 用于多网格会话中暂时不编辑的网格。
+     */
+    void releaseEditingResources();
+
+    /**
+     * @brief 编辑用结构占用的内存（字节，近似值）
+     */
+    size_t editingMemoryBytes() const;
+
+    /**
+     * @brief 按数据结构分项的内存占用
+     *
+     * 常驻项：顶点、单元连接、单元索引（BuildCells）、点-单元链接、标签和其它数据数组，
+     * 取自 VTK 的 GetActualMemorySize()；按需项：CSR 邻接、各算法缓冲区、标签缓冲区和撤销历史。
+     */
+    MemoryReport memoryReport() const;
+
+    // ==================== 标签位置 ====================
+    /**
+     * @brief 切换标签存放的位置（单元 <-> 顶点，并行多数表决转换）
+     *
+     * 切换到顶点标签时由单元标签计算顶点标签，再由顶点标签重新计算单元标签并重新统计；
+     * 切换回单元标签时保留当前的单元标签并移除点数据中的标签。
+     * 两种模式的撤销命令不通用，切换后清空历史。
+     * @param location 目标位置
+     * @return 成功返回true，没有网格时返回false
+     */
+    bool setLabelLocation(LabelLocation location);
+
+    /**
+     * @brief 获取标签存放的位置
+     */
+    LabelLocation labelLocation() const { return m_labelLocation; }
+
+    // ==================== 标签容量 ====================
+    /**
+     * @brief 设置标签容量（可用的标签为 0 ~ capacity-1）
+     *
+     * 存储类型随容量改变时（跨过 256）标签数组转换为 8 位或 16 位。缩小容量时清空历史
+     * （历史中可能有超出新容量的标签）。
+     * @param capacity 标签容量（1 ~ MAX_LABEL_CAPACITY）
+     * @return 成功返回true；超出范围或网格中已有不小于 capacity 的标签时返回false
+     */
+    bool setLabelCapacity(int capacity);
+
+    /**
+     * @brief 获取标签容量
+     */
+    int labelCapacity() const { return m_labelCapacity; }
+
+    /**
+     * @brief 网格中最大的标签（并行扫描；没有网格时返回-1）
+     */
+    int maxLabel() const;
+
+    /**
+     * @brief 当前是否为单元标签模式；不是时设置 lastError()（依赖单元标签的工具在执行前检查）
+     */
+    bool requireCellLabels();
+
+    // ==================== 标签锁定与隐藏 ====================
+    /**
+     * @brief 设置锁定的标签（这些标签的单元/顶点不会被编辑工具覆盖）
+     */
+    void setLockedLabels(const LabelMask& labels);
+
+    /**
+     * @brief 获取锁定的标签
+     */
+    const LabelMask& lockedLabels() const { return m_lockedLabels; }
+
+    /**
+     * @brief 设置隐藏的标签（不渲染、不可拾取，也不会被编辑工具覆盖），重建可见性数组
+     */
+    void setHiddenLabels(const LabelMask& labels);
+
+    /**
+     * @brief 获取隐藏的标签
+     */
+    const LabelMask& hiddenLabels() const { return m_hiddenLabels; }
+
+    /**
+     * @brief 标签是否受保护（锁定或隐藏）
+     */
+    bool isLabelProtected(int label) const { return m_protectedLabels.test(label); }
+
+    /**
+     * @brief 单元是否被隐藏（按单元的标签查询隐藏掩码）
+     */
+    bool isCellHidden(int cellId) const;
+
+    /**
+     * @brief 隐藏的单元数量（由标签统计求和）
+     */
+    int hiddenCellCount() const;
+
+    /**
+     * @brief 开启/关闭网格上的可见性数组（关闭时移除该数组，隐藏只影响编辑和拾取）
+     */
+    void setVisibilityArrayEnabled(bool enabled);
+
+    /**
+     * @brief 网格上的可见性数组是否开启
+     */
+    bool visibilityArrayEnabled() const { return m_visibilityArrayEnabled; }
+
+    // ==================== 感兴趣区域 ====================
+    /**
+     * @brief 设置感兴趣区域（盒外的单元和顶点不会被编辑工具修改）
+     * @param bounds 裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    void setClipBox(const double bounds[6]);
+
+    /**
+     * @brief 取消感兴趣区域
+     */
+    void clearClipBox();
+
+    /**
+     * @brief 是否设置了感兴趣区域
+     */
+    bool hasClipBox() const { return m_hasClipBox; }
+
+    /**
+     * @brief 获取裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    const double* clipBox() const { return m_clipBox; }
+
+    /**
+     * @brief 点是否在裁剪盒内（没有感兴趣区域时总是true）
+     */
+    bool isPointInClipBox(const double* point) const
+    {
+        return !m_hasClipBox
+            || (point[0] >= m_clipBox[0] && point[0] <= m_clipBox[1]
+                && point[1] >= m_clipBox[2] && point[1] <= m_clipBox[3]
+                && point[2] >= m_clipBox[4] && point[2] <= m_clipBox[5]);
+    }
+
+    /**
+     * @brief 单元是否在感兴趣区域内（任一顶点在裁剪盒内；没有感兴趣区域时总是true）
+     *
+     * 单次查询用（如拾取、起始单元）：每次调用创建一个 vtkIdList。
+     * 逐单元的循环改用带 pointIds 参数的版本。
+     */
+    bool isCellInClipBox(int cellId) const;
+
+    /**
+     * @brief 单元是否在感兴趣区域内（逐单元的循环用，不分配内存）
+     *
+     * 顶点编号用 GetCellPoints 的 vtkIdList 版本复制到调用方复用的 pointIds 中，
+     * 不经过单元数组共用的临时缓冲区，可在画刷流水线的工作线程和并行循环中调用
+     * （每个线程使用自己的 pointIds）。
+     * @param cellId 单元ID
+     * @param pointIds 复用的顶点编号缓冲区
+     */
+    bool isCellInClipBox(int cellId, vtkIdList* pointIds) const;
+
+    /**
+     * @brief 已取得顶点编号的单元是否在感兴趣区域内（区域查询的内层循环用，不再查询单元）
+     * @param npts 顶点数
+     * @param pts 顶点ID
+     */
+    bool areCellPointsInClipBox(vtkIdType npts, const vtkIdType* pts) const;
+
+    // ==================== 区域操作 ====================
+    /**
+     * @brief 检查单元是否在球体内（任一顶点在球内即视为在球内）
+     * @param position 球心位置
+     * @param radius 球半径
+     * @param cellId 单元ID
+     * @return 在球内返回true
+     */
+    bool isCellInSphere(const double* position, double radius, int cellId) const;
+
+    /**
+     * @brief 使用BFS算法收集球形区域内需要标注的单元
+     *
+     * 从起始单元出发，沿共享顶点的邻接关系扩展，
+     * 不在球内、已经是目标标签、是受保护标签（锁定、隐藏）或在感兴趣区域外的单元不会被继续扩展。
+     * 访问标记按代号复用，首次调用后每次查询只与区域大小有关。
+     * 大半径时队列超过 setParallelBfsFrontier() 设置的长度后，剩余部分由多个线程扩展
+     * （见 expandBFSParallel()），受影响的单元集合与串行相同，只是顺序不同。
+     *
+     * @param position 球心位置
+     * @param startCellId 起始单元ID
+     * @param radius 球半径
+     * @param label 目标标签
+     * @return 受影响的单元ID列表
+     */
+    std::vector<int> labelWithBFS(const double* position, int startCellId,
+                                  double radius, int label);
+
+    /**
+     * @brief 设置画刷 BFS 改为多线程扩展的队列长度
+     * @param cells 队列长度（<= 0 恢复 PARALLEL_BFS_FRONTIER），测试中调小以覆盖并行路径
+     */
+    void setParallelBfsFrontier(int cells);
+
+    /**
+     * @brief 收集测地距离半径内需要标注的单元（测地画刷）
+     *
+     * 从起始单元的顶点出发沿网格边计算有界最短路（见 GeodesicEngine），
+     * 至少一个顶点的测地距离小于半径、且不是目标标签或受保护标签的单元为受影响单元。
+     * 与 labelWithBFS 不同，空间上相近但沿表面较远的区域（相邻牙齿、褶皱）不会被选中。
+     * CSR 邻接在第一次调用时构建；要在工作线程上调用时，先在提交样本的线程上调用 meshAdjacency(true)。
+     *
+     * @param position 拾取位置
+     * @param startCellId 起始单元ID
+     * @param radius 测地半径
+     * @param label 目标标签
+     * @return 受影响的单元ID列表
+     */
+    std::vector<int> labelWithGeodesic(const double* position, int startCellId,
+                                       double radius, int label);
+
+    /**
+     * @brief 收集球内需要标注的顶点（顶点标签模式的画刷，通过点定位器查询）
+     *
+     * 只读网格和定位器，可在画刷流水线的工作线程上调用。
+     * @param position 球心位置
+     * @param radius 球半径
+     * @param label 目标标签
+     * @return 球内不是目标标签或受保护标签的顶点ID列表
+     */
+    std::vector<int> labelPointsInSphere(const double* position, double radius, int label) const;
+
+    /**
+     * @brief 收集测地距离半径内需要标注的顶点（顶点标签模式的测地画刷）
+     *
+     * 与 labelWithGeodesic 相同，在工作线程上调用前先构建 meshAdjacency(true)。
+     * @param position 拾取位置
+     * @param startCellId 起始单元ID
+     * @param radius 测地半径
+     * @param label 目标标签
+     * @return 测地距离小于半径且不是目标标签或受保护标签的顶点ID列表
+     */
+    std::vector<int> labelPointsWithGeodesic(const double* position, int startCellId,
+                                             double radius, int label);
+
+    /**
+     * @brief 魔棒：从起始单元沿共边单元生长，遇到特征边、法向或曲率超限或离开感兴趣区域时停止
+     * @param startCellId 起始单元ID
+     * @param options 停止条件
+     * @param label 目标标签
+     * @return 受影响的单元ID列表（区域内不是目标标签或受保护标签的单元）
+     */
+    std::vector<int> labelWithRegionGrow(int startCellId, const RegionGrowOptions& options,
+                                         int label);
+
+    /**
+     * @brief 填充：把起始单元所在的同标签连通区域（限于感兴趣区域内）整体改为目标标签，
+     *        作为一个撤销步骤
+     * @param startCellId 起始单元ID
+     * @param label 目标标签
+     * @return 改变的单元数量（区域已是目标标签或受保护标签时为0）
+     */
+    int bucketFill(int startCellId, int label);
+
+    /**
+     * @brief 计算所有标签区域的连通分量（并行并集查找）
+     * @return 分析结果（下次调用前有效）
+     */
+    const LabelComponents& analyzeComponents();
+
+    /**
+     * @brief 把单元数小于 minCells 的碎片合并到周围共边最多的标签，作为一个撤销步骤
+     * @param minCells 碎片阈值
+     * @return 被合并的碎片数量
+     */
+    int mergeSmallComponents(int minCells);
+
+    /**
+     * @brief 平滑标签边界（多数表决去除锯齿），作为一个撤销步骤
+     * @param iterations 最大迭代轮数
+     * @param bandRings 可修改的带宽（边界单元向外扩展的圈数）
+     * @return 改变的单元数量
+     */
+    int smoothLabelBoundaries(int iterations = LabelSmoother::DEFAULT_ITERATIONS,
+                              int bandRings = LabelSmoother::DEFAULT_BAND_RINGS);
+
+    /**
+     * @brief 图割细化：把前景与背景之间的边界吸附到特征边，作为一个撤销步骤
+     * @param foreground 前景标签
+     * @param background 背景标签
+     * @param bandRings 待定带宽（交界向两侧扩展的圈数）
+     * @return 改变的单元数量
+     */
+    int refineWithGraphCut(int foreground, int background,
+                           int bandRings = GraphCutRefiner::DEFAULT_BAND_RINGS);
+
+    /**
+     * @brief 从已标注的参考网格迁移标签：每个单元取参考网格上离其质心最近的单元的标签，
+     *        作为一个撤销步骤（用于重新扫描或重新网格化后的同一物体）；
+     *        参考网格的标签超出标签容量时自动扩大容量
+     * @param referenceFile 参考 VTP 文件（带 Label 单元数据）
+     * @param maxDistance 最大距离，超过的单元保持原标签（<= 0 不限制）
+     * @return 改变的单元数量，失败时返回-1（可通过 lastError() 获取原因）
+     */
+    int transferLabelsFrom(const QString& referenceFile, double maxDistance = 0.0);
+
+    /**
+     * @brief 获取 CSR 邻接关系（第一次调用时构建）
+     * @param withCellGeometry 是否同时需要单元法向和质心
+     */
+    const MeshAdjacency& meshAdjacency(bool withCellGeometry = false);
+
+    /**
+     * @brief 标注单个单元（不记录历史）
+     * @param cellId 单元ID
+     * @param label 标签值
+     */
+    void labelCell(int cellId, int label);
+
+    /**
+     * @brief 标注多个单元（不记录历史）
+     * @param cellIds 单元ID列表
+     * @param label 标签值
+     */
+    void labelCells(const std::vector<int>& cellIds, int label);
+
+    // ==================== 撤销/重做 ====================
+    /**
+     * @brief 标注单元并记录到历史
+     *
+     * 在 beginStroke()/endStroke() 之间的调用会合并为一个撤销步骤。
+     *
+     * @param cellIds 单元ID列表
+     * @param label 标签值
+     */
+    void paintCells(const std::vector<int>& cellIds, int label);
+
+    /**
+     * @brief 标注顶点并记录到历史（顶点标签模式）
+     *
+     * 与 paintCells() 相同，笔画中的调用合并为一个撤销步骤；相邻单元的标签随之更新。
+     *
+     * @param pointIds 顶点ID列表
+     * @param label 标签值
+     */
+    void paintPoints(const std::vector<int>& pointIds, int label);
+
+    /**
+     * @brief 开始一次笔画
+     */
+    void beginStroke();
+
+    /**
+     * @brief 结束笔画，将其作为一个命令加入历史
+     */
+    void endStroke();
+
+    /**
+     * @brief 执行命令并加入历史栈
+     * @param command 命令对象
+     */
+    void addCommand(std::shared_ptr<LabelCommand> command);
+
+    /**
+     * @brief 撤销上一步操作
+     * @return 有可撤销的操作时返回true
+     */
+    bool undo();
+
+    /**
+     * @brief 重做操作
+     * @return 有可重做的操作时返回true
+     */
+    bool redo();
+
+    /**
+     * @brief 是否可以撤销
+     */
+    bool canUndo() const { return !m_undoStack.empty(); }
+
+    /**
+     * @brief 是否可以重做
+     */
+    bool canRedo() const { return !m_redoStack.empty(); }
+
+    /**
+     * @brief 清空撤销/重做历史
+     */
+    void clearHistory();
+
+    // ==================== 查询接口 ====================
+    /**
+     * @brief 获取网格单元数量
+     */
+    int getCellCount() const;
+
+    /**
+     * @brief 获取指定单元的标签
+     * @param cellId 单元ID
+     * @return 标签值，无效单元返回-1
+     */
+    int getCellLabel(int cellId) const;
+
+    /**
+     * @brief 获取网格顶点数量
+     */
+    int getPointCount() const;
+
+    /**
+     * @brief 获取指定顶点的标签（顶点标签模式）
+     * @param pointId 顶点ID
+     * @return 标签值，无效顶点或单元标签模式下返回-1
+     */
+    int getPointLabel(int pointId) const;
+
+    /**
+     * @brief 获取每个标签的统计信息（增量维护，不扫描网格）
+     * @return 标签统计 (标签ID -> 单元数量，长度为出现过的最大标签 + 1)
+     */
+    std::vector<int> getLabelStatistics() const;
+
+    /**
+     * @brief 获取标签统计（单元数量、表面积、质心、包围盒）
+     */
+    const LabelStatistics& labelStatistics() const { return m_statistics; }
+
+    /**
+     * @brief 开启/关闭单元标签改变的记录（见 LabelStatistics::setChangeLogEnabled()）
+     */
+    void setLabelChangeLogEnabled(bool enabled) { m_statistics.setChangeLogEnabled(enabled); }
+
+    /**
+     * @brief 取出上次取出之后标签改变的单元（见 LabelStatistics::takeChanges()）
+     * @return 需要全量同步时返回true
+     */
+    bool takeLabelChanges(std::vector<int>& cellIds) { return m_statistics.takeChanges(cellIds); }
+
+    /**
+     * @brief 获取所有非空标签的完整统计（面积、质心、包围盒）
+     */
+    std::vector<LabelSummary> labelSummaries();
+
+    /**
+     * @brief 导出标签统计（按扩展名选择 .json 或 .csv）
+     * @param filename 文件路径
+     * @return 成功返回true，失败返回false（错误信息见 lastError()）
+     */
+    bool exportLabelStatistics(const QString& filename);
+
+    /**
+     * @brief 全量重新统计标签（并行）
+     */
+    void recountLabelStatistics();
+
+    /**
+     * @brief 用全量统计校验增量维护的结果
+     * @return 一致返回true
+     */
+    bool verifyLabelStatistics() const;
+
+    /**
+     * @brief 检查网格是否已加载
+     */
+    bool isMeshLoaded() const { return m_polyData != nullptr; }
+
+    /**
+     * @brief 获取网格数据
+     */
+    vtkPolyData* polyData() const { return m_polyData.Get(); }
+
+private:
+    /**
+     * @brief 初始化单元数据（全部置为标签0）
+     */
+    void initializeCellData();
+
+    /**
+     * @brief 把单元（顶点标签模式下还有顶点）标签数组转换为当前容量对应的存储类型
+     * @return 有超出容量的标签、无法转换时返回false（保留原数组）
+     */
+    bool compactLabels();
+
+    /**
+     * @brief 用顶点标签数组替换点标量，并由它重新计算全部单元标签和统计
+     * @param pointLabels 每个顶点的标签
+     */
+    void applyPointLabels(const std::vector<int>& pointLabels);
+
+    /**
+     * @brief 构建点定位器（顶点标签模式的画刷查询）
+     */
+    void buildPointLocator();
+
+    /**
+     * @brief 从拾取单元的顶点出发计算测地距离
+     * @return 计算所用的邻接关系
+     */
+    const MeshAdjacency& runGeodesic(const double* position, int startCellId, double radius);
+
+    /**
+     * @brief 将命令压入撤销栈（不执行），并限制历史大小
+     */
+    void pushCommand(std::shared_ptr<LabelCommand> command);
+
+    /**
+     * @brief 执行整体编辑的命令并加入历史：笔画中已有的绘制先单独提交，编辑自成一个撤销步骤
+     * @param command 命令对象
+     */
+    void addEditCommand(std::shared_ptr<LabelCommand> command);
+
+    /**
+     * @brief 把一组单元的新标签作为一个撤销步骤提交（批量工具的最后一步）
+     * @param cellIds 单元ID列表（提交后被移走）
+     * @param newLabels 对应的新标签（提交后被移走）
+     * @return 改变的单元数，列表为空时为0且不产生撤销步骤
+     */
+    int commitRelabel(std::vector<int>& cellIds, std::vector<int>& newLabels);
+
+    /**
+     * @brief 以 m_labelBuffer 中的标签为新标签，去掉受保护的单元后提交
+     * @param cellIds 标签缓冲区中被改写的单元
+     * @return 改变的单元数
+     */
+    int commitBufferLabels(std::vector<int>& cellIds);
+
+    /**
+     * @brief 把当前笔画已合并的绘制作为一个命令提交（笔画保持进行中）
+     */
+    void flushStroke();
+
+    /**
+     * @brief 替换当前网格并重置历史
+     */
+    void resetMesh(vtkSmartPointer<vtkPolyData> polyData, const QString& filename);
+
+    /**
+     * @brief 把所有单元的标签读入整数数组（8/16 位和 float 标签并行读取）
+     */
+    void readLabels(std::vector<int>& labels) const;
+
+    /**
+     * @brief 从串行 BFS 交接过来的队列由多个线程继续扩展
+     *
+     * 受影响的单元恰好是从起始单元出发、只经过“在球内且不是目标标签”的单元能到达的那些单元，
+     * 与扩展顺序无关，因此并行的结果集合与串行相同。
+     * 队列按线程数分段，每个线程从自己的一段出发独立做 BFS，邻居用 m_bfsVisits 原子认领，
+     * 每个单元只由认领它的线程检查；线程在每次调用中只启动一次，层与层之间不做同步。
+     * 需要可直接访问的标签数组（LabelView）和已构建的点-单元链接（串行阶段已构建）。
+     *
+     * @param position 球心位置
+     * @param radius 球半径
+     * @param label 目标标签
+     * @param frontier 尚未检查的单元（串行阶段队列的剩余部分，已被认领）
+     * @param frontierSize 单元数
+     * @param affectedCells 追加受影响的单元
+     */
+    void expandBFSParallel(const double* position, double radius, int label,
+                           const int* frontier, size_t frontierSize,
+                           std::vector<int>& affectedCells);
+
+    /**
+     * @brief 去掉受保护标签和感兴趣区域外的单元（批量工具提交前调用）
+     * @param cellIds 单元ID列表
+     * @param newLabels 对应的新标签
+     */
+    void dropProtectedCells(std::vector<int>& cellIds, std::vector<int>& newLabels) const;
+
+    /**
+     * @brief 按隐藏的标签重建可见性数组（并行；没有隐藏的标签或数组已关闭时移除该数组）
+     */
+    void updateVisibility();
+
+    /**
+     * @brief 标签改变后同步可见性数组（有隐藏的标签且数组开启时才重建）
+     */
+    void syncVisibility();
+
+    // ==================== 成员变量 ====================
+    vtkSmartPointer<vtkPolyData> m_polyData;               ///< 网格数据
+    LabelStatistics m_statistics;                          ///< 标签统计（增量维护）
+    MeshAdjacency m_adjacency;                             ///< CSR 邻接关系（按需构建）
+    GeodesicEngine m_geodesic;                             ///< 测地距离引擎（复用缓冲区）
+    RegionGrower m_regionGrower;                           ///< 区域生长引擎（复用缓冲区）
+    VisitStamps m_bfsVisits;                               ///< 画刷 BFS 的访问标记（复用缓冲区）
+    LabelComponents m_components;                          ///< 连通分量分析（复用缓冲区）
+    LabelSmoother m_smoother;                              ///< 边界平滑（复用缓冲区）
+    GraphCutRefiner m_graphCut;                            ///< 图割细化（复用缓冲区）
+    std::vector<int> m_labelBuffer;                        ///< 标签整数副本（复用缓冲区）
+    LabelLocation m_labelLocation;                         ///< 标签存放的位置
+    int m_labelCapacity;                                   ///< 标签容量
+    int m_parallelBfsFrontier;                             ///< 画刷 BFS 改为多线程扩展的队列长度
+    vtkSmartPointer<vtkStaticPointLocator> m_pointLocator; ///< 点定位器（顶点标签模式，按需构建）
+    LabelMask m_lockedLabels;                              ///< 锁定的标签
+    LabelMask m_hiddenLabels;                              ///< 隐藏的标签
+    LabelMask m_protectedLabels;                           ///< 锁定或隐藏的标签（区域查询内层循环使用）
+    bool m_visibilityArrayEnabled;                         ///< 是否在网格上维护可见性数组
+    bool m_hasClipBox;                                     ///< 是否设置了感兴趣区域
+    double m_clipBox[6];                                   ///< 裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax）
+
+    QString m_currentFileName;                             ///< 当前文件名
+    QString m_tempFileName;                                ///< 临时文件名
+    QString m_lastError;                                   ///< 最近一次错误信息
+
+    std::stack<std::shared_ptr<LabelCommand>> m_undoStack; ///< 撤销栈
+    std::stack<std::shared_ptr<LabelCommand>> m_redoStack; ///< 重做栈
+    std::shared_ptr<PaintCommand> m_strokeCommand;          ///< 当前笔画的合并命令
+    std::shared_ptr<PointPaintCommand> m_pointStrokeCommand; ///< 当前笔画的合并命令（顶点标签模式）
+    bool m_strokeActive;                                    ///< 是否处于笔画中
+};
+
+/**
+ * @brief 魔棒区域生长的停止条件（角度单位为度，<= 0 表示不启用该条件）
+ */
+struct RegionGrowOptions {
+    double featureAngle = MeshLabelCore::FEATURE_ANGLE; ///< 相邻面片法向夹角超过该值（特征边）时不跨过
+    double normalAngle = 0.0;      ///< 与起始面片法向夹角超过该值的面片不加入
+    double curvature = 0.0;        ///< 相邻面片法向夹角 / 质心距离（弧度/单位长度）超过该值时不跨过
+    int maxCells = 0;              ///< 区域单元数上限（<= 0 不限制）
+};
+
+#endif // MESHLABELCORE_H
@@ -1,31 +1,29 @@
 /**
  * @file meshlabeler.cpp
- * @brief MeshLabeler 核心类的实现
+ * @brief MeshLabeler 渲染与交互类的实现
  */
 
 #include "meshlabeler.h"
+#include "latencyprofiler.h"
 
-#include <QTimer>
-#include <QFileInfo>
 #include <QDebug>
-#include <QDateTime>
 
-#include <queue>
-#include <unordered_set>
 #include <algorithm>
+#include <cmath>
 
-#include <vtkSTLReader.h>
-#include <vtkXMLPolyDataReader.h>
-#include <vtkXMLPolyDataWriter.h>
+#include <vtkBoxRepresentation.h>
+#include <vtkCompositeDataDisplayAttributes.h>
+#include <vtkCompositePolyDataMapper2.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
+#include <vtkTextProperty.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkCellPicker.h>
 #include <vtkSphereSource.h>
+#include <vtkMath.h>
+#include <vtkPlane.h>
 #include <vtkFeatureEdges.h>
-#include <vtkFloatArray.h>
-#include <vtkCellData.h>
-#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkNamedColors.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkAutoInit.h>
@@ -34,47 +32,6 @@ VTK_MODULE_INIT(vtkRenderingOpenGL2)
 VTK_MODULE_INIT(vtkInteractionStyle)
 VTK_MODULE_INIT(vtkRenderingFreeType)
 
-// ==================== PaintCommand 实现 ====================
-
-PaintCommand::PaintCommand(vtkSmartPointer<vtkPolyData> polyData,
-                           const std::vector<int>& cellIds,
-                           int newLabel)
-    : m_polyData(polyData)
-    , m_cellIds(cellIds)
-    , m_newLabel(newLabel)
-{
-    // 保存旧标签值
-    m_oldLabels.reserve(cellIds.size());
-    for (int cellId : cellIds) {
-        int oldLabel = static_cast<int>(
-            m_polyData->GetCellData()->GetScalars()->GetTuple1(cellId));
-        m_oldLabels.push_back(oldLabel);
-    }
-}
-
-void PaintCommand::execute()
-{
-    for (size_t i = 0; i < m_cellIds.size(); ++i) {
-        m_polyData->GetCellData()->GetScalars()->SetTuple1(m_cellIds[i], m_newLabel);
-    }
-    m_polyData->GetCellData()->Modified();
-}
-
-void PaintCommand::undo()
-{
-    for (size_t i = 0; i < m_cellIds.size(); ++i) {
-        m_polyData->GetCellData()->GetScalars()->SetTuple1(m_cellIds[i], m_oldLabels[i]);
-    }
-    m_polyData->GetCellData()->Modified();
-}
-
-QString PaintCommand::description() const
-{
-    return QString("Paint %1 cells with label %2")
-        .arg(m_cellIds.size())
-        .arg(m_newLabel);
-}
-
 // ==================== 自定义交互样式 ====================
 
 class DesignInteractorStyle : public vtkInteractorStyleTrackballCamera
@@ -125,21 +82,60 @@ void MouseWheelForwardCallback(vtkObject* caller, long unsigned int eventId,
                                void* clientData, void* callData);
 void MouseWheelBackwardCallback(vtkObject* caller, long unsigned int eventId,
                                 void* clientData, void* callData);
+void ClipBoxInteractionCallback(vtkObject* caller, long unsigned int eventId,
+                                void* clientData, void* callData);
 
 // ==================== MeshLabeler 实现 ====================
 
 MeshLabeler::MeshLabeler(QObject* parent)
     : QObject(parent)
+    , m_activePart(-1)
+    , m_activationCount(0)
+    , m_core(&m_emptyCore)
     , m_currentLabel(0)
+    , m_labelCapacity(DEFAULT_LABEL_CAPACITY)
+    , m_labelDigits(0)
     , m_editMode(EditMode::Brush)
     , m_brushRadius(DEFAULT_BRUSH_RADIUS)
+    , m_pointLabelInterpolation(true)
+    , m_chunkedRendering(false)
+    , m_hasClipBox(false)
     , m_isMousePressed(false)
-    , m_renderPending(false)
+    , m_renderScheduler([this]() { renderFrame(); })
+    , m_hasPendingSample(false)
+    , m_strokeEnding(false)
+    , m_hasLastSample(false)
+    , m_hasSkippedSample(false)
+    , m_strokeSubmitted(0)
+    , m_strokeSkipped(0)
+    , m_brushPipeline([this]() {
+          QMetaObject::invokeMethod(this, [this]() { applyBrushResults(); }, Qt::QueuedConnection);
+      })
 {
     // 初始化 VTK 对象
     m_renderer = vtkSmartPointer<vtkRenderer>::New();
     m_lookupTable = vtkSmartPointer<vtkLookupTable>::New();
     m_sphereActor = vtkSmartPointer<vtkActor>::New();
+    m_sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    m_sphereSource->SetPhiResolution(36);
+    m_sphereSource->SetThetaResolution(36);
+    vtkNew<vtkPolyDataMapper> sphereMapper;
+    sphereMapper->SetInputConnection(m_sphereSource->GetOutputPort());
+    m_sphereActor->SetMapper(sphereMapper);
+    m_sphereActor->GetProperty()->SetOpacity(0.2);
+    m_sphereActor->PickableOff();
+    m_profilerHudActor = vtkSmartPointer<vtkTextActor>::New();
+    m_profilerHudActor->GetTextProperty()->SetFontFamilyToCourier();
+    m_profilerHudActor->GetTextProperty()->SetFontSize(14);
+    m_profilerHudActor->GetTextProperty()->SetColor(0.1, 0.1, 0.1);
+    m_profilerHudActor->SetDisplayPosition(10, 10);
+    m_profilerHudActor->PickableOff();
+    std::fill(m_clipBox, m_clipBox + 6, 0.0);
+    m_clipPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+    for (int i = 0; i < 6; ++i) {
+        vtkNew<vtkPlane> plane;
+        m_clipPlanes->AddItem(plane);
+    }
 
     // 初始化颜色查找表
     initializeLookupTable();
@@ -153,6 +149,7 @@ MeshLabeler::MeshLabeler(QObject* parent)
     m_mouseMoveCallback = vtkSmartPointer<vtkCallbackCommand>::New();
     m_mouseWheelForwardCallback = vtkSmartPointer<vtkCallbackCommand>::New();
     m_mouseWheelBackwardCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    m_clipBoxCallback = vtkSmartPointer<vtkCallbackCommand>::New();
 
     // 设置回调函数和客户端数据
     m_leftButtonPressCallback->SetCallback(::LeftButtonPressCallback);
@@ -179,6 +176,9 @@ MeshLabeler::MeshLabeler(QObject* parent)
     m_mouseWheelBackwardCallback->SetCallback(::MouseWheelBackwardCallback);
     m_mouseWheelBackwardCallback->SetClientData(this);
 
+    m_clipBoxCallback->SetCallback(::ClipBoxInteractionCallback);
+    m_clipBoxCallback->SetClientData(this);
+
     qDebug() << "MeshLabeler initialized";
 }
 
@@ -189,253 +189,813 @@ MeshLabeler::~MeshLabeler()
 
 void MeshLabeler::initializeLookupTable()
 {
-    m_lookupTable->SetNumberOfTableValues(MAX_LABELS);
-    m_lookupTable->Build();
+    fillLookupTable(std::min(DEFAULT_LABEL_CAPACITY, m_labelCapacity));
+}
 
-    // 设置标签0为白色
-    m_lookupTable->SetTableValue(0, 1.0, 1.0, 1.0, 1.0);
+void MeshLabeler::fillLookupTable(int size)
+{
+    // 前 DEFAULT_LABEL_CAPACITY 个标签沿用默认色带，与查找表大小无关
+    vtkNew<vtkLookupTable> base;
+    base->SetNumberOfTableValues(DEFAULT_LABEL_CAPACITY);
+    base->Build();
+
+    m_lookupTable->SetNumberOfTableValues(size);
+    for (int label = 0; label < size; ++label) {
+        double rgba[4] = { 1.0, 1.0, 1.0, 1.0 };
+        if (label == 0) {
+            // 标签0为白色
+        } else if (label < DEFAULT_LABEL_CAPACITY) {
+            base->GetTableValue(label, rgba);
+        } else {
+            // 更多的标签按黄金角分布色相，饱和度和明度交替，相邻标签容易区分
+            const double hsv[3] = { std::fmod(0.5 + label * 0.618033988749895, 1.0),
+                                    label % 2 ? 0.65 : 0.9,
+                                    label % 3 ? 0.95 : 0.75 };
+            vtkMath::HSVToRGB(hsv, rgba);
+        }
+        m_lookupTable->SetTableValue(label, rgba);
+    }
+    m_lookupTable->BuildSpecialColors();
 
-    // 其他标签使用默认颜色
-    // 可以在这里自定义每个标签的颜色
+    for (MeshPart& part : m_parts) {
+        part.actor->GetMapper()->SetScalarRange(0, size - 1);
+    }
 }
 
-void MeshLabeler::initializeCellData()
+void MeshLabeler::ensurePalette(int labelCount)
 {
-    if (!m_polyData) {
-        qWarning() << "Cannot initialize cell data: polyData is null";
+    const int size = paletteSize();
+    if (labelCount <= size) {
         return;
     }
 
-    vtkNew<vtkFloatArray> cellData;
-    for (int i = 0; i < m_polyData->GetNumberOfCells(); ++i) {
-        cellData->InsertTuple1(i, 0);
-    }
-
-    m_polyData->GetCellData()->SetScalars(cellData);
-    m_polyData->BuildLinks();
+    fillLookupTable(std::min(std::max(labelCount, 2 * size), m_labelCapacity));
+    qDebug() << "Palette grown to" << paletteSize() << "labels";
+    emit paletteChanged();
+}
 
-    qDebug() << "Initialized" << m_polyData->GetNumberOfCells() << "cells";
+void MeshLabeler::adoptLabelCapacity(MeshLabelCore& core)
+{
+    if (core.labelCapacity() > m_labelCapacity) {
+        m_labelCapacity = core.labelCapacity();
+        for (MeshPart& part : m_parts) {
+            part.core->setLabelCapacity(m_labelCapacity);
+        }
+        m_emptyCore.setLabelCapacity(m_labelCapacity);
+        emit labelCapacityChanged(m_labelCapacity);
+    } else {
+        core.setLabelCapacity(m_labelCapacity);
+    }
+    ensurePalette(core.labelStatistics().labelCount());
 }
 
-void MeshLabeler::createFeatureEdges()
+bool MeshLabeler::setLabelCapacity(int capacity)
 {
-    if (!m_polyData) {
-        return;
+    flushBrushPipeline();
+    if (capacity < 1 || capacity > MeshLabelCore::MAX_LABEL_CAPACITY) {
+        emit errorOccurred(QString("标签容量必须在 1 ~ %1 之间").arg(MeshLabelCore::MAX_LABEL_CAPACITY));
+        return false;
     }
+    // 先检查所有网格，避免只改了一部分
+    for (const MeshPart& part : m_parts) {
+        const int highest = part.core->maxLabel();
+        if (highest >= capacity) {
+            emit errorOccurred(QString("网格中已有标签 %1，标签容量至少为 %2")
+                                   .arg(highest).arg(highest + 1));
+            return false;
+        }
+    }
+
+    for (MeshPart& part : m_parts) {
+        part.core->setLabelCapacity(capacity);
+    }
+    m_emptyCore.setLabelCapacity(capacity);
+    m_labelCapacity = capacity;
+    if (m_currentLabel >= capacity) {
+        setCurrentLabel(capacity - 1);
+    }
+    if (paletteSize() > capacity) {
+        fillLookupTable(capacity);
+        emit paletteChanged();
+    }
+
+    qDebug() << "Label capacity set to" << capacity;
+    emit labelCapacityChanged(capacity);
+    emit historyChanged();
+    emit labelStatisticsChanged();
+    requestRender();
+    return true;
+}
 
+void MeshLabeler::createFeatureEdges(MeshPart& part)
+{
     vtkNew<vtkFeatureEdges> featureEdges;
-    featureEdges->SetInputData(m_polyData);
+    featureEdges->SetInputData(part.core->polyData());
     featureEdges->BoundaryEdgesOff();
     featureEdges->FeatureEdgesOn();
-    featureEdges->SetFeatureAngle(20);
+    featureEdges->SetFeatureAngle(MeshLabelCore::FEATURE_ANGLE);
     featureEdges->ManifoldEdgesOff();
     featureEdges->NonManifoldEdgesOff();
     featureEdges->ColoringOff();
     featureEdges->Update();
 
+    // 只保留边的几何：不连接管线（网格几何不变，标签修改时不必重新提取），
+    // 也不带上过滤器复制过来的标签等数据数组
+    vtkNew<vtkPolyData> edges;
+    edges->SetPoints(featureEdges->GetOutput()->GetPoints());
+    edges->SetLines(featureEdges->GetOutput()->GetLines());
+    edges->Squeeze();
+
     vtkNew<vtkPolyDataMapper> edgeMapper;
-    edgeMapper->SetInputConnection(featureEdges->GetOutputPort());
+    edgeMapper->SetInputData(edges);
 
-    m_edgeActor = vtkSmartPointer<vtkActor>::New();
-    m_edgeActor->SetMapper(edgeMapper);
+    part.edgeActor = vtkSmartPointer<vtkActor>::New();
+    part.edgeActor->SetMapper(edgeMapper);
 
     vtkNew<vtkNamedColors> colors;
-    m_edgeActor->GetProperty()->SetColor(colors->GetColor3d("Red").GetData());
-    m_edgeActor->GetProperty()->SetLineWidth(3.0);
-    m_edgeActor->GetProperty()->SetRenderLinesAsTubes(0.5);
-    m_edgeActor->PickableOff();
+    part.edgeActor->GetProperty()->SetColor(colors->GetColor3d("Red").GetData());
+    part.edgeActor->GetProperty()->SetLineWidth(3.0);
+    part.edgeActor->GetProperty()->SetRenderLinesAsTubes(0.5);
+    part.edgeActor->PickableOff();
+    applyClipPlanes(part);
+}
 
-    if (m_renderer) {
-        m_renderer->AddActor(m_edgeActor);
+bool MeshLabeler::loadSTL(const QString& filename)
+{
+    std::unique_ptr<MeshLabelCore> core(new MeshLabelCore());
+    if (!core->loadSTL(filename)) {
+        emit errorOccurred(core->lastError());
+        return false;
     }
+
+    clearMeshes();
+    appendMesh(std::move(core), filename);
+    return true;
 }
 
-bool MeshLabeler::loadSTL(const QString& filename)
+bool MeshLabeler::loadVTP(const QString& filename)
 {
-    if (filename.isEmpty()) {
-        emit errorOccurred("文件名为空");
+    std::unique_ptr<MeshLabelCore> core(new MeshLabelCore());
+    if (!core->loadVTP(filename)) {
+        emit errorOccurred(core->lastError());
         return false;
     }
 
-    QFileInfo fileInfo(filename);
-    if (!fileInfo.exists()) {
-        emit errorOccurred(QString("文件不存在: %1").arg(filename));
+    clearMeshes();
+    appendMesh(std::move(core), filename);
+    return true;
+}
+
+bool MeshLabeler::addMesh(const QString& filename)
+{
+    std::unique_ptr<MeshLabelCore> core(new MeshLabelCore());
+    const bool loaded = filename.endsWith(".vtp", Qt::CaseInsensitive)
+        ? core->loadVTP(filename) : core->loadSTL(filename);
+    if (!loaded) {
+        emit errorOccurred(core->lastError());
         return false;
     }
 
-    vtkNew<vtkSTLReader> reader;
-    reader->SetFileName(filename.toLocal8Bit().data());
-    reader->Update();
+    appendMesh(std::move(core), filename);
+    return true;
+}
 
-    if (!reader->GetOutput() || reader->GetOutput()->GetNumberOfPoints() == 0) {
-        emit errorOccurred(QString("无法加载STL文件: %1").arg(filename));
+bool MeshLabeler::removeMesh(int index)
+{
+    if (index < 0 || index >= meshCount()) {
         return false;
     }
 
-    // 清除旧数据
+    flushBrushPipeline();
+
     if (m_renderer) {
-        m_renderer->RemoveAllViewProps();
+        m_renderer->RemoveActor(m_parts[index].actor);
+        if (m_parts[index].edgeActor) {
+            m_renderer->RemoveActor(m_parts[index].edgeActor);
+        }
     }
-    clearHistory();
+    m_parts.erase(m_parts.begin() + index);
 
-    // 加载新网格
-    m_polyData = reader->GetOutput();
-    m_currentFileName = filename;
+    if (index == m_activePart) {
+        m_activePart = -1;
+        m_core = &m_emptyCore;
+        if (!m_parts.empty()) {
+            setActiveMesh(std::min(index, meshCount() - 1));
+        } else {
+            emit activeMeshChanged(-1);
+            emit historyChanged();
+            emit labelStatisticsChanged();
+            requestRender();
+        }
+    } else if (index < m_activePart) {
+        --m_activePart;
+    }
 
-    // 初始化
-    initializeCellData();
-    createFeatureEdges();
+    emit meshListChanged();
+    qDebug() << "Removed mesh" << index << "," << meshCount() << "meshes left";
+    return true;
+}
 
-    // 创建mapper和actor
-    vtkNew<vtkPolyDataMapper> mapper;
-    mapper->SetInputData(m_polyData);
-    mapper->SetScalarRange(0, MAX_LABELS - 1);
-    mapper->SetLookupTable(m_lookupTable);
-    mapper->Update();
+void MeshLabeler::clearMeshes()
+{
+    flushBrushPipeline();
+    // 裁剪盒属于被替换的网格，不沿用到新加载的网格
+    clearClipBox();
+    if (m_renderer) {
+        m_renderer->RemoveAllViewProps();
+        if (isProfilingEnabled()) {
+            m_renderer->AddActor2D(m_profilerHudActor);
+        }
+    }
+    m_parts.clear();
+    m_activePart = -1;
+    m_core = &m_emptyCore;
+}
+
+void MeshLabeler::appendMesh(std::unique_ptr<MeshLabelCore> core, const QString& filename)
+{
+    MeshPart part;
+    part.core = std::move(core);
 
-    m_polyDataActor = vtkSmartPointer<vtkActor>::New();
-    m_polyDataActor->SetMapper(mapper);
-    m_polyDataActor->GetProperty()->SetOpacity(1.0);
-    m_polyDataActor->GetProperty()->EdgeVisibilityOff();
+    part.actor = vtkSmartPointer<vtkActor>::New();
+    part.actor->GetProperty()->SetOpacity(1.0);
+    part.actor->GetProperty()->EdgeVisibilityOff();
+    applyRenderMode(part);
 
     if (m_renderer) {
-        m_renderer->AddActor(m_polyDataActor);
+        m_renderer->AddActor(part.actor);
 
         vtkNew<vtkNamedColors> colors;
         m_renderer->SetBackground(colors->GetColor3d("AliceBlue").GetData());
     }
 
+    m_parts.push_back(std::move(part));
+    m_parts.back().core->setLockedLabels(m_lockedLabels);
+    m_parts.back().core->setHiddenLabels(m_hiddenLabels);
+    if (m_hasClipBox) {
+        m_parts.back().core->setClipBox(m_clipBox);
+    }
+    adoptLabelCapacity(*m_parts.back().core);
+    emit meshListChanged();
+
+    setActiveMesh(meshCount() - 1);
     emit meshLoaded(filename);
+}
+
+void MeshLabeler::setActiveMesh(int index)
+{
+    if (index < 0 || index >= meshCount()) {
+        qWarning() << "Invalid mesh index:" << index;
+        return;
+    }
+    if (index == m_activePart) {
+        return;
+    }
+    flushBrushPipeline();
+
+    // 旧的当前网格：结束笔画，隐藏面片边和特征边（结构是否保留由 releaseIdleMeshes 决定）
+    if (m_activePart >= 0) {
+        MeshPart& previous = m_parts[m_activePart];
+        previous.core->endStroke();
+        previous.actor->GetProperty()->EdgeVisibilityOff();
+        if (previous.edgeActor && m_renderer) {
+            m_renderer->RemoveActor(previous.edgeActor);
+        }
+    }
+    if (m_renderer && m_sphereActor) {
+        m_renderer->RemoveActor(m_sphereActor);
+    }
+
+    m_activePart = index;
+    MeshPart& part = m_parts[index];
+    part.lastActive = ++m_activationCount;
+    m_core = part.core.get();
+
+    // 编辑结构按需构建：点-单元链接和特征边在这里，CSR 邻接在第一次区域操作时
+    m_core->ensureEditingResources();
+    ensureModeResources();
+    if (!part.edgeActor) {
+        createFeatureEdges(part);
+    }
+    if (m_renderer) {
+        m_renderer->AddActor(part.edgeActor);
+    }
+    part.actor->GetProperty()->SetEdgeVisibility(m_editMode == EditMode::Single);
+
+    releaseIdleMeshes();
+
+    qDebug() << "Active mesh:" << index << m_core->currentFileName();
+    emit activeMeshChanged(index);
+    emit historyChanged();
+    emit labelStatisticsChanged();
     requestRender();
+}
 
-    qDebug() << "Loaded STL file:" << filename;
-    qDebug() << "Points:" << m_polyData->GetNumberOfPoints();
-    qDebug() << "Cells:" << m_polyData->GetNumberOfCells();
+void MeshLabeler::ensureModeResources()
+{
+    if (m_editMode == EditMode::GeodesicBrush) {
+        m_core->meshAdjacency(true);
+    }
+}
 
-    return true;
+void MeshLabeler::releaseIdleMeshes()
+{
+    std::vector<MeshPart*> idle;
+    for (int i = 0; i < meshCount(); ++i) {
+        if (i != m_activePart
+            && (m_parts[i].edgeActor || m_parts[i].core->editingMemoryBytes() > 0)) {
+            idle.push_back(&m_parts[i]);
+        }
+    }
+    if (static_cast<int>(idle.size()) < MAX_EDITABLE_PARTS) {
+        return;
+    }
+
+    // 最近使用的在前，超出上限的释放
+    std::sort(idle.begin(), idle.end(), [](const MeshPart* a, const MeshPart* b) {
+        return a->lastActive > b->lastActive;
+    });
+    for (size_t i = MAX_EDITABLE_PARTS - 1; i < idle.size(); ++i) {
+        qDebug() << "Releasing editing resources of" << idle[i]->core->currentFileName() << ":"
+                 << idle[i]->core->editingMemoryBytes() / (1024 * 1024) << "MB";
+        idle[i]->core->releaseEditingResources();
+        idle[i]->edgeActor = nullptr;
+    }
 }
 
-bool MeshLabeler::loadVTP(const QString& filename)
+QString MeshLabeler::meshFileName(int index) const
+{
+    if (index < 0 || index >= meshCount()) {
+        return QString();
+    }
+    return m_parts[index].core->currentFileName();
+}
+
+MemoryReport MeshLabeler::memoryReport()
 {
-    if (filename.isEmpty()) {
-        emit errorOccurred("文件名为空");
+    flushBrushPipeline();
+    MemoryReport report;
+    for (const MeshPart& part : m_parts) {
+        report.merge(part.core->memoryReport());
+
+        // 渲染端的主机内存：映射器由标签映射出的颜色和特征边几何（显存中的缓冲区不计入）
+        vtkUnsignedCharArray* colors = part.actor->GetMapper()->GetColorMapColors();
+        report.add("映射器颜色", colors ? static_cast<size_t>(colors->GetActualMemorySize()) * 1024 : 0);
+        vtkDataSet* edges = part.edgeActor ? part.edgeActor->GetMapper()->GetInput() : nullptr;
+        report.add("特征边", edges ? static_cast<size_t>(edges->GetActualMemorySize()) * 1024 : 0);
+        report.add("渲染分块", part.chunks ? part.chunks->memoryBytes() : 0);
+    }
+    return report;
+}
+
+bool MeshLabeler::ensurePickedMeshActive(vtkActor* actor)
+{
+    if (!actor || actor == getPolyDataActor()) {
+        return actor != nullptr;
+    }
+    for (int i = 0; i < meshCount(); ++i) {
+        if (m_parts[i].actor.Get() == actor) {
+            setActiveMesh(i);
+            break;
+        }
+    }
+    return false;
+}
+
+bool MeshLabeler::saveVTP(const QString& filename)
+{
+    flushBrushPipeline();
+    if (!m_core->saveVTP(filename)) {
+        emit errorOccurred(m_core->lastError());
         return false;
     }
 
-    QFileInfo fileInfo(filename);
-    if (!fileInfo.exists()) {
-        emit errorOccurred(QString("文件不存在: %1").arg(filename));
+    return true;
+}
+
+bool MeshLabeler::exportLabelStatistics(const QString& filename)
+{
+    flushBrushPipeline();
+    if (!m_core->exportLabelStatistics(filename)) {
+        emit errorOccurred(m_core->lastError());
         return false;
     }
 
-    vtkNew<vtkXMLPolyDataReader> reader;
-    reader->SetFileName(filename.toLocal8Bit().data());
-    reader->Update();
+    return true;
+}
 
-    if (!reader->GetOutput() || reader->GetOutput()->GetNumberOfPoints() == 0) {
-        emit errorOccurred(QString("无法加载VTP文件: %1").arg(filename));
+int MeshLabeler::mergeSmallComponents(int minCells)
+{
+    flushBrushPipeline();
+    if (!requireCellLabels()) {
+        return 0;
+    }
+    const int merged = m_core->mergeSmallComponents(minCells);
+    if (merged > 0) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
+    return merged;
+}
+
+int MeshLabeler::smoothLabelBoundaries(int iterations)
+{
+    flushBrushPipeline();
+    if (!requireCellLabels()) {
+        return 0;
+    }
+    const int changed = m_core->smoothLabelBoundaries(iterations);
+    if (changed > 0) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
+    return changed;
+}
+
+int MeshLabeler::refineWithGraphCut(int background)
+{
+    flushBrushPipeline();
+    if (!requireCellLabels()) {
+        return 0;
+    }
+    const int changed = m_core->refineWithGraphCut(m_currentLabel, background);
+    if (changed > 0) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
+    return changed;
+}
+
+int MeshLabeler::transferLabelsFrom(const QString& referenceFile)
+{
+    flushBrushPipeline();
+    const int capacity = m_core->labelCapacity();
+    const int changed = m_core->transferLabelsFrom(referenceFile);
+    if (m_core->labelCapacity() != capacity) {
+        // 参考网格的标签超出会话容量，核心已自动扩容：同步到会话和其它网格
+        adoptLabelCapacity(*m_core);
+    }
+    if (changed < 0) {
+        emit errorOccurred(m_core->lastError());
+    } else if (changed > 0) {
+        ensurePalette(m_core->labelStatistics().labelCount());
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
+    return changed;
+}
+
+bool MeshLabeler::setLabelLocation(LabelLocation location)
+{
+    flushBrushPipeline();
+    if (!m_core->setLabelLocation(location)) {
+        emit errorOccurred(m_core->lastError());
         return false;
     }
 
-    // 清除旧数据
-    if (m_renderer) {
-        m_renderer->RemoveAllViewProps();
+    m_hasLastSample = false;
+    m_hasSkippedSample = false;
+    if (m_activePart >= 0) {
+        applyLabelShading(m_parts[m_activePart]);
     }
-    clearHistory();
+    requestRender();
+    emit historyChanged();
+    emit labelStatisticsChanged();
+    return true;
+}
 
-    // 加载新网格
-    m_polyData = reader->GetOutput();
-    m_currentFileName = filename;
+void MeshLabeler::setPointLabelInterpolation(bool enabled)
+{
+    m_pointLabelInterpolation = enabled;
+    for (MeshPart& part : m_parts) {
+        applyLabelShading(part);
+    }
+    requestRender();
+}
 
-    // 检查是否有标签数据
-    if (!m_polyData->GetCellData()->GetScalars()) {
-        qDebug() << "No label data found, initializing...";
-        initializeCellData();
-    } else {
-        m_polyData->BuildLinks();
-        qDebug() << "Loaded existing label data";
+void MeshLabeler::setLabelLocked(int label, bool locked)
+{
+    if (label < 0 || label >= m_labelCapacity) {
+        qWarning() << "Invalid label:" << label;
+        return;
+    }
+    // 工作线程上的区域查询读取锁定掩码，先等它处理完
+    flushBrushPipeline();
+    if (!m_lockedLabels.set(label, locked)) {
+        return;
     }
 
-    createFeatureEdges();
+    for (MeshPart& part : m_parts) {
+        part.core->setLockedLabels(m_lockedLabels);
+    }
+    m_emptyCore.setLockedLabels(m_lockedLabels);
+    qDebug() << "Label" << label << (locked ? "locked" : "unlocked");
+    emit labelMasksChanged();
+}
 
-    // 创建mapper和actor
-    vtkNew<vtkPolyDataMapper> mapper;
-    mapper->SetInputData(m_polyData);
-    mapper->SetScalarRange(0, MAX_LABELS - 1);
-    mapper->SetLookupTable(m_lookupTable);
-    mapper->Update();
+void MeshLabeler::setLabelHidden(int label, bool hidden)
+{
+    if (label < 0 || label >= m_labelCapacity) {
+        qWarning() << "Invalid label:" << label;
+        return;
+    }
+    flushBrushPipeline();
+    if (!m_hiddenLabels.set(label, hidden)) {
+        return;
+    }
 
-    m_polyDataActor = vtkSmartPointer<vtkActor>::New();
-    m_polyDataActor->SetMapper(mapper);
-    m_polyDataActor->GetProperty()->SetOpacity(1.0);
-    m_polyDataActor->GetProperty()->EdgeVisibilityOff();
+    // 每个网格只重建每单元1字节的可见性数组，映射器随之重建索引缓冲区；
+    // 分块渲染时只更新含该标签的块
+    for (MeshPart& part : m_parts) {
+        part.core->setHiddenLabels(m_hiddenLabels);
+        if (part.chunks) {
+            part.chunks->setHiddenLabels(m_hiddenLabels);
+        }
+    }
+    m_emptyCore.setHiddenLabels(m_hiddenLabels);
+    qDebug() << "Label" << label << (hidden ? "hidden" : "shown");
+    emit labelMasksChanged();
+    requestRender();
+}
 
-    if (m_renderer) {
-        m_renderer->AddActor(m_polyDataActor);
+void MeshLabeler::showAllLabels()
+{
+    if (!m_hiddenLabels.any()) {
+        return;
+    }
 
-        vtkNew<vtkNamedColors> colors;
-        m_renderer->SetBackground(colors->GetColor3d("AliceBlue").GetData());
+    flushBrushPipeline();
+    m_hiddenLabels.clear();
+    for (MeshPart& part : m_parts) {
+        part.core->setHiddenLabels(m_hiddenLabels);
+        if (part.chunks) {
+            part.chunks->setHiddenLabels(m_hiddenLabels);
+        }
     }
+    m_emptyCore.setHiddenLabels(m_hiddenLabels);
+    emit labelMasksChanged();
+    requestRender();
+}
 
-    emit meshLoaded(filename);
+int MeshLabeler::pickedCellId(vtkCellPicker* picker) const
+{
+    int cellId = static_cast<int>(picker->GetCellId());
+    if (cellId < 0) {
+        return -1;
+    }
+
+    for (const MeshPart& part : m_parts) {
+        if (part.actor.Get() != picker->GetActor()) {
+            continue;
+        }
+        if (part.chunks) {
+            // 复合数据集上拾取到的是块内的单元编号
+            const int chunk = part.chunks->chunkIndex(picker->GetDataSet());
+            if (chunk < 0 || !part.chunks->isChunkVisible(chunk)) {
+                return -1;
+            }
+            cellId = part.chunks->globalCellId(chunk, cellId);
+        }
+        return cellId >= 0 && !part.core->isCellHidden(cellId) && part.core->isCellInClipBox(cellId)
+            ? cellId : -1;
+    }
+    return cellId;
+}
+
+void MeshLabeler::setChunkedRendering(bool enabled)
+{
+    if (enabled == m_chunkedRendering) {
+        return;
+    }
+
+    flushBrushPipeline();
+    m_chunkedRendering = enabled;
+    for (MeshPart& part : m_parts) {
+        applyRenderMode(part);
+    }
+    qDebug() << "Chunked rendering:" << (enabled ? "on" : "off");
     requestRender();
+}
 
-    qDebug() << "Loaded VTP file:" << filename;
-    qDebug() << "Points:" << m_polyData->GetNumberOfPoints();
-    qDebug() << "Cells:" << m_polyData->GetNumberOfCells();
+void MeshLabeler::applyRenderMode(MeshPart& part)
+{
+    MeshLabelCore& core = *part.core;
+    vtkSmartPointer<vtkPolyDataMapper> mapper;
+    if (m_chunkedRendering) {
+        // 隐藏由各块维护，网格上的可见性数组不再需要；标签改变由核心记录，渲染前按块同步
+        core.setVisibilityArrayEnabled(false);
+        core.setLabelChangeLogEnabled(true);
+        part.chunks.reset(new RenderChunks);
+        part.chunks->setHiddenLabels(m_hiddenLabels);
+        part.chunks->build(core.polyData());
+        part.chunks->setClipBox(m_hasClipBox ? m_clipBox : nullptr);
+
+        vtkSmartPointer<vtkCompositePolyDataMapper2> composite =
+            vtkSmartPointer<vtkCompositePolyDataMapper2>::New();
+        composite->SetCompositeDataDisplayAttributes(
+            vtkSmartPointer<vtkCompositeDataDisplayAttributes>::New());
+        composite->SetInputDataObject(part.chunks->blocks());
+        mapper = composite;
+    } else {
+        core.setLabelChangeLogEnabled(false);
+        core.setVisibilityArrayEnabled(true);
+        part.chunks.reset();
+        mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        mapper->SetInputData(core.polyData());
+    }
 
-    return true;
+    // 所有网格共用同一个颜色查找表
+    mapper->SetScalarRange(0, paletteSize() - 1);
+    mapper->SetLookupTable(m_lookupTable);
+    mapper->Update();
+    part.actor->SetMapper(mapper);
+    applyLabelShading(part);
+    applyClipPlanes(part);
+    if (part.chunks) {
+        part.chunks->takeVisibilityChanged();
+        updateChunkVisibility(part);
+    }
 }
 
-bool MeshLabeler::saveVTP(const QString& filename)
+void MeshLabeler::syncRenderChunks()
 {
-    if (!m_polyData) {
-        emit errorOccurred("没有可保存的网格数据");
-        return false;
+    ML_PROFILE_SCOPE(ProfileStage::ScalarUpdate);
+
+    for (MeshPart& part : m_parts) {
+        if (!part.chunks) {
+            continue;
+        }
+        if (part.core->takeLabelChanges(m_changedCells)) {
+            part.chunks->syncAllLabels();
+        } else {
+            part.chunks->syncLabels(m_changedCells);
+        }
+        if (part.chunks->takeVisibilityChanged()) {
+            updateChunkVisibility(part);
+        }
     }
+}
 
-    if (filename.isEmpty()) {
-        emit errorOccurred("文件名为空");
-        return false;
+void MeshLabeler::updateChunkVisibility(MeshPart& part)
+{
+    vtkCompositePolyDataMapper2* mapper =
+        vtkCompositePolyDataMapper2::SafeDownCast(part.actor->GetMapper());
+    vtkCompositeDataDisplayAttributes* attributes =
+        mapper ? mapper->GetCompositeDataDisplayAttributes() : nullptr;
+    if (!attributes || !part.chunks) {
+        return;
     }
 
-    // 设置标签名称
-    m_polyData->GetCellData()->GetScalars()->SetName("Label");
-    m_polyData->GetCellData()->GetScalars()->Modified();
+    // 单元全部隐藏的块不绘制，它的缓冲区保留在显存中，重新显示时不需要上传
+    for (int i = 0; i < part.chunks->chunkCount(); ++i) {
+        attributes->SetBlockVisibility(part.chunks->chunk(i), part.chunks->isChunkVisible(i));
+    }
+    attributes->Modified();
+}
 
-    vtkNew<vtkXMLPolyDataWriter> writer;
-    writer->SetInputData(m_polyData);
-    writer->SetFileName(filename.toLocal8Bit().data());
-    writer->SetDataModeToAscii();
+void MeshLabeler::setClipBox(const double bounds[6])
+{
+    if (bounds[0] > bounds[1] || bounds[2] > bounds[3] || bounds[4] > bounds[5]) {
+        qWarning() << "Invalid clip box";
+        return;
+    }
 
-    int result = writer->Write();
-    if (result == 0) {
-        emit errorOccurred(QString("保存VTP文件失败: %1").arg(filename));
-        return false;
+    // 块是裁剪盒的空间索引：盒外的块不绘制也不参与拾取
+    setChunkedRendering(true);
+    applyClipBox(bounds);
+
+    vtkRenderWindowInteractor* interactor = m_renderWindow ? m_renderWindow->GetInteractor() : nullptr;
+    if (interactor) {
+        if (!m_clipBoxWidget) {
+            vtkNew<vtkBoxRepresentation> representation;
+            representation->SetPlaceFactor(1.0);
+            m_clipBoxWidget = vtkSmartPointer<vtkBoxWidget2>::New();
+            m_clipBoxWidget->SetRepresentation(representation);
+            // 只平移和缩放，盒始终与坐标轴对齐
+            m_clipBoxWidget->RotationEnabledOff();
+            m_clipBoxWidget->AddObserver(vtkCommand::InteractionEvent, m_clipBoxCallback);
+        }
+        m_clipBoxWidget->SetInteractor(interactor);
+        m_clipBoxWidget->GetRepresentation()->PlaceWidget(m_clipBox);
+        m_clipBoxWidget->On();
     }
 
-    m_currentFileName = filename;
-    qDebug() << "Saved VTP file:" << filename;
+    qDebug() << "Clip box:" << m_clipBox[0] << m_clipBox[1] << m_clipBox[2]
+             << m_clipBox[3] << m_clipBox[4] << m_clipBox[5];
+    requestRender();
+}
 
-    return true;
+void MeshLabeler::clearClipBox()
+{
+    if (!m_hasClipBox) {
+        return;
+    }
+
+    applyClipBox(nullptr);
+    if (m_clipBoxWidget) {
+        m_clipBoxWidget->Off();
+    }
+    qDebug() << "Clip box cleared";
+    requestRender();
 }
 
-bool MeshLabeler::saveToTempFile()
+void MeshLabeler::setClipBoxEnabled(bool enabled)
 {
-    if (!m_polyData) {
-        return false;
+    if (!enabled) {
+        clearClipBox();
+        return;
+    }
+    if (m_hasClipBox || m_parts.empty()) {
+        return;
+    }
+
+    // 所有网格的包围盒，裁剪盒放在中央、边长为它的一半
+    double bounds[6];
+    m_parts.front().core->polyData()->GetBounds(bounds);
+    for (const MeshPart& part : m_parts) {
+        const double* partBounds = part.core->polyData()->GetBounds();
+        for (int axis = 0; axis < 3; ++axis) {
+            bounds[2 * axis] = std::min(bounds[2 * axis], partBounds[2 * axis]);
+            bounds[2 * axis + 1] = std::max(bounds[2 * axis + 1], partBounds[2 * axis + 1]);
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        const double center = 0.5 * (bounds[2 * axis] + bounds[2 * axis + 1]);
+        const double halfSize = 0.25 * (bounds[2 * axis + 1] - bounds[2 * axis]);
+        bounds[2 * axis] = center - halfSize;
+        bounds[2 * axis + 1] = center + halfSize;
+    }
+    setClipBox(bounds);
+}
+
+void MeshLabeler::applyClipBox(const double* bounds)
+{
+    // 工作线程上的区域查询读取裁剪盒，先等它处理完
+    flushBrushPipeline();
+    m_hasClipBox = bounds != nullptr;
+    if (bounds) {
+        std::copy(bounds, bounds + 6, m_clipBox);
+
+        // 每个面一个平面，法向朝向盒内：映射器和拾取器都保留平面的正侧
+        for (int face = 0; face < 6; ++face) {
+            const int axis = face / 2;
+            double origin[3] = { 0.0, 0.0, 0.0 };
+            double normal[3] = { 0.0, 0.0, 0.0 };
+            origin[axis] = bounds[face];
+            normal[axis] = face % 2 == 0 ? 1.0 : -1.0;
+            vtkPlane* plane = m_clipPlanes->GetItem(face);
+            plane->SetOrigin(origin);
+            plane->SetNormal(normal);
+        }
+    }
+
+    for (MeshPart& part : m_parts) {
+        if (bounds) {
+            part.core->setClipBox(bounds);
+        } else {
+            part.core->clearClipBox();
+        }
+        if (part.chunks) {
+            part.chunks->setClipBox(bounds);
+            if (part.chunks->takeVisibilityChanged()) {
+                updateChunkVisibility(part);
+            }
+        }
+        applyClipPlanes(part);
     }
+}
 
-    QString tempPath = QFileInfo(m_currentFileName).dir().path();
-    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
-    m_tempFileName = QString("%1/autosave_%2.vtp").arg(tempPath).arg(timestamp);
+void MeshLabeler::applyClipPlanes(MeshPart& part)
+{
+    // 映射器共用同一组平面对象：拖动时只改平面参数，映射器本身不变，不需要重建缓冲区
+    vtkPlaneCollection* planes = m_hasClipBox ? m_clipPlanes.Get() : nullptr;
+    part.actor->GetMapper()->SetClippingPlanes(planes);
+    if (part.edgeActor) {
+        part.edgeActor->GetMapper()->SetClippingPlanes(planes);
+    }
+}
 
-    bool result = saveVTP(m_tempFileName);
-    if (result) {
-        qDebug() << "Auto-saved to:" << m_tempFileName;
+void MeshLabeler::applyLabelShading(MeshPart& part)
+{
+    vtkMapper* mapper = part.actor->GetMapper();
+    if (!part.chunks && part.core->labelLocation() == LabelLocation::Point
+        && m_pointLabelInterpolation) {
+        // 顶点颜色在三角形内渐变（先映射颜色再插值，不会出现中间编号的标签色）
+        mapper->SetScalarModeToUsePointData();
+        mapper->InterpolateScalarsBeforeMappingOff();
+    } else {
+        // 单元标签平面着色（顶点标签模式下为多数表决得到的单元标签；块中只有单元标签的副本）
+        mapper->SetScalarModeToUseCellData();
     }
+}
 
-    return result;
+bool MeshLabeler::saveToTempFile()
+{
+    return m_core->saveToTempFile();
 }
 
 void MeshLabeler::setupRenderer(vtkRenderWindow* renderWindow)
@@ -484,28 +1044,93 @@ void MeshLabeler::initializeCallbacks()
 
 void MeshLabeler::render()
 {
-    if (m_renderWindow) {
-        m_renderWindow->Render();
+    m_renderScheduler.renderNow();
+}
+
+void MeshLabeler::renderFrame()
+{
+    syncRenderChunks();
+    if (isProfilingEnabled()) {
+        updateProfilerHud();
+    }
+
+    {
+        ML_PROFILE_SCOPE(ProfileStage::Render);
+        if (m_renderWindow) {
+            m_renderWindow->Render();
+        }
     }
-    m_renderPending = false;
 }
 
 void MeshLabeler::requestRender()
 {
-    if (!m_renderPending) {
-        m_renderPending = true;
-        QTimer::singleShot(RENDER_THROTTLE_MS, this, [this]() {
-            render();
-        });
+    m_renderScheduler.request();
+}
+
+void MeshLabeler::setMousePressed(bool pressed)
+{
+    m_isMousePressed = pressed;
+    // 笔画中放宽合并窗口，丢弃中间帧
+    m_renderScheduler.setInteractionActive(pressed);
+}
+
+void MeshLabeler::setProfilingEnabled(bool enabled)
+{
+    LatencyProfiler::instance().setEnabled(enabled);
+
+    if (m_renderer) {
+        if (enabled) {
+            m_renderer->AddActor2D(m_profilerHudActor);
+        } else {
+            m_renderer->RemoveActor2D(m_profilerHudActor);
+        }
     }
+    requestRender();
+
+    qDebug() << "Latency profiling" << (enabled ? "enabled" : "disabled");
+}
+
+bool MeshLabeler::isProfilingEnabled() const
+{
+    return LatencyProfiler::isEnabled();
+}
+
+bool MeshLabeler::exportLatencyTrace(const QString& filename)
+{
+    if (!LatencyProfiler::instance().exportChromeTrace(filename)) {
+        emit errorOccurred(QString("导出延迟统计失败: %1").arg(filename));
+        return false;
+    }
+
+    qDebug() << "Exported latency trace:" << filename;
+    return true;
+}
+
+void MeshLabeler::updateProfilerHud()
+{
+    QString text = LatencyProfiler::instance().summaryText();
+    text += QString("frame avg %1 ms, window %2 ms\n")
+        .arg(m_renderScheduler.averageFrameMs(), 0, 'f', 2)
+        .arg(m_renderScheduler.frameIntervalMs());
+    if (m_chunkedRendering) {
+        int visible = 0;
+        int total = 0;
+        for (const MeshPart& part : m_parts) {
+            visible += part.chunks ? part.chunks->visibleCellCount() : 0;
+            total += part.chunks ? part.chunks->cellCount() : 0;
+        }
+        text += QString("visible %1 / %2 triangles\n").arg(visible).arg(total);
+    }
+    m_profilerHudActor->SetInput(text.toUtf8().constData());
 }
 
 void MeshLabeler::setCurrentLabel(int label)
 {
-    if (label < 0 || label >= MAX_LABELS) {
+    if (label < 0 || label >= m_labelCapacity) {
         qWarning() << "Invalid label:" << label;
         return;
     }
+    ensurePalette(label + 1);
 
     if (m_currentLabel != label) {
         m_currentLabel = label;
@@ -514,27 +1139,46 @@ void MeshLabeler::setCurrentLabel(int label)
     }
 }
 
+void MeshLabeler::typeLabelDigit(int digit)
+{
+    int label = digit;
+    if (m_labelDigitTimer.isValid() && m_labelDigitTimer.elapsed() <= LABEL_DIGIT_TIMEOUT_MS) {
+        label = m_labelDigits * 10 + digit;
+        if (label >= m_labelCapacity) {
+            label = digit;
+        }
+    }
+    m_labelDigits = label;
+    m_labelDigitTimer.restart();
+
+    if (label < m_labelCapacity) {
+        setCurrentLabel(label);
+    }
+}
+
 void MeshLabeler::setEditMode(EditMode mode)
 {
     if (m_editMode != mode) {
+        // 上一模式的样本可能还在工作线程上读网格
+        flushBrushPipeline();
         m_editMode = mode;
+        ensureModeResources();
 
-        if (m_polyDataActor) {
-            if (mode == EditMode::Single) {
-                m_polyDataActor->GetProperty()->EdgeVisibilityOn();
-                if (m_renderer && m_sphereActor) {
-                    m_renderer->RemoveActor(m_sphereActor);
-                }
-            } else {
-                m_polyDataActor->GetProperty()->EdgeVisibilityOff();
-            }
+        if (vtkActor* actor = getPolyDataActor()) {
+            actor->GetProperty()->SetEdgeVisibility(mode == EditMode::Single);
+        }
+        if (!isBrushMode() && m_renderer && m_sphereActor) {
+            m_renderer->RemoveActor(m_sphereActor);
         }
 
         emit editModeChanged(mode);
         requestRender();
 
         qDebug() << "Edit mode changed to:"
-                 << (mode == EditMode::Brush ? "Brush" : "Single");
+                 << (mode == EditMode::Brush ? "Brush"
+                     : mode == EditMode::GeodesicBrush ? "GeodesicBrush"
+                     : mode == EditMode::MagicWand ? "MagicWand"
+                     : mode == EditMode::BucketFill ? "BucketFill" : "Single");
     }
 }
 
@@ -560,244 +1204,286 @@ void MeshLabeler::decreaseBrushRadius()
     }
 }
 
-bool MeshLabeler::isCellInSphere(double* position, int cellId) const
+void MeshLabeler::startStroke()
+{
+    // 上一笔画还没处理完的样本先写入，再开始新的笔画
+    flushBrushPipeline();
+    setMousePressed(true);
+    m_core->beginStroke();
+    m_hasLastSample = false;
+    m_hasSkippedSample = false;
+    m_strokeSubmitted = 0;
+    m_strokeSkipped = 0;
+}
+
+bool MeshLabeler::skipIfNearLastSample(int x, int y, double* position)
 {
-    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+    if (!m_hasLastSample || m_lastSample.core != m_core || m_lastSample.radius != m_brushRadius
+        || m_lastSample.label != m_currentLabel
+        || m_lastSample.geodesic != (m_editMode == EditMode::GeodesicBrush)
+        || m_lastSample.points != (m_core->labelLocation() == LabelLocation::Point)) {
         return false;
     }
 
-    vtkCell* cell = m_polyData->GetCell(cellId);
-    vtkPoints* points = cell->GetPoints();
-
-    double radiusSquared = m_brushRadius * m_brushRadius;
+    // 光标按上一个样本中心的深度反投影：只用相机矩阵，比拾取便宜得多
+    const double* center = m_lastSample.position;
+    m_renderer->SetWorldPoint(center[0], center[1], center[2], 1.0);
+    m_renderer->WorldToDisplay();
+    const double depth = m_renderer->GetDisplayPoint()[2];
+    m_renderer->SetDisplayPoint(x, y, depth);
+    m_renderer->DisplayToWorld();
+    const double* world = m_renderer->GetWorldPoint();
+    std::copy(world, world + 3, position);
 
-    for (int i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double* pt = points->GetPoint(i);
-        double distSquared = vtkMath::Distance2BetweenPoints(position, pt);
-        if (distSquared < radiusSquared) {
-            return true;
-        }
+    const double spacing = STROKE_SAMPLE_SPACING * m_brushRadius;
+    if (vtkMath::Distance2BetweenPoints(position, center) >= spacing * spacing) {
+        return false;
     }
-
-    return false;
+    ++m_strokeSkipped;
+    m_skippedPosition[0] = x;
+    m_skippedPosition[1] = y;
+    m_hasSkippedSample = true;
+    return true;
 }
 
-std::vector<int> MeshLabeler::labelWithBFS(double* position, int startCellId)
+void MeshLabeler::sampleStroke(const double* position, int startCellId)
 {
-    std::vector<int> affectedCells;
-
-    if (!m_polyData || startCellId < 0 || startCellId >= m_polyData->GetNumberOfCells()) {
-        return affectedCells;
-    }
-
-    std::queue<int> queue;
-    std::unordered_set<int> visited;
-
-    queue.push(startCellId);
-    visited.insert(startCellId);
-
-    while (!queue.empty()) {
-        int cellId = queue.front();
-        queue.pop();
-
-        // 检查是否在球体内
-        if (!isCellInSphere(position, cellId)) {
-            continue;
-        }
-
-        // 检查是否已经是目标标签
-        int currentLabel = static_cast<int>(
-            m_polyData->GetCellData()->GetScalars()->GetTuple1(cellId));
-
-        if (currentLabel == m_currentLabel) {
-            continue;
-        }
-
-        // 标记为受影响的单元
-        affectedCells.push_back(cellId);
-
-        // 获取邻居单元
-        vtkCell* cell = m_polyData->GetCell(cellId);
-        for (int i = 0; i < cell->GetNumberOfPoints(); ++i) {
-            vtkIdType pointId = cell->GetPointId(i);
-
-            vtkNew<vtkIdList> cellIds;
-            m_polyData->GetPointCells(pointId, cellIds);
-
-            for (int j = 0; j < cellIds->GetNumberOfIds(); ++j) {
-                int neighborId = cellIds->GetId(j);
-
-                if (visited.find(neighborId) == visited.end()) {
-                    visited.insert(neighborId);
-                    queue.push(neighborId);
-                }
-            }
-        }
+    BrushSample sample;
+    sample.core = m_core;
+    std::copy(position, position + 3, sample.position);
+    sample.cellId = startCellId;
+    sample.radius = m_brushRadius;
+    sample.label = m_currentLabel;
+    sample.geodesic = m_editMode == EditMode::GeodesicBrush;
+    sample.points = m_core->labelLocation() == LabelLocation::Point;
+    m_lastSample = sample;
+    m_hasLastSample = true;
+    m_hasSkippedSample = false;
+
+    // 球形画刷从拾取的单元开始扩展，不进入已是目标标签或锁定/隐藏标签的单元：
+    // 起点是这样的单元时结果必然为空。
+    // 慢速笔画中光标大多落在上一个样本刚标注的区域里，这些样本不再计算区域。
+    // 顶点画刷直接查询球内的顶点，不适用
+    const int startLabel = m_core->getCellLabel(startCellId);
+    if (!sample.geodesic && !sample.points
+        && (startLabel == sample.label || m_core->isLabelProtected(startLabel))) {
+        ++m_strokeSkipped;
+        return;
     }
 
-    return affectedCells;
+    ++m_strokeSubmitted;
+    submitBrushSample(sample);
 }
 
-void MeshLabeler::labelCell(int cellId, int label)
+void MeshLabeler::submitBrushSample(const BrushSample& sample)
 {
-    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
+    submitPendingSample();
+    if (!m_hasPendingSample && m_brushPipeline.submit(sample)) {
         return;
     }
 
-    m_polyData->GetCellData()->GetScalars()->SetTuple1(cellId, label);
+    // 工作线程跟不上：暂存的旧样本被新样本替换
+    m_pendingSample = sample;
+    m_hasPendingSample = true;
 }
 
-void MeshLabeler::labelCells(const std::vector<int>& cellIds, int label)
+void MeshLabeler::submitPendingSample()
 {
-    for (int cellId : cellIds) {
-        labelCell(cellId, label);
+    if (m_hasPendingSample && m_brushPipeline.submit(m_pendingSample)) {
+        m_hasPendingSample = false;
     }
-
-    m_polyData->GetCellData()->Modified();
-    m_polyData->GetCellData()->GetScalars()->Modified();
 }
 
-void MeshLabeler::updateBrushSphere(double* position)
+void MeshLabeler::applyBrushResults()
 {
-    vtkNew<vtkSphereSource> sphere;
-    sphere->SetCenter(position);
-    sphere->SetRadius(m_brushRadius);
-    sphere->SetPhiResolution(36);
-    sphere->SetThetaResolution(36);
-    sphere->Update();
-
-    vtkNew<vtkPolyDataMapper> mapper;
-    mapper->SetInputConnection(sphere->GetOutputPort());
+    bool painted = false;
+    BrushResult result;
+    while (m_brushPipeline.takeResult(result)) {
+        if (result.points && !result.cellIds.empty()) {
+            result.core->paintPoints(result.cellIds, result.label);
+            painted = true;
+        } else if (!result.cellIds.empty()) {
+            result.core->paintCells(result.cellIds, result.label);
+            painted = true;
+        }
+        m_brushPipeline.acknowledge();
+    }
+    submitPendingSample();
 
-    m_sphereActor->SetMapper(mapper);
-    m_sphereActor->GetProperty()->SetOpacity(0.2);
-    m_sphereActor->GetProperty()->SetColor(m_lookupTable->GetTableValue(m_currentLabel));
-    m_sphereActor->PickableOff();
+    if (painted) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
 
-    if (m_renderer) {
-        m_renderer->AddActor(m_sphereActor);
+    if (m_strokeEnding && !m_hasPendingSample && m_brushPipeline.isIdle()) {
+        m_strokeEnding = false;
+        m_core->endStroke();
     }
 }
 
-void MeshLabeler::addCommand(std::shared_ptr<LabelCommand> command)
+void MeshLabeler::flushBrushPipeline()
 {
-    // 执行命令
-    command->execute();
-
-    // 添加到撤销栈
-    m_undoStack.push(command);
-
-    // 清空重做栈
-    while (!m_redoStack.empty()) {
-        m_redoStack.pop();
+    while (m_hasPendingSample || !m_brushPipeline.isIdle()) {
+        m_brushPipeline.waitForResult();
+        applyBrushResults();
     }
+}
 
-    // 限制历史大小
-    if (m_undoStack.size() > MAX_HISTORY_SIZE) {
-        // 移除最旧的命令（需要临时栈）
-        std::stack<std::shared_ptr<LabelCommand>> tempStack;
-        while (m_undoStack.size() > 1) {
-            tempStack.push(m_undoStack.top());
-            m_undoStack.pop();
-        }
-        m_undoStack.pop();  // 移除最旧的
-
-        while (!tempStack.empty()) {
-            m_undoStack.push(tempStack.top());
-            tempStack.pop();
+void MeshLabeler::finishStroke()
+{
+    setMousePressed(false);
+    if (m_hasSkippedSample && isBrushMode()) {
+        // 松开前最后的光标位置可能因离上一个样本太近被跳过：补拾取一次，落在网格上就提交
+        m_hasSkippedSample = false;
+        vtkNew<vtkCellPicker> picker;
+        picker->Pick(m_skippedPosition[0], m_skippedPosition[1], 0, m_renderer);
+        double position[3];
+        picker->GetPickPosition(position);
+        const int cellId = pickedCellId(picker);
+        if (cellId >= 0 && picker->GetActor() == getPolyDataActor()
+            && vtkMath::Distance2BetweenPoints(position, m_lastSample.position) > 0.0) {
+            sampleStroke(position, cellId);
         }
     }
-
-    emit historyChanged();
+    if (m_strokeSubmitted + m_strokeSkipped > 0) {
+        qDebug() << "Stroke samples:" << m_strokeSubmitted << "submitted,"
+                 << m_strokeSkipped << "skipped";
+    }
+    if (m_hasPendingSample || !m_brushPipeline.isIdle()) {
+        m_strokeEnding = true;
+        return;
+    }
+    m_core->endStroke();
 }
 
-void MeshLabeler::undo()
+void MeshLabeler::magicWand(int startCellId)
 {
-    if (m_undoStack.empty()) {
-        qDebug() << "Nothing to undo";
+    if (!requireCellLabels()) {
         return;
     }
-
-    auto command = m_undoStack.top();
-    m_undoStack.pop();
-
-    command->undo();
-    m_redoStack.push(command);
-
-    requestRender();
-    emit historyChanged();
-
-    qDebug() << "Undo:" << command->description();
+    std::vector<int> cellIds = m_core->labelWithRegionGrow(startCellId, m_regionGrowOptions,
+                                                          m_currentLabel);
+    qDebug() << "Magic wand region:" << cellIds.size() << "cells";
+    paintCells(cellIds);
 }
 
-void MeshLabeler::redo()
+void MeshLabeler::bucketFill(int startCellId)
 {
-    if (m_redoStack.empty()) {
-        qDebug() << "Nothing to redo";
+    if (!requireCellLabels()) {
         return;
     }
+    const int filled = m_core->bucketFill(startCellId, m_currentLabel);
+    qDebug() << "Bucket fill:" << filled << "cells";
+    if (filled > 0) {
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
+}
 
-    auto command = m_redoStack.top();
-    m_redoStack.pop();
-
-    command->execute();
-    m_undoStack.push(command);
+void MeshLabeler::paintCells(const std::vector<int>& cellIds)
+{
+    if (cellIds.empty()) {
+        return;
+    }
 
-    requestRender();
+    m_core->paintCells(cellIds, m_currentLabel);
     emit historyChanged();
-
-    qDebug() << "Redo:" << command->description();
+    emit labelStatisticsChanged();
 }
 
-void MeshLabeler::clearHistory()
+void MeshLabeler::paintSingle(const double* position, int cellId)
 {
-    while (!m_undoStack.empty()) {
-        m_undoStack.pop();
+    if (m_core->labelLocation() == LabelLocation::Cell) {
+        const int label = m_core->getCellLabel(cellId);
+        if (label != m_currentLabel && !m_core->isLabelProtected(label)) {
+            paintCells({cellId});
+        }
+        return;
     }
-    while (!m_redoStack.empty()) {
-        m_redoStack.pop();
+
+    // 顶点标签模式：标注拾取单元上离拾取点最近的顶点
+    vtkPolyData* polyData = m_core->polyData();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polyData->GetCellPoints(cellId, npts, pts);
+    int nearest = -1;
+    double nearestDistance2 = 0.0;
+    for (vtkIdType i = 0; i < npts; ++i) {
+        double point[3];
+        polyData->GetPoint(pts[i], point);
+        if (!m_core->isPointInClipBox(point)) {
+            continue;
+        }
+        const double distance2 = vtkMath::Distance2BetweenPoints(position, point);
+        if (nearest < 0 || distance2 < nearestDistance2) {
+            nearest = static_cast<int>(pts[i]);
+            nearestDistance2 = distance2;
+        }
     }
 
-    emit historyChanged();
-    qDebug() << "History cleared";
+    if (nearest >= 0 && m_core->getPointLabel(nearest) != m_currentLabel
+        && !m_core->isLabelProtected(m_core->getPointLabel(nearest))) {
+        m_core->paintPoints({nearest}, m_currentLabel);
+        emit historyChanged();
+        emit labelStatisticsChanged();
+    }
 }
 
-int MeshLabeler::getCellCount() const
+bool MeshLabeler::requireCellLabels()
 {
-    return m_polyData ? m_polyData->GetNumberOfCells() : 0;
+    if (m_core->requireCellLabels()) {
+        return true;
+    }
+    emit errorOccurred(m_core->lastError());
+    return false;
 }
 
-int MeshLabeler::getCellLabel(int cellId) const
+void MeshLabeler::updateBrushSphere(double* position)
 {
-    if (!m_polyData || cellId < 0 || cellId >= m_polyData->GetNumberOfCells()) {
-        return -1;
-    }
+    // 只修改参数，球面在渲染时才重新生成：两帧之间的多次悬停只生成一次，过时的位置直接被覆盖
+    m_sphereSource->SetCenter(position);
+    m_sphereSource->SetRadius(m_brushRadius);
+    m_sphereActor->GetProperty()->SetColor(m_lookupTable->GetTableValue(m_currentLabel));
 
-    return static_cast<int>(m_polyData->GetCellData()->GetScalars()->GetTuple1(cellId));
+    if (m_renderer) {
+        m_renderer->AddActor(m_sphereActor);
+    }
 }
 
-std::vector<int> MeshLabeler::getLabelStatistics() const
+void MeshLabeler::undo()
 {
-    std::vector<int> stats(MAX_LABELS, 0);
-
-    if (!m_polyData) {
-        return stats;
+    flushBrushPipeline();
+    if (m_core->undo()) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
     }
+}
 
-    for (int i = 0; i < m_polyData->GetNumberOfCells(); ++i) {
-        int label = static_cast<int>(m_polyData->GetCellData()->GetScalars()->GetTuple1(i));
-        if (label >= 0 && label < MAX_LABELS) {
-            stats[label]++;
-        }
+void MeshLabeler::redo()
+{
+    flushBrushPipeline();
+    if (m_core->redo()) {
+        requestRender();
+        emit historyChanged();
+        emit labelStatisticsChanged();
     }
+}
 
-    return stats;
+void MeshLabeler::clearHistory()
+{
+    flushBrushPipeline();
+    m_core->clearHistory();
+    emit historyChanged();
 }
 
 void MeshLabeler::performAutoSave()
 {
-    if (isMeshLoaded()) {
-        saveToTempFile();
+    // 计时器可能在笔画中触发：保存会改写单元数据的数组，工作线程这时不能在读它们
+    flushBrushPipeline();
+    for (MeshPart& part : m_parts) {
+        part.core->saveToTempFile();
     }
 }
 
@@ -806,12 +1492,14 @@ void MeshLabeler::performAutoSave()
 void LeftButtonPressCallback(vtkObject* caller, long unsigned int eventId,
                              void* clientData, void* callData)
 {
+    ML_PROFILE_SCOPE(ProfileStage::LeftButtonPress);
+
     MeshLabeler* labeler = static_cast<MeshLabeler*>(clientData);
     if (!labeler || !labeler->getPolyData()) {
         return;
     }
 
-    labeler->setMousePressed(true);
+    labeler->startStroke();
 
     vtkRenderWindowInteractor* interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
     int* pos = interactor->GetEventPosition();
@@ -819,27 +1507,35 @@ void LeftButtonPressCallback(vtkObject* caller, long unsigned int eventId,
 
     vtkNew<vtkCellPicker> picker;
     interactor->SetPicker(picker);
-    interactor->GetPicker()->Pick(pos[0], pos[1], 0, labeler->getRenderer());
+    {
+        ML_PROFILE_SCOPE(ProfileStage::Pick);
+        interactor->GetPicker()->Pick(pos[0], pos[1], 0, labeler->getRenderer());
+    }
 
     double position[3];
     picker->GetPickPosition(position);
-    int cellId = picker->GetCellId();
+    // 隐藏的单元不可拾取；分块渲染时换算成网格的单元ID
+    const int cellId = labeler->pickedCellId(picker);
+
+    if (cellId >= 0 && !labeler->ensurePickedMeshActive(picker->GetActor())) {
+        // 点击了其它网格：只切换当前网格，不标注
+        labeler->setMousePressed(false);
+        return;
+    }
 
     if (cellId >= 0) {
-        if (labeler->getEditMode() == EditMode::Brush) {
-            // 画刷模式：使用BFS
-            std::vector<int> affectedCells = labeler->labelWithBFS(position, cellId);
-            if (!affectedCells.empty()) {
-                auto command = std::make_shared<PaintCommand>(
-                    labeler->getPolyData(), affectedCells, labeler->getCurrentLabel());
-                labeler->labelCells(affectedCells, labeler->getCurrentLabel());
-                // 注意：这里不调用 addCommand，因为会重复执行
-                // 应该先创建命令但不执行，然后通过 addCommand 执行
-            }
+        if (labeler->isBrushMode()) {
+            // 画刷模式：球形 BFS 或测地距离，在工作线程上计算
+            labeler->sampleStroke(position, cellId);
+        } else if (labeler->getEditMode() == EditMode::MagicWand) {
+            // 魔棒模式：只在按下时生长一次，拖动不再标注
+            labeler->magicWand(cellId);
+        } else if (labeler->getEditMode() == EditMode::BucketFill) {
+            // 填充模式：同标签连通区域整体替换
+            labeler->bucketFill(cellId);
         } else {
             // 单点模式
-            labeler->labelCell(cellId, labeler->getCurrentLabel());
-            labeler->getPolyData()->GetCellData()->Modified();
+            labeler->paintSingle(position, cellId);
         }
 
         labeler->requestRender();
@@ -851,7 +1547,7 @@ void LeftButtonReleaseCallback(vtkObject* caller, long unsigned int eventId,
 {
     MeshLabeler* labeler = static_cast<MeshLabeler*>(clientData);
     if (labeler) {
-        labeler->setMousePressed(false);
+        labeler->finishStroke();
     }
 }
 
@@ -884,22 +1580,65 @@ void KeyPressCallback(vtkObject* caller, long unsigned int eventId,
     } else if (key == 'r') {
         // 切换到画刷模式
         labeler->setEditMode(EditMode::Brush);
+    } else if (key == 'g') {
+        // 切换到测地画刷模式
+        labeler->setEditMode(EditMode::GeodesicBrush);
+    } else if (key == 'm') {
+        // 切换到魔棒模式
+        labeler->setEditMode(EditMode::MagicWand);
+    } else if (key == 'b') {
+        // 切换到填充模式
+        labeler->setEditMode(EditMode::BucketFill);
     } else if (key >= '0' && key <= '9') {
-        // 设置标签
-        int label = key - '0';
-        labeler->setCurrentLabel(label);
+        // 设置标签（快速连续输入的数字组成多位标签号）
+        labeler->typeLabelDigit(key - '0');
+    } else if (key == '[') {
+        // 上一个标签
+        labeler->setCurrentLabel(std::max(0, labeler->getCurrentLabel() - 1));
+    } else if (key == ']') {
+        // 下一个标签
+        labeler->setCurrentLabel(std::min(labeler->labelCapacity() - 1, labeler->getCurrentLabel() + 1));
     } else if (key == 'z' && interactor->GetControlKey()) {
         // Ctrl+Z 撤销
         labeler->undo();
     } else if (key == 'y' && interactor->GetControlKey()) {
         // Ctrl+Y 重做
         labeler->redo();
+    } else if (key == 'h') {
+        // 切换延迟统计显示
+        labeler->setProfilingEnabled(!labeler->isProfilingEnabled());
+    } else if (key == 'v') {
+        // 切换顶点标签模式
+        labeler->setLabelLocation(labeler->core().labelLocation() == LabelLocation::Point
+                                      ? LabelLocation::Cell : LabelLocation::Point);
+    } else if (key == 'i') {
+        // 切换顶点标签的插值着色
+        labeler->setPointLabelInterpolation(!labeler->pointLabelInterpolation());
+    } else if (key == 'l') {
+        // 锁定/解锁当前标签
+        const int label = labeler->getCurrentLabel();
+        labeler->setLabelLocked(label, !labeler->isLabelLocked(label));
+    } else if (key == 'x') {
+        // 隐藏/显示当前标签
+        const int label = labeler->getCurrentLabel();
+        labeler->setLabelHidden(label, !labeler->isLabelHidden(label));
+    } else if (key == 'X') {
+        // 显示所有标签
+        labeler->showAllLabels();
+    } else if (key == 'c') {
+        // 切换分块渲染
+        labeler->setChunkedRendering(!labeler->isChunkedRendering());
+    } else if (key == 'o') {
+        // 显示/取消感兴趣区域（可拖动的裁剪盒）
+        labeler->setClipBoxEnabled(!labeler->hasClipBox());
     }
 }
 
 void MouseMoveCallback(vtkObject* caller, long unsigned int eventId,
                        void* clientData, void* callData)
 {
+    ML_PROFILE_SCOPE(ProfileStage::MouseMove);
+
     MeshLabeler* labeler = static_cast<MeshLabeler*>(clientData);
     if (!labeler || !labeler->getPolyData()) {
         return;
@@ -909,36 +1648,42 @@ void MouseMoveCallback(vtkObject* caller, long unsigned int eventId,
     int* pos = interactor->GetEventPosition();
     interactor->FindPokedRenderer(pos[0], pos[1]);
 
+    double position[3];
+    if (labeler->isMousePressed() && labeler->isBrushMode()
+        && labeler->skipIfNearLastSample(pos[0], pos[1], position)) {
+        // 笔画中光标离上一个样本不到最小间距：不拾取也不计算区域，只移动预览球
+        labeler->updateBrushSphere(position);
+        labeler->requestRender();
+        return;
+    }
+
     vtkNew<vtkCellPicker> picker;
     interactor->SetPicker(picker);
-    interactor->GetPicker()->Pick(pos[0], pos[1], 0, labeler->getRenderer());
+    {
+        ML_PROFILE_SCOPE(ProfileStage::Pick);
+        interactor->GetPicker()->Pick(pos[0], pos[1], 0, labeler->getRenderer());
+    }
 
-    double position[3];
     picker->GetPickPosition(position);
-    int cellId = picker->GetCellId();
+    const int cellId = labeler->pickedCellId(picker);
 
-    if (cellId == -1) {
+    if (cellId == -1 || picker->GetActor() != labeler->getPolyDataActor()) {
         return;
     }
 
-    if (labeler->getEditMode() == EditMode::Brush) {
+    if (labeler->isBrushMode()) {
         // 画刷模式：显示球体预览
         labeler->updateBrushSphere(position);
         labeler->requestRender();
 
         if (labeler->isMousePressed()) {
-            // 鼠标按下时进行标注
-            std::vector<int> affectedCells = labeler->labelWithBFS(position, cellId);
-            if (!affectedCells.empty()) {
-                labeler->labelCells(affectedCells, labeler->getCurrentLabel());
-                labeler->requestRender();
-            }
+            // 鼠标按下时进行标注：只入队，结果由 applyBrushResults() 写入并渲染
+            labeler->sampleStroke(position, cellId);
         }
     } else if (labeler->getEditMode() == EditMode::Single) {
         // 单点模式
         if (labeler->isMousePressed()) {
-            labeler->labelCell(cellId, labeler->getCurrentLabel());
-            labeler->getPolyData()->GetCellData()->Modified();
+            labeler->paintSingle(position, cellId);
             labeler->requestRender();
         }
     }
@@ -968,9 +1713,9 @@ void MouseWheelForwardCallback(vtkObject* caller, long unsigned int eventId,
 
         double position[3];
         picker->GetPickPosition(position);
-        int cellId = picker->GetCellId();
+        const int cellId = labeler->pickedCellId(picker);
 
-        if (cellId >= 0) {
+        if (cellId >= 0 && picker->GetActor() == labeler->getPolyDataActor()) {
             labeler->updateBrushSphere(position);
             labeler->requestRender();
         }
@@ -1001,11 +1746,27 @@ void MouseWheelBackwardCallback(vtkObject* caller, long unsigned int eventId,
 
         double position[3];
         picker->GetPickPosition(position);
-        int cellId = picker->GetCellId();
+        const int cellId = labeler->pickedCellId(picker);
 
-        if (cellId >= 0) {
+        if (cellId >= 0 && picker->GetActor() == labeler->getPolyDataActor()) {
             labeler->updateBrushSphere(position);
             labeler->requestRender();
         }
     }
 }
+
+void ClipBoxInteractionCallback(vtkObject* caller, long unsigned int eventId,
+                                void* clientData, void* callData)
+{
+    MeshLabeler* labeler = static_cast<MeshLabeler*>(clientData);
+    vtkBoxWidget2* widget = vtkBoxWidget2::SafeDownCast(caller);
+    if (!labeler || !widget) {
+        return;
+    }
+
+    // 盒只平移和缩放，顶点的包围盒就是裁剪盒
+    vtkNew<vtkPolyData> box;
+    static_cast<vtkBoxRepresentation*>(widget->GetRepresentation())->GetPolyData(box);
+    labeler->applyClipBox(box->GetBounds());
+    labeler->requestRender();
+}
@@ -1,6 +1,6 @@
 /**
  * @file meshlabeler.h
- * @brief 3D Mesh Labeling Tool - Core labeling engine
+ * @brief 3D Mesh Labeling Tool - 渲染与交互层（基于 MeshLabelCore）
  * @author MeshLabeler Project
  * @date 2026-01-11
  */
@@ -10,87 +10,90 @@
 
 #include <QString>
 #include <QObject>
+#include <QElapsedTimer>
 #include <memory>
 #include <vector>
-#include <stack>
+
+#include "brushpipeline.h"
+#include "meshlabelcore.h"
+#include "renderchunks.h"
+#include "renderscheduler.h"
 
 #include <vtkSmartPointer.h>
 #include <vtkPolyData.h>
 #include <vtkActor.h>
+#include <vtkBoxWidget2.h>
+#include <vtkPlaneCollection.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkLookupTable.h>
+#include <vtkSphereSource.h>
 #include <vtkCallbackCommand.h>
+#include <vtkTextActor.h>
+
+class vtkCellPicker;
 
 /**
  * @brief 编辑模式枚举
  */
 enum class EditMode {
-    Brush = 0,   ///< 画刷模式：使用球形区域进行区域标注
-    Single = 1   ///< 单点模式：单个三角形面片标注
+    Brush = 0,          ///< 画刷模式：使用球形区域进行区域标注
+    Single = 1,         ///< 单点模式：单个三角形面片标注
+    GeodesicBrush = 2,  ///< 测地画刷模式：沿表面的测地距离半径内标注
+    MagicWand = 3,      ///< 魔棒模式：从点击的面片生长到特征边/法向/曲率阈值为止
+    BucketFill = 4      ///< 填充模式：把点击的面片所在的同标签连通区域整体改为当前标签
 };
 
 /**
- * @brief 标注操作命令基类（用于撤销/重做）
+ * @brief 会话中的一个网格（如上颌、下颌或装配体的一个零件）
  */
-class LabelCommand {
-public:
-    virtual ~LabelCommand() = default;
-
-    /**
-     * @brief 执行命令
-     */
-    virtual void execute() = 0;
-
-    /**
-     * @brief 撤销命令
-     */
-    virtual void undo() = 0;
-
-    /**
-     * @brief 获取命令描述
-     */
-    virtual QString description() const = 0;
+struct MeshPart {
+    std::unique_ptr<MeshLabelCore> core;   ///< 标注核心（各自的标签、统计和撤销历史）
+    vtkSmartPointer<vtkActor> actor;       ///< 网格Actor
+    vtkSmartPointer<vtkActor> edgeActor;   ///< 特征边缘Actor（只在可编辑时构建）
+    std::unique_ptr<RenderChunks> chunks;  ///< 分块渲染数据（只在分块渲染时存在）
+    quint64 lastActive = 0;                ///< 最近一次成为当前网格的序号
 };
 
 /**
- * @brief 绘制命令（用于撤销/重做）
- */
-class PaintCommand : public LabelCommand {
-public:
-    PaintCommand(vtkSmartPointer<vtkPolyData> polyData,
-                 const std::vector<int>& cellIds,
-                 int newLabel);
-
-    void execute() override;
-    void undo() override;
-    QString description() const override;
-
-private:
-    vtkSmartPointer<vtkPolyData> m_polyData;
-    std::vector<int> m_cellIds;      ///< 受影响的单元ID列表
-    std::vector<int> m_oldLabels;    ///< 旧标签值
-    int m_newLabel;                   ///< 新标签值
-};
-
-/**
- * @brief MeshLabeler 核心类
+ * @brief MeshLabeler 渲染与交互类
+ *
+ * 在 MeshLabelCore 之上负责3D网格的显示和鼠标/键盘交互。
+ * 支持五种标注模式（EditMode）：画刷、测地画刷、魔棒、填充和单点模式。
+ * 网格数据、标注、撤销/重做和文件读写由 MeshLabelCore 完成。
+ * 画刷的区域计算在 BrushPipeline 的工作线程上进行，事件回调只拾取和入队，
+ * 结果回到 GUI 线程写入标签并请求渲染。
  *
- * 负责3D网格的加载、显示、标注和保存。
- * 支持两种标注模式：画刷模式和单点模式。
- * 提供撤销/重做、自动保存等功能。
+ * 标签容量是会话级的（所有网格相同）。颜色查找表只覆盖用到的标签：当前标签或网格中的标签
+ * 超出查找表时按倍增扩大，前 DEFAULT_LABEL_CAPACITY 个标签的颜色不随之改变。
+ * 锁定和隐藏的标签同样是会话级的，设置后同步到每个网格的核心（见 MeshLabelCore）。
+ *
+ * 分块渲染（setChunkedRendering()）时每个网格按空间分块交给复合映射器：隐藏标签只切换
+ * 块的可见性和混合块的可见性数组，绘制的三角形数随可见单元减少；标签写入由核心记录改变的单元，
+ * 每帧渲染前只同步涉及的块。
+ *
+ * 感兴趣区域（setClipBox()）是会话级的可拖动裁剪盒：网格和特征边由映射器的裁剪平面按盒裁剪，
+ * 拾取射线同样被裁剪，编辑只修改盒内的单元。盒外的块不进入复合映射器，
+ * 拖动时的绘制和拾取只与盒附近的块有关。
+ *
+ * 一个会话可以同时显示多个网格，共用颜色查找表。编辑、撤销和查询都作用于当前网格；
+ * 点-单元链接、邻接关系和特征边只在网格成为当前网格时构建，除当前网格外只保留
+ * 最近使用的 MAX_EDITABLE_PARTS - 1 个网格的这些结构，其余的释放，
+ * 因此增加网格时编辑结构占用的内存有上限。
  */
 class MeshLabeler : public QObject {
     Q_OBJECT
 
 public:
     // ==================== 常量定义 ====================
-    static constexpr int MAX_LABELS = 20;                    ///< 最大标签数量
+    static constexpr int DEFAULT_LABEL_CAPACITY = MeshLabelCore::DEFAULT_LABEL_CAPACITY; ///< 默认标签容量
     static constexpr double DEFAULT_BRUSH_RADIUS = 2.5;      ///< 默认画刷半径
     static constexpr double BRUSH_RADIUS_STEP = 0.15;        ///< 画刷半径调整步长
     static constexpr double MIN_BRUSH_RADIUS = 0.15;         ///< 最小画刷半径
-    static constexpr int RENDER_THROTTLE_MS = 16;            ///< 渲染节流时间 (60fps)
+    static constexpr double STROKE_SAMPLE_SPACING = 0.25;    ///< 笔画中相邻样本的最小间距（画刷半径的倍数）
     static constexpr int AUTO_SAVE_INTERVAL_MS = 300000;     ///< 自动保存间隔 (5分钟)
+    static constexpr int MAX_EDITABLE_PARTS = 2;             ///< 同时保留编辑结构的网格数（含当前网格）
+    static constexpr int LABEL_DIGIT_TIMEOUT_MS = 800;       ///< 多位标签号的按键间隔上限
 
     // ==================== 构造/析构 ====================
     /**
@@ -106,19 +109,33 @@ public:
 
     // ==================== 文件操作 ====================
     /**
-     * @brief 加载STL网格文件
+     * @brief 加载STL网格文件（替换会话中的所有网格）
      * @param filename 文件路径
      * @return 成功返回true，失败返回false
      */
     bool loadSTL(const QString& filename);
 
     /**
-     * @brief 加载VTP网格文件（带标注数据）
+     * @brief 加载VTP网格文件（带标注数据，替换会话中的所有网格）
      * @param filename 文件路径
      * @return 成功返回true，失败返回false
      */
     bool loadVTP(const QString& filename);
 
+    /**
+     * @brief 向会话中添加一个网格（按扩展名加载 STL/VTP），并设为当前网格
+     * @param filename 文件路径
+     * @return 成功返回true，失败返回false
+     */
+    bool addMesh(const QString& filename);
+
+    /**
+     * @brief 从会话中移除网格（未保存的标注会丢失）
+     * @param index 网格序号
+     * @return 成功返回true
+     */
+    bool removeMesh(int index);
+
     /**
      * @brief 保存VTP文件
      * @param filename 文件路径
@@ -132,6 +149,36 @@ public:
      */
     bool saveToTempFile();
 
+    // ==================== 多网格会话 ====================
+    /**
+     * @brief 会话中的网格数量
+     */
+    int meshCount() const { return static_cast<int>(m_parts.size()); }
+
+    /**
+     * @brief 当前网格序号（没有网格时为-1）
+     */
+    int activeMesh() const { return m_activePart; }
+
+    /**
+     * @brief 设置当前网格：构建它的编辑结构，并按最近使用顺序释放其它网格的编辑结构
+     * @param index 网格序号
+     */
+    void setActiveMesh(int index);
+
+    /**
+     * @brief 网格的文件名
+     * @param index 网格序号
+     */
+    QString meshFileName(int index) const;
+
+    /**
+     * @brief 所有网格的内存占用（核心结构加上特征边和映射器的颜色数组）
+     *
+     * 先等待画刷流水线处理完，工作线程不会在统计时改变缓冲区。
+     */
+    MemoryReport memoryReport();
+
     // ==================== 渲染设置 ====================
     /**
      * @brief 设置VTK渲染窗口
@@ -145,22 +192,112 @@ public:
     void initializeCallbacks();
 
     /**
-     * @brief 更新渲染
+     * @brief 立即渲染
      */
     void render();
 
     /**
-     * @brief 请求渲染（带节流）
+     * @brief 请求渲染（按实测帧耗时自适应合并，见 RenderScheduler）
      */
     void requestRender();
 
+    /**
+     * @brief 获取渲染调度器（平均帧耗时、当前合并窗口）
+     */
+    const RenderScheduler& renderScheduler() const { return m_renderScheduler; }
+
+    /**
+     * @brief 开启/关闭分块渲染（应用到所有网格）
+     *
+     * 开启时为每个网格构建 RenderChunks 并换用复合映射器，网格上的可见性数组不再维护；
+     * 顶点标签模式下按单元标签平面着色。
+     */
+    void setChunkedRendering(bool enabled);
+
+    /**
+     * @brief 是否为分块渲染
+     */
+    bool isChunkedRendering() const { return m_chunkedRendering; }
+
+    // ==================== 感兴趣区域 ====================
+    /**
+     * @brief 设置感兴趣区域（应用到所有网格）并放置可拖动的裁剪盒
+     *
+     * 块是裁剪盒的空间索引，未开启分块渲染时自动开启。
+     * @param bounds 裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    void setClipBox(const double bounds[6]);
+
+    /**
+     * @brief 取消感兴趣区域并移除裁剪盒
+     */
+    void clearClipBox();
+
+    /**
+     * @brief 开启感兴趣区域（裁剪盒放在所有网格的中央，边长为包围盒的一半）或取消
+     */
+    void setClipBoxEnabled(bool enabled);
+
+    /**
+     * @brief 是否设置了感兴趣区域
+     */
+    bool hasClipBox() const { return m_hasClipBox; }
+
+    /**
+     * @brief 获取裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    const double* clipBox() const { return m_clipBox; }
+
+    // ==================== 性能诊断 ====================
+    /**
+     * @brief 开启/关闭延迟统计和屏幕统计显示（p50/p99）
+     * @param enabled 是否开启
+     */
+    void setProfilingEnabled(bool enabled);
+
+    /**
+     * @brief 延迟统计是否开启
+     */
+    bool isProfilingEnabled() const;
+
+    /**
+     * @brief 导出延迟统计的 Chrome Trace JSON
+     * @param filename 文件路径
+     * @return 成功返回true
+     */
+    bool exportLatencyTrace(const QString& filename);
+
     // ==================== 标注操作 ====================
     /**
      * @brief 设置当前标签
-     * @param label 标签值 (0-19)
+     * @param label 标签值 (0 ~ labelCapacity()-1)
      */
     void setCurrentLabel(int label);
 
+    /**
+     * @brief 数字键输入标签号：间隔不超过 LABEL_DIGIT_TIMEOUT_MS 的数字组成多位标签号
+     *        （如 1、2 -> 12），超出容量时从这一位重新开始
+     * @param digit 数字 0~9
+     */
+    void typeLabelDigit(int digit);
+
+    /**
+     * @brief 设置会话的标签容量（应用到所有网格）
+     * @param capacity 标签容量（1 ~ MeshLabelCore::MAX_LABEL_CAPACITY）
+     * @return 成功返回true；有网格中的标签不小于 capacity 时发出 errorOccurred 并返回false
+     */
+    bool setLabelCapacity(int capacity);
+
+    /**
+     * @brief 获取会话的标签容量
+     */
+    int labelCapacity() const { return m_labelCapacity; }
+
+    /**
+     * @brief 颜色查找表覆盖的标签数
+     */
+    int paletteSize() const { return static_cast<int>(m_lookupTable->GetNumberOfTableValues()); }
+
     /**
      * @brief 获取当前标签
      * @return 当前标签值
@@ -169,7 +306,7 @@ public:
 
     /**
      * @brief 设置编辑模式
-     * @param mode 编辑模式（画刷/单点）
+     * @param mode 编辑模式（画刷/单点/测地画刷/魔棒/填充）
      */
     void setEditMode(EditMode mode);
 
@@ -191,6 +328,28 @@ public:
      */
     double getBrushRadius() const { return m_brushRadius; }
 
+    /**
+     * @brief 设置魔棒的停止条件
+     */
+    void setRegionGrowOptions(const RegionGrowOptions& options) { m_regionGrowOptions = options; }
+
+    /**
+     * @brief 获取魔棒的停止条件
+     */
+    const RegionGrowOptions& regionGrowOptions() const { return m_regionGrowOptions; }
+
+    /**
+     * @brief 魔棒：从起始单元生长区域并标注为当前标签
+     * @param startCellId 起始单元ID
+     */
+    void magicWand(int startCellId);
+
+    /**
+     * @brief 填充：把起始单元所在的同标签连通区域改为当前标签
+     * @param startCellId 起始单元ID
+     */
+    void bucketFill(int startCellId);
+
     /**
      * @brief 增加画刷半径
      */
@@ -215,12 +374,12 @@ public:
     /**
      * @brief 是否可以撤销
      */
-    bool canUndo() const { return !m_undoStack.empty(); }
+    bool canUndo() const { return m_core->canUndo(); }
 
     /**
      * @brief 是否可以重做
      */
-    bool canRedo() const { return !m_redoStack.empty(); }
+    bool canRedo() const { return m_core->canRedo(); }
 
     /**
      * @brief 清空撤销/重做历史
@@ -232,36 +391,147 @@ public:
      * @brief 获取网格单元数量
      * @return 单元数量
      */
-    int getCellCount() const;
+    int getCellCount() const { return m_core->getCellCount(); }
 
     /**
      * @brief 获取指定单元的标签
      * @param cellId 单元ID
      * @return 标签值
      */
-    int getCellLabel(int cellId) const;
+    int getCellLabel(int cellId) const { return m_core->getCellLabel(cellId); }
 
     /**
      * @brief 获取每个标签的统计信息
      * @return 标签统计 (标签ID -> 单元数量)
      */
-    std::vector<int> getLabelStatistics() const;
+    std::vector<int> getLabelStatistics() const { return m_core->getLabelStatistics(); }
+
+    /**
+     * @brief 获取标签统计（单元数量、表面积，增量维护）
+     */
+    const LabelStatistics& labelStatistics() const { return m_core->labelStatistics(); }
+
+    /**
+     * @brief 导出标签统计（面积、质心、包围盒；.json 或 .csv）
+     * @param filename 文件路径
+     * @return 成功返回true
+     */
+    bool exportLabelStatistics(const QString& filename);
+
+    /**
+     * @brief 计算所有标签区域的连通分量（孤岛、碎片检查）
+     */
+    const LabelComponents& analyzeComponents() { return m_core->analyzeComponents(); }
+
+    /**
+     * @brief 把小于 minCells 的碎片合并到周围标签（可撤销）
+     * @param minCells 碎片阈值
+     * @return 被合并的碎片数量
+     */
+    int mergeSmallComponents(int minCells);
+
+    /**
+     * @brief 平滑标签边界（可撤销）
+     * @param iterations 最大迭代轮数
+     * @return 改变的单元数量
+     */
+    int smoothLabelBoundaries(int iterations);
+
+    /**
+     * @brief 图割细化当前标签与背景标签之间的边界（可撤销）
+     * @param background 背景标签
+     * @return 改变的单元数量
+     */
+    int refineWithGraphCut(int background);
+
+    /**
+     * @brief 从已标注的参考 VTP 迁移标签（最近单元，可撤销）
+     * @param referenceFile 参考文件
+     * @return 改变的单元数量，失败时返回-1并发出 errorOccurred
+     */
+    int transferLabelsFrom(const QString& referenceFile);
+
+    /**
+     * @brief 切换当前网格标签存放的位置（单元 <-> 顶点，清空该网格的历史）
+     * @param location 目标位置
+     * @return 成功返回true，失败时发出 errorOccurred
+     */
+    bool setLabelLocation(LabelLocation location);
+
+    /**
+     * @brief 设置顶点标签模式是否插值着色（否则按单元标签平面着色）
+     */
+    void setPointLabelInterpolation(bool enabled);
+
+    /**
+     * @brief 顶点标签模式是否插值着色
+     */
+    bool pointLabelInterpolation() const { return m_pointLabelInterpolation; }
+
+    // ==================== 标签锁定与隐藏 ====================
+    /**
+     * @brief 锁定或解锁标签（锁定的标签不会被任何编辑工具覆盖，应用到所有网格）
+     */
+    void setLabelLocked(int label, bool locked);
+
+    /**
+     * @brief 标签是否锁定
+     */
+    bool isLabelLocked(int label) const { return m_lockedLabels.test(label); }
+
+    /**
+     * @brief 隐藏或显示标签（隐藏的单元不渲染、不可拾取，也不会被覆盖；应用到所有网格）
+     */
+    void setLabelHidden(int label, bool hidden);
+
+    /**
+     * @brief 标签是否隐藏
+     */
+    bool isLabelHidden(int label) const { return m_hiddenLabels.test(label); }
+
+    /**
+     * @brief 显示所有隐藏的标签
+     */
+    void showAllLabels();
+
+    /**
+     * @brief 获取锁定的标签
+     */
+    const LabelMask& lockedLabels() const { return m_lockedLabels; }
+
+    /**
+     * @brief 获取隐藏的标签
+     */
+    const LabelMask& hiddenLabels() const { return m_hiddenLabels; }
+
+    /**
+     * @brief 拾取到的单元ID：分块渲染时把块内编号换成网格的单元ID，
+     *        隐藏的和感兴趣区域外的单元当作没有拾取到（返回-1）
+     * @param picker 完成拾取的拾取器
+     */
+    int pickedCellId(vtkCellPicker* picker) const;
 
     /**
      * @brief 检查网格是否已加载
      */
-    bool isMeshLoaded() const { return m_polyData != nullptr; }
+    bool isMeshLoaded() const { return m_core->isMeshLoaded(); }
+
+    /**
+     * @brief 获取无界面核心对象
+     */
+    MeshLabelCore& core() { return *m_core; }
+    const MeshLabelCore& core() const { return *m_core; }
 
     // ==================== 内部访问器（用于回调） ====================
     vtkRenderer* getRenderer() { return m_renderer.Get(); }
     vtkRenderWindow* getRenderWindow() { return m_renderWindow.Get(); }
-    vtkPolyData* getPolyData() { return m_polyData.Get(); }
-    vtkActor* getPolyDataActor() { return m_polyDataActor.Get(); }
+    vtkPolyData* getPolyData() { return m_core->polyData(); }
+    vtkActor* getPolyDataActor() { return m_activePart >= 0 ? m_parts[m_activePart].actor.Get() : nullptr; }
     vtkActor* getSphereActor() { return m_sphereActor.Get(); }
     vtkLookupTable* getLookupTable() { return m_lookupTable.Get(); }
 
     bool isMousePressed() const { return m_isMousePressed; }
-    void setMousePressed(bool pressed) { m_isMousePressed = pressed; }
+    void setMousePressed(bool pressed);
 
 signals:
     /**
@@ -282,6 +552,17 @@ signals:
      */
     void meshLoaded(const QString& filename);
 
+    /**
+     * @brief 会话中的网格增加或减少
+     */
+    void meshListChanged();
+
+    /**
+     * @brief 当前网格改变信号
+     * @param index 新的当前网格序号（没有网格时为-1）
+     */
+    void activeMeshChanged(int index);
+
     /**
      * @brief 渲染需要更新信号
      */
@@ -292,6 +573,27 @@ signals:
      */
     void historyChanged();
 
+    /**
+     * @brief 标签统计改变信号（绘制、撤销、重做、加载后）
+     */
+    void labelStatisticsChanged();
+
+    /**
+     * @brief 标签容量改变信号
+     * @param capacity 新的标签容量
+     */
+    void labelCapacityChanged(int capacity);
+
+    /**
+     * @brief 颜色查找表扩大或缩小后发出
+     */
+    void paletteChanged();
+
+    /**
+     * @brief 锁定或隐藏的标签改变信号
+     */
+    void labelMasksChanged();
+
     /**
      * @brief 错误信号
      * @param errorMessage 错误消息
@@ -312,44 +614,170 @@ private:
     void initializeLookupTable();
 
     /**
-     * @brief 初始化单元数据
+     * @brief 按标签数重新填充颜色查找表并更新所有网格的标量范围
+     * @param size 查找表覆盖的标签数
      */
-    void initializeCellData();
+    void fillLookupTable(int size);
 
     /**
-     * @brief 创建特征边缘
+     * @brief 保证颜色查找表至少覆盖 labelCount 个标签（按倍增扩大，不超过标签容量）
      */
-    void createFeatureEdges();
+    void ensurePalette(int labelCount);
 
     /**
-     * @brief 使用BFS算法在球形区域内标注
-     * @param position 球心位置
-     * @param startCellId 起始单元ID
-     * @return 受影响的单元ID列表
+     * @brief 统一网格与会话的标签容量：网格的容量更大（加载或迁移时自动扩大）时扩大会话容量，
+     *        否则把网格扩大到会话容量
      */
-    std::vector<int> labelWithBFS(double* position, int startCellId);
+    void adoptLabelCapacity(MeshLabelCore& core);
 
     /**
-     * @brief 检查单元是否在球体内
-     * @param position 球心位置
-     * @param cellId 单元ID
-     * @return 在球内返回true
+     * @brief 为网格创建特征边缘
+     * @param part 网格
      */
-    bool isCellInSphere(double* position, int cellId) const;
+    void createFeatureEdges(MeshPart& part);
 
     /**
-     * @brief 标注单个单元
-     * @param cellId 单元ID
-     * @param label 标签值
+     * @brief 开始笔画（先写入上一笔画未处理完的样本，重置采样状态）
+     */
+    void startStroke();
+
+    /**
+     * @brief 光标离上一个样本不到最小间距时跳过这次采样（不拾取，在上一个样本的深度上反投影光标）
+     *
+     * 半径、标签、模式或网格与上一个样本不同时不跳过。
+     * @param x 光标的显示坐标x
+     * @param y 光标的显示坐标y
+     * @param position 输出反投影得到的光标位置（用于移动预览球）
+     * @return 跳过返回true
      */
-    void labelCell(int cellId, int label);
+    bool skipIfNearLastSample(int x, int y, double* position);
 
     /**
-     * @brief 标注多个单元
+     * @brief 笔画中的一次拾取：起点已是目标标签的球形画刷样本直接跳过，其余交给画刷流水线
+     * @param position 画刷中心
+     * @param startCellId 拾取到的单元ID
+     */
+    void sampleStroke(const double* position, int startCellId);
+
+    /**
+     * @brief 把一个画刷样本交给画刷流水线
+     *
+     * 样本队列已满时只保留最新的一个样本，等工作线程腾出位置后提交。
+     * @param sample 样本
+     */
+    void submitBrushSample(const BrushSample& sample);
+
+    /**
+     * @brief 提交因队列已满而暂存的样本（队列仍满时继续暂存）
+     */
+    void submitPendingSample();
+
+    /**
+     * @brief 把工作线程算好的结果写入标签并请求渲染（GUI 线程）
+     */
+    void applyBrushResults();
+
+    /**
+     * @brief 等待画刷流水线处理完所有样本并写入标签
+     *
+     * 撤销、切换网格、整体编辑等操作前调用，保证它们看到完整的笔画。
+     */
+    void flushBrushPipeline();
+
+    /**
+     * @brief 结束笔画；还有样本未处理时推迟到最后一个结果写入之后
+     *
+     * 最后一个样本之后按间距跳过的光标位置（松开鼠标处）先拾取并提交，笔画不会停在松开点之前。
+     */
+    void finishStroke();
+
+    /**
+     * @brief 当前是否为画刷类模式（球形或测地）
+     */
+    bool isBrushMode() const
+    {
+        return m_editMode == EditMode::Brush || m_editMode == EditMode::GeodesicBrush;
+    }
+
+    /**
+     * @brief 使用当前标签标注单元并记录历史
      * @param cellIds 单元ID列表
-     * @param label 标签值
      */
-    void labelCells(const std::vector<int>& cellIds, int label);
+    void paintCells(const std::vector<int>& cellIds);
+
+    /**
+     * @brief 单点模式的一次标注：单元标签模式标注拾取的单元，顶点标签模式标注其中离拾取点最近的顶点
+     * @param position 拾取位置
+     * @param cellId 拾取到的单元ID
+     */
+    void paintSingle(const double* position, int cellId);
+
+    /**
+     * @brief 依赖单元标签的工具在执行前检查；顶点标签模式下发出 errorOccurred 并返回false
+     */
+    bool requireCellLabels();
+
+    /**
+     * @brief 按网格的标签位置设置着色方式（点数据插值或单元数据平面着色）
+     */
+    void applyLabelShading(MeshPart& part);
+
+    /**
+     * @brief 按渲染方式为网格创建映射器（整网格或分块）
+     */
+    void applyRenderMode(MeshPart& part);
+
+    /**
+     * @brief 把核心记录的标签改变同步到各网格的块（渲染前调用）
+     */
+    void syncRenderChunks();
+
+    /**
+     * @brief 按块的可见性设置复合映射器的块显示属性
+     */
+    void updateChunkVisibility(MeshPart& part);
+
+    /**
+     * @brief 把裁剪盒应用到所有网格的核心、块和映射器（拖动裁剪盒时调用，不移动拖动框）
+     * @param bounds 裁剪盒，为空时取消
+     */
+    void applyClipBox(const double* bounds);
+
+    /**
+     * @brief 为网格和特征边的映射器设置或移除裁剪平面（所有映射器共用 m_clipPlanes）
+     */
+    void applyClipPlanes(MeshPart& part);
+
+    /**
+     * @brief 移除所有网格及其Actor
+     */
+    void clearMeshes();
+
+    /**
+     * @brief 把已加载的核心加入会话：创建网格Actor并设为当前网格
+     * @param core 已加载网格的核心
+     * @param filename 文件名
+     */
+    void appendMesh(std::unique_ptr<MeshLabelCore> core, const QString& filename);
+
+    /**
+     * @brief 按最近使用顺序释放多余网格的编辑结构
+     */
+    void releaseIdleMeshes();
+
+    /**
+     * @brief 构建当前编辑模式在工作线程上要读取的结构
+     *
+     * 测地画刷的 CSR 邻接和单元几何在界面线程上构建，之后工作线程只读取它们。
+     * 切换模式和切换当前网格时调用。
+     */
+    void ensureModeResources();
+
+    /**
+     * @brief 拾取到的 Actor 是否属于当前网格；属于其它网格时把该网格设为当前网格
+     * @return 属于当前网格返回true
+     */
+    bool ensurePickedMeshActive(vtkActor* actor);
 
     /**
      * @brief 更新画刷球体显示
@@ -358,10 +786,14 @@ private:
     void updateBrushSphere(double* position);
 
     /**
-     * @brief 添加命令到历史栈
-     * @param command 命令对象
+     * @brief 刷新屏幕上的延迟统计文本
+     */
+    void updateProfilerHud();
+
+    /**
+     * @brief 执行一帧渲染（由 RenderScheduler 调用并计时）
      */
-    void addCommand(std::shared_ptr<LabelCommand> command);
+    void renderFrame();
 
     // ==================== 回调函数（友元） ====================
     friend void LeftButtonPressCallback(vtkObject* caller, long unsigned int eventId,
@@ -380,16 +812,26 @@ private:
                                          void* clientData, void* callData);
     friend void MouseWheelBackwardCallback(vtkObject* caller, long unsigned int eventId,
                                           void* clientData, void* callData);
+    friend void ClipBoxInteractionCallback(vtkObject* caller, long unsigned int eventId,
+                                          void* clientData, void* callData);
 
     // ==================== 成员变量 ====================
+    // 核心数据
+    std::vector<MeshPart> m_parts;                         ///< 会话中的网格
+    int m_activePart;                                      ///< 当前网格序号（-1 表示没有网格）
+    quint64 m_activationCount;                             ///< 激活计数（MeshPart::lastActive）
+    MeshLabelCore m_emptyCore;                             ///< 没有网格时使用的空核心
+    MeshLabelCore* m_core;                                 ///< 当前网格的核心
+
     // VTK 对象
-    vtkSmartPointer<vtkPolyData> m_polyData;              ///< 网格数据
-    vtkSmartPointer<vtkActor> m_polyDataActor;            ///< 网格Actor
     vtkSmartPointer<vtkActor> m_sphereActor;              ///< 画刷球体Actor
-    vtkSmartPointer<vtkActor> m_edgeActor;                ///< 特征边缘Actor
+    vtkSmartPointer<vtkSphereSource> m_sphereSource;      ///< 画刷球体（悬停时只改球心和半径）
     vtkSmartPointer<vtkRenderer> m_renderer;              ///< 渲染器
     vtkSmartPointer<vtkRenderWindow> m_renderWindow;      ///< 渲染窗口
     vtkSmartPointer<vtkLookupTable> m_lookupTable;        ///< 颜色查找表
+    vtkSmartPointer<vtkTextActor> m_profilerHudActor;     ///< 延迟统计文本
+    vtkSmartPointer<vtkBoxWidget2> m_clipBoxWidget;       ///< 可拖动的裁剪盒（第一次使用时创建）
+    vtkSmartPointer<vtkPlaneCollection> m_clipPlanes;     ///< 裁剪盒的六个平面（法向朝内，所有映射器共用）
 
     // 回调命令
     vtkSmartPointer<vtkCallbackCommand> m_leftButtonPressCallback;
@@ -400,24 +842,39 @@ private:
     vtkSmartPointer<vtkCallbackCommand> m_mouseMoveCallback;
     vtkSmartPointer<vtkCallbackCommand> m_mouseWheelForwardCallback;
     vtkSmartPointer<vtkCallbackCommand> m_mouseWheelBackwardCallback;
+    vtkSmartPointer<vtkCallbackCommand> m_clipBoxCallback;
 
     // 状态变量
-    int m_currentLabel;                ///< 当前标签 (0-19)
+    int m_currentLabel;                ///< 当前标签
+    int m_labelCapacity;               ///< 会话的标签容量
+    int m_labelDigits;                 ///< 正在输入的多位标签号
+    QElapsedTimer m_labelDigitTimer;   ///< 上一次数字键的时间
     EditMode m_editMode;               ///< 编辑模式
     double m_brushRadius;              ///< 画刷半径
+    RegionGrowOptions m_regionGrowOptions; ///< 魔棒停止条件
+    bool m_pointLabelInterpolation;    ///< 顶点标签模式是否插值着色
+    bool m_chunkedRendering;           ///< 是否分块渲染
+    std::vector<int> m_changedCells;   ///< 标签改变的单元（复用缓冲区）
+    LabelMask m_lockedLabels;          ///< 锁定的标签（会话级）
+    LabelMask m_hiddenLabels;          ///< 隐藏的标签（会话级）
+    bool m_hasClipBox;                 ///< 是否设置了感兴趣区域（会话级）
+    double m_clipBox[6];               ///< 裁剪盒
     bool m_isMousePressed;             ///< 鼠标是否按下
 
-    // 文件信息
-    QString m_currentFileName;         ///< 当前文件名
-    QString m_tempFileName;            ///< 临时文件名
-
-    // 撤销/重做
-    std::stack<std::shared_ptr<LabelCommand>> m_undoStack;  ///< 撤销栈
-    std::stack<std::shared_ptr<LabelCommand>> m_redoStack;  ///< 重做栈
-    static constexpr int MAX_HISTORY_SIZE = 100;            ///< 最大历史记录数
-
-    // 渲染节流
-    bool m_renderPending;              ///< 是否有待处理的渲染请求
+    // 渲染调度
+    RenderScheduler m_renderScheduler; ///< 自适应渲染调度器
+
+    // 画刷流水线（最后声明：最先析构，工作线程结束后才释放网格）
+    BrushSample m_pendingSample;       ///< 队列已满时暂存的最新样本
+    bool m_hasPendingSample;           ///< 是否有暂存的样本
+    bool m_strokeEnding;               ///< 鼠标已松开，等流水线处理完再结束笔画
+    BrushSample m_lastSample;          ///< 本笔画最近提交的样本（最小间距的参照）
+    bool m_hasLastSample;              ///< 本笔画是否已提交过样本
+    int m_skippedPosition[2];          ///< 最近一次按间距跳过的光标显示坐标
+    bool m_hasSkippedSample;           ///< 最近一个样本之后是否有被跳过的光标位置
+    int m_strokeSubmitted;             ///< 本笔画提交的样本数
+    int m_strokeSkipped;               ///< 本笔画跳过的样本数
+    BrushPipeline m_brushPipeline;     ///< 区域计算工作线程
 };
 
 #endif // MESHLABELER_H
@@ -0,0 +1,31 @@
+/**
+ * @file parallelutils.cpp
+ * @brief ParallelUtils 数据并行工具的实现
+ */
+
+#include "parallelutils.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<int> g_threadCountOverride(0);
+
+} // namespace
+
+int ParallelUtils::threadCount()
+{
+    const int overrideCount = g_threadCountOverride.load(std::memory_order_relaxed);
+    if (overrideCount > 0) {
+        return overrideCount;
+    }
+
+    static const int hardwareCount =
+        static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    return hardwareCount;
+}
+
+void ParallelUtils::setThreadCount(int count)
+{
+    g_threadCountOverride.store(std::max(count, 0), std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file parallelutils.h
+ * @brief 基于 std::thread 的简单数据并行工具
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef PARALLELUTILS_H
+#define PARALLELUTILS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 数据并行工具
+ *
+ * 将 [begin, end) 切分为连续的块，每块在独立线程上处理，调用线程处理第一块。
+ * 只用于加载、全量统计、校验等一次性的大循环；交互路径上的小循环应直接串行执行。
+ */
+class ParallelUtils {
+public:
+    static constexpr int64_t DEFAULT_MIN_CHUNK = 65536;    ///< 每块的默认最小元素数
+
+    /**
+     * @brief 获取工作线程数（默认为硬件线程数）
+     */
+    static int threadCount();
+
+    /**
+     * @brief 限制工作线程数（<= 0 恢复默认），用于基准测试对比
+     */
+    static void setThreadCount(int count);
+
+    /**
+     * @brief 计算 [begin, end) 会被切成多少块
+     * @param begin 起始下标
+     * @param end 结束下标（不含）
+     * @param minChunk 每块最小元素数
+     */
+    static int chunkCount(int64_t begin, int64_t end, int64_t minChunk = DEFAULT_MIN_CHUNK)
+    {
+        if (end <= begin) {
+            return 0;
+        }
+        const int64_t bySize = (end - begin + minChunk - 1) / std::max<int64_t>(minChunk, 1);
+        return static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(threadCount(), bySize)));
+    }
+
+    /**
+     * @brief 分块并行执行
+     * @param begin 起始下标
+     * @param end 结束下标（不含）
+     * @param minChunk 每块最小元素数（元素太少时串行执行）
+     * @param func 块处理函数 func(chunkBegin, chunkEnd, chunkIndex)，chunkIndex < chunkCount()
+     */
+    template <typename Func>
+    static void forChunks(int64_t begin, int64_t end, int64_t minChunk, Func&& func)
+    {
+        const int chunks = chunkCount(begin, end, minChunk);
+        if (chunks <= 0) {
+            return;
+        }
+        if (chunks == 1) {
+            func(begin, end, 0);
+            return;
+        }
+
+        const int64_t total = end - begin;
+        auto chunkBegin = [&](int chunk) { return begin + total * chunk / chunks; };
+
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (int chunk = 1; chunk < chunks; ++chunk) {
+            workers.emplace_back([&func, &chunkBegin, chunk]() {
+                func(chunkBegin(chunk), chunkBegin(chunk + 1), chunk);
+            });
+        }
+        func(chunkBegin(0), chunkBegin(1), 0);
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+};
+
+#endif // PARALLELUTILS_H
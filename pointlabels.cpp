@@ -0,0 +1,144 @@
+/**
+ * @file pointlabels.cpp
+ * @brief PointLabels 单元/顶点标签转换的实现
+ */
+
+#include "pointlabels.h"
+#include "labelstatistics.h"
+#include "parallelutils.h"
+
+#include <algorithm>
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+
+int PointLabels::majority(const int* labels, int count)
+{
+    // 相邻单元/顶点通常不超过十几个，逐个计数即可
+    int best = 0;
+    int bestVotes = 0;
+    for (int i = 0; i < count; ++i) {
+        int votes = 0;
+        for (int j = 0; j < count; ++j) {
+            votes += labels[j] == labels[i] ? 1 : 0;
+        }
+        if (votes > bestVotes || (votes == bestVotes && labels[i] < best)) {
+            best = labels[i];
+            bestVotes = votes;
+        }
+    }
+    return best;
+}
+
+void PointLabels::cellsToPoints(vtkPolyData* polyData, const std::vector<int>& cellLabels,
+                                std::vector<int>& pointLabels)
+{
+    const vtkIdType pointCount = polyData->GetNumberOfPoints();
+    pointLabels.assign(pointCount, 0);
+    if (pointCount == 0 || polyData->GetNumberOfCells() == 0) {
+        return;
+    }
+    if (!polyData->GetLinks()) {
+        polyData->BuildLinks();
+    }
+
+    ParallelUtils::forChunks(0, pointCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int) {
+            std::vector<int> votes;
+            for (int64_t pointId = begin; pointId < end; ++pointId) {
+                vtkIdType ncells;
+                vtkIdType* cells;
+                polyData->GetPointCells(pointId, ncells, cells);
+                votes.resize(ncells);
+                for (vtkIdType i = 0; i < ncells; ++i) {
+                    votes[i] = cellLabels[cells[i]];
+                }
+                pointLabels[pointId] = majority(votes.data(), static_cast<int>(ncells));
+            }
+        });
+}
+
+void PointLabels::pointsToCells(vtkPolyData* polyData, const std::vector<int>& pointLabels,
+                                std::vector<int>& cellLabels)
+{
+    const vtkIdType cellCount = polyData->GetNumberOfCells();
+    cellLabels.assign(cellCount, 0);
+    if (cellCount == 0) {
+        return;
+    }
+    if (!polyData->GetLinks()) {
+        polyData->BuildLinks();
+    }
+
+    ParallelUtils::forChunks(0, cellCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int) {
+            // 每个线程复制到自己的 vtkIdList（指针版本的 GetCellPoints 可能共用单元数组的临时缓冲区）
+            vtkNew<vtkIdList> pointIds;
+            std::vector<int> votes;
+            for (int64_t cellId = begin; cellId < end; ++cellId) {
+                polyData->GetCellPoints(cellId, pointIds);
+                const vtkIdType npts = pointIds->GetNumberOfIds();
+                votes.resize(npts);
+                for (vtkIdType i = 0; i < npts; ++i) {
+                    votes[i] = pointLabels[pointIds->GetId(i)];
+                }
+                cellLabels[cellId] = majority(votes.data(), static_cast<int>(npts));
+            }
+        });
+}
+
+int PointLabels::updateCells(vtkPolyData* polyData, const std::vector<int>& pointIds,
+                             LabelStatistics* statistics)
+{
+    vtkDataArray* pointLabels = polyData->GetPointData()->GetScalars();
+    vtkDataArray* cellLabels = polyData->GetCellData()->GetScalars();
+    if (!pointLabels || !cellLabels || pointIds.empty()) {
+        return 0;
+    }
+    if (!polyData->GetLinks()) {
+        polyData->BuildLinks();
+    }
+
+    std::vector<vtkIdType> cellIds;
+    cellIds.reserve(pointIds.size() * 6);
+    for (int pointId : pointIds) {
+        vtkIdType ncells;
+        vtkIdType* cells;
+        polyData->GetPointCells(pointId, ncells, cells);
+        cellIds.insert(cellIds.end(), cells, cells + ncells);
+    }
+    std::sort(cellIds.begin(), cellIds.end());
+    cellIds.erase(std::unique(cellIds.begin(), cellIds.end()), cellIds.end());
+
+    int changed = 0;
+    std::vector<int> votes;
+    for (vtkIdType cellId : cellIds) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        polyData->GetCellPoints(cellId, npts, pts);
+        votes.resize(npts);
+        for (vtkIdType i = 0; i < npts; ++i) {
+            votes[i] = static_cast<int>(pointLabels->GetComponent(pts[i], 0));
+        }
+        const int label = majority(votes.data(), static_cast<int>(npts));
+        const int oldLabel = static_cast<int>(cellLabels->GetComponent(cellId, 0));
+        if (label == oldLabel) {
+            continue;
+        }
+        if (statistics) {
+            statistics->moveCell(cellId, oldLabel, label);
+        }
+        cellLabels->SetComponent(cellId, 0, label);
+        ++changed;
+    }
+
+    if (changed > 0) {
+        cellLabels->Modified();
+        polyData->GetCellData()->Modified();
+    }
+    return changed;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file pointlabels.h
+ * @brief 单元标签与顶点标签的相互转换（顶点标签模式）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef POINTLABELS_H
+#define POINTLABELS_H
+
+#include <vector>
+
+#include <vtkType.h>
+
+class vtkPolyData;
+class LabelStatistics;
+
+/**
+ * @brief 单元标签与顶点标签的相互转换
+ *
+ * 两个方向都是多数表决，票数相同时取较小的标签：
+ * - 顶点标签取其相邻单元中最多的标签（没有相邻单元的顶点为0）；
+ * - 单元标签取其顶点中最多的标签（三个顶点各不相同时取最小的）。
+ * 全量转换按块并行，每个元素只读网格和输入标签，结果与线程数无关。
+ * 只用线程安全的指针版 GetPointCells/GetCellPoints，需要已构建的点-单元链接（未构建时先构建）。
+ */
+class PointLabels {
+public:
+    /**
+     * @brief 由单元标签计算顶点标签
+     * @param polyData 网格
+     * @param cellLabels 每个单元的标签
+     * @param pointLabels 输出每个顶点的标签
+     */
+    static void cellsToPoints(vtkPolyData* polyData, const std::vector<int>& cellLabels,
+                              std::vector<int>& pointLabels);
+
+    /**
+     * @brief 由顶点标签计算单元标签
+     * @param polyData 网格
+     * @param pointLabels 每个顶点的标签
+     * @param cellLabels 输出每个单元的标签
+     */
+    static void pointsToCells(vtkPolyData* polyData, const std::vector<int>& pointLabels,
+                              std::vector<int>& cellLabels);
+
+    /**
+     * @brief 顶点标签改变后，重新计算这些顶点相邻单元的标签（写入单元标量并更新统计）
+     *
+     * 标签取自网格的点标量和单元标量。用于顶点标签模式下每次绘制、撤销和重做，
+     * 使单元标签（统计、平面着色和导出）始终与顶点标签一致。
+     * @param polyData 网格
+     * @param pointIds 标签改变的顶点
+     * @param statistics 需要同步更新的标签统计（可为空）
+     * @return 标签改变的单元数量
+     */
+    static int updateCells(vtkPolyData* polyData, const std::vector<int>& pointIds,
+                           LabelStatistics* statistics);
+
+    /**
+     * @brief 多数表决（票数相同时取较小的标签，没有元素时为0）
+     * @param labels 标签
+     * @param count 标签数量
+     */
+    static int majority(const int* labels, int count);
+};
+
+#endif // POINTLABELS_H
@@ -0,0 +1,91 @@
+/**
+ * @file regiongrower.h
+ * @brief 沿共边单元的区域生长（魔棒、同标签填充）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef REGIONGROWER_H
+#define REGIONGROWER_H
+
+#include "meshadjacency.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 区域生长引擎
+ *
+ * 从种子单元出发沿共边单元做广度优先扩展，是否跨过某条边由调用方的判定函数决定。
+ * 访问标记用递增的代号代替清零，队列在多次调用间复用，
+ * 首次使用后每次生长只与区域大小有关，不再随网格规模分配和清零内存。
+ */
+class RegionGrower {
+public:
+    /**
+     * @brief 区域生长
+     * @param adjacency 网格邻接关系
+     * @param seedCell 种子单元
+     * @param accept 判定函数 accept(fromCell, toCell)，返回true时跨过该边
+     * @param cells 输出区域内的单元（按访问顺序，包含种子）
+     * @param maxCells 区域单元数上限（<= 0 不限制），达到后立即停止
+     */
+    template <typename Accept>
+    void grow(const MeshAdjacency& adjacency, int seedCell, Accept&& accept,
+              std::vector<int>& cells, int maxCells = 0)
+    {
+        cells.clear();
+        if (seedCell < 0 || seedCell >= adjacency.cellCount()) {
+            return;
+        }
+        beginQuery(adjacency.cellCount());
+
+        // 输出数组本身就是 BFS 队列
+        m_stamp[seedCell] = m_generation;
+        cells.push_back(seedCell);
+        for (size_t head = 0; head < cells.size(); ++head) {
+            const int cell = cells[head];
+            for (const int* it = adjacency.cellNeighborsBegin(cell);
+                 it != adjacency.cellNeighborsEnd(cell); ++it) {
+                const int next = *it;
+                // 被拒绝的单元不做标记：判定可能与边有关，可以从其它邻居进入
+                if (m_stamp[next] == m_generation || !accept(cell, next)) {
+                    continue;
+                }
+                m_stamp[next] = m_generation;
+                cells.push_back(next);
+                if (maxCells > 0 && static_cast<int>(cells.size()) >= maxCells) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const { return m_stamp.capacity() * sizeof(uint32_t); }
+
+private:
+    /**
+     * @brief 开始新一轮生长（必要时扩容，推进代号）
+     */
+    void beginQuery(int cellCount)
+    {
+        if (static_cast<int>(m_stamp.size()) != cellCount) {
+            m_stamp.assign(cellCount, 0);
+            m_generation = 0;
+        }
+        // 代号回绕时清零一次
+        if (++m_generation == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            m_generation = 1;
+        }
+    }
+
+    std::vector<uint32_t> m_stamp;   ///< 单元访问代号
+    uint32_t m_generation = 0;       ///< 当前代号
+};
+
+#endif // REGIONGROWER_H
@@ -0,0 +1,557 @@
+/**
+ * @file renderchunks.cpp
+ * @brief RenderChunks 分块渲染数据的实现
+ */
+
+#include "renderchunks.h"
+#include "labelarray.h"
+#include "parallelutils.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkUnsignedCharArray.h>
+
+namespace {
+
+constexpr int GRID_RESOLUTION = 128;   ///< 分组格子在最长轴上的数量
+
+/**
+ * @brief 3D Morton 编码（每轴低10位交错）
+ */
+uint32_t morton(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t code = 0;
+    for (int bit = 0; bit < 10; ++bit) {
+        code |= ((x >> bit) & 1u) << (3 * bit);
+        code |= ((y >> bit) & 1u) << (3 * bit + 1);
+        code |= ((z >> bit) & 1u) << (3 * bit + 2);
+    }
+    return code;
+}
+
+/**
+ * @brief 读取一个标签（不支持直接访问的数组改用 vtkDataArray 接口）
+ */
+int readLabel(const LabelView& view, vtkDataArray* array, vtkIdType id)
+{
+    return view.isValid() ? view.get(id) : static_cast<int>(array->GetComponent(id, 0));
+}
+
+/**
+ * @brief 写入一个标签
+ */
+void writeLabel(const LabelView& view, vtkDataArray* array, vtkIdType id, int label)
+{
+    if (view.isValid()) {
+        view.set(id, label);
+    } else {
+        array->SetComponent(id, 0, label);
+    }
+}
+
+/**
+ * @brief 一个块的连接关系（并行计算，之后在主线程上转成 VTK 对象）
+ */
+struct ChunkGeometry {
+    std::vector<int> offsets;          ///< 每个多边形在 connectivity 中的起点（最后一个为总长度）
+    std::vector<int> connectivity;     ///< 全局顶点ID（顶点数不超过单元数，int 足够）
+};
+
+} // namespace
+
+RenderChunks::RenderChunks()
+    : m_cellCount(0)
+    , m_visibilityChanged(false)
+{
+}
+
+RenderChunks::~RenderChunks() = default;
+
+void RenderChunks::clear()
+{
+    m_source = nullptr;
+    m_blocks = nullptr;
+    m_chunks.clear();
+    std::vector<int>().swap(m_cellChunk);
+    std::vector<int>().swap(m_cellLocal);
+    m_blockIndex.clear();
+    m_dirtyChunks.clear();
+    m_cellCount = 0;
+    m_visibilityChanged = true;
+}
+
+void RenderChunks::build(vtkPolyData* polyData, int chunkCells)
+{
+    clear();
+    vtkCellArray* polys = polyData ? polyData->GetPolys() : nullptr;
+    vtkPoints* points = polyData ? polyData->GetPoints() : nullptr;
+    if (!polys || !points || polys->GetNumberOfCells() == 0) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_source = polyData;
+    chunkCells = std::max(chunkCells, 1);
+    // 单元编号依次为 verts、lines、polys、strips，只有多边形进入块
+    const vtkIdType polyOffset = polyData->GetNumberOfVerts() + polyData->GetNumberOfLines();
+    const vtkIdType polyCount = polys->GetNumberOfCells();
+
+    // 分组格子：最长轴 GRID_RESOLUTION 格，其它轴按比例
+    double bounds[6];
+    points->GetBounds(bounds);
+    double extent[3];
+    double longest = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        extent[k] = bounds[2 * k + 1] - bounds[2 * k];
+        longest = std::max(longest, extent[k]);
+    }
+    int bins[3];
+    for (int k = 0; k < 3; ++k) {
+        bins[k] = longest > 0.0
+            ? std::max(1, std::min(GRID_RESOLUTION,
+                                   static_cast<int>(std::ceil(GRID_RESOLUTION * extent[k] / longest))))
+            : 1;
+    }
+
+    // 每个多边形的质心所在的格子（并行，每个线程使用独立的迭代器）
+    std::vector<int> cellBin(polyCount);
+    ParallelUtils::forChunks(0, polyCount, ParallelUtils::DEFAULT_MIN_CHUNK,
+        [&](int64_t begin, int64_t end, int) {
+            vtkSmartPointer<vtkCellArrayIterator> iter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            double p[3];
+            for (int64_t polyId = begin; polyId < end; ++polyId) {
+                vtkIdType npts;
+                const vtkIdType* pts;
+                iter->GetCellAtId(polyId, npts, pts);
+                double centroid[3] = { 0.0, 0.0, 0.0 };
+                for (vtkIdType i = 0; i < npts; ++i) {
+                    points->GetPoint(pts[i], p);
+                    for (int k = 0; k < 3; ++k) {
+                        centroid[k] += p[k];
+                    }
+                }
+                int bin[3];
+                for (int k = 0; k < 3; ++k) {
+                    const double c = npts > 0 ? centroid[k] / npts : bounds[2 * k];
+                    const int b = extent[k] > 0.0
+                        ? static_cast<int>((c - bounds[2 * k]) / extent[k] * bins[k]) : 0;
+                    bin[k] = std::max(0, std::min(bins[k] - 1, b));
+                }
+                cellBin[polyId] = (bin[2] * bins[1] + bin[1]) * bins[0] + bin[0];
+            }
+        });
+
+    std::vector<int> binCounts(static_cast<size_t>(bins[0]) * bins[1] * bins[2], 0);
+    for (int bin : cellBin) {
+        ++binCounts[bin];
+    }
+
+    // 非空格子按 Morton 顺序连成块，块内单元数不超过 chunkCells（单个格子超过时独占一块）
+    std::vector<std::pair<uint32_t, int>> order;
+    for (int z = 0; z < bins[2]; ++z) {
+        for (int y = 0; y < bins[1]; ++y) {
+            for (int x = 0; x < bins[0]; ++x) {
+                const int bin = (z * bins[1] + y) * bins[0] + x;
+                if (binCounts[bin] > 0) {
+                    order.push_back(std::make_pair(morton(x, y, z), bin));
+                }
+            }
+        }
+    }
+    std::sort(order.begin(), order.end());
+    std::vector<int> binChunk(binCounts.size(), -1);
+    std::vector<int> chunkSizes;
+    for (const std::pair<uint32_t, int>& entry : order) {
+        const int count = binCounts[entry.second];
+        if (chunkSizes.empty() || (chunkSizes.back() > 0 && chunkSizes.back() + count > chunkCells)) {
+            chunkSizes.push_back(0);
+        }
+        binChunk[entry.second] = static_cast<int>(chunkSizes.size()) - 1;
+        chunkSizes.back() += count;
+    }
+
+    // 单元按块分配（块内保持全局单元ID的顺序）
+    const int chunkTotal = static_cast<int>(chunkSizes.size());
+    m_chunks.resize(chunkTotal);
+    for (int c = 0; c < chunkTotal; ++c) {
+        m_chunks[c].cellIds.reserve(chunkSizes[c]);
+    }
+    m_cellChunk.assign(polyData->GetNumberOfCells(), -1);
+    m_cellLocal.assign(polyData->GetNumberOfCells(), -1);
+    for (vtkIdType polyId = 0; polyId < polyCount; ++polyId) {
+        const int c = binChunk[cellBin[polyId]];
+        Chunk& chunk = m_chunks[c];
+        const int cellId = static_cast<int>(polyOffset + polyId);
+        m_cellChunk[cellId] = c;
+        m_cellLocal[cellId] = static_cast<int>(chunk.cellIds.size());
+        chunk.cellIds.push_back(cellId);
+    }
+    m_cellCount = static_cast<int>(polyCount);
+    std::vector<int>().swap(cellBin);
+
+    // 每块的连接关系和包围盒（按块并行，只填充 std::vector；VTK 对象在主线程上创建）
+    std::vector<ChunkGeometry> geometry(chunkTotal);
+    ParallelUtils::forChunks(0, chunkTotal, 1,
+        [&](int64_t begin, int64_t end, int) {
+            vtkSmartPointer<vtkCellArrayIterator> iter =
+                vtkSmartPointer<vtkCellArrayIterator>::Take(polys->NewIterator());
+            double p[3];
+            for (int64_t c = begin; c < end; ++c) {
+                Chunk& chunk = m_chunks[c];
+                ChunkGeometry& local = geometry[c];
+                for (int k = 0; k < 3; ++k) {
+                    chunk.bounds[2 * k] = std::numeric_limits<double>::max();
+                    chunk.bounds[2 * k + 1] = std::numeric_limits<double>::lowest();
+                }
+                local.offsets.reserve(chunk.cellIds.size() + 1);
+                local.offsets.push_back(0);
+                for (int cellId : chunk.cellIds) {
+                    vtkIdType npts;
+                    const vtkIdType* pts;
+                    iter->GetCellAtId(cellId - polyOffset, npts, pts);
+                    for (vtkIdType i = 0; i < npts; ++i) {
+                        local.connectivity.push_back(static_cast<int>(pts[i]));
+                        points->GetPoint(pts[i], p);
+                        for (int k = 0; k < 3; ++k) {
+                            chunk.bounds[2 * k] = std::min(chunk.bounds[2 * k], p[k]);
+                            chunk.bounds[2 * k + 1] = std::max(chunk.bounds[2 * k + 1], p[k]);
+                        }
+                    }
+                    local.offsets.push_back(static_cast<int>(local.connectivity.size()));
+                }
+            }
+        });
+
+    m_blocks = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    m_blocks->SetNumberOfBlocks(chunkTotal);
+    for (int c = 0; c < chunkTotal; ++c) {
+        ChunkGeometry& local = geometry[c];
+
+        // 网格的顶点数不超过单元数（单元ID是 int），连接关系用 32 位存储
+        vtkSmartPointer<vtkTypeInt32Array> offsets = vtkSmartPointer<vtkTypeInt32Array>::New();
+        offsets->SetNumberOfValues(static_cast<vtkIdType>(local.offsets.size()));
+        std::copy(local.offsets.begin(), local.offsets.end(), offsets->GetPointer(0));
+        vtkSmartPointer<vtkTypeInt32Array> connectivity = vtkSmartPointer<vtkTypeInt32Array>::New();
+        connectivity->SetNumberOfValues(static_cast<vtkIdType>(local.connectivity.size()));
+        std::copy(local.connectivity.begin(), local.connectivity.end(), connectivity->GetPointer(0));
+        vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+        cells->SetData(offsets, connectivity);
+
+        Chunk& chunk = m_chunks[c];
+        chunk.polyData = vtkSmartPointer<vtkPolyData>::New();
+        // 所有块共用网格的顶点数组（复合映射器按数组去重，顶点只上传一次），块只持有连接关系
+        chunk.polyData->SetPoints(points);
+        chunk.polyData->SetPolys(cells);
+        m_blocks->SetBlock(c, chunk.polyData);
+        m_blockIndex[chunk.polyData.Get()] = c;
+        local = ChunkGeometry();
+    }
+
+    syncAllLabels();
+
+    qDebug() << "Render chunks:" << chunkTotal << "chunks," << m_cellCount << "cells,"
+             << memoryBytes() / (1024 * 1024) << "MB in" << timer.elapsed() << "ms";
+}
+
+vtkMultiBlockDataSet* RenderChunks::blocks() const
+{
+    return m_blocks.Get();
+}
+
+vtkPolyData* RenderChunks::chunk(int index) const
+{
+    return m_chunks[index].polyData.Get();
+}
+
+int RenderChunks::chunkIndex(const vtkDataObject* block) const
+{
+    auto it = m_blockIndex.find(block);
+    return it != m_blockIndex.end() ? it->second : -1;
+}
+
+int RenderChunks::globalCellId(int chunk, int localCellId) const
+{
+    if (chunk < 0 || chunk >= chunkCount()) {
+        return -1;
+    }
+    const std::vector<int>& cellIds = m_chunks[chunk].cellIds;
+    return localCellId >= 0 && localCellId < static_cast<int>(cellIds.size())
+        ? cellIds[localCellId] : -1;
+}
+
+bool RenderChunks::isChunkVisible(int chunk) const
+{
+    return !m_chunks[chunk].clipped && !isFullyHidden(m_chunks[chunk]);
+}
+
+int RenderChunks::visibleCellCount() const
+{
+    int visible = 0;
+    for (const Chunk& chunk : m_chunks) {
+        if (!chunk.clipped) {
+            visible += static_cast<int>(chunk.cellIds.size()) - chunk.hiddenCells;
+        }
+    }
+    return visible;
+}
+
+void RenderChunks::setClipBox(const double* bounds)
+{
+    // 拖动裁剪盒时每次鼠标移动都会调用，不输出日志
+    bool changed = false;
+    for (Chunk& chunk : m_chunks) {
+        bool clipped = false;
+        for (int axis = 0; axis < 3 && bounds && !clipped; ++axis) {
+            clipped = chunk.bounds[2 * axis] > bounds[2 * axis + 1]
+                || chunk.bounds[2 * axis + 1] < bounds[2 * axis];
+        }
+        changed = changed || clipped != chunk.clipped;
+        chunk.clipped = clipped;
+    }
+    if (!changed) {
+        return;
+    }
+
+    // 盒外的块移出复合数据集：映射器不遍历它们，拾取也不测试它们的单元
+    unsigned int block = 0;
+    for (const Chunk& chunk : m_chunks) {
+        block += chunk.clipped ? 0 : 1;
+    }
+    m_blocks->SetNumberOfBlocks(block);
+    block = 0;
+    for (const Chunk& chunk : m_chunks) {
+        if (!chunk.clipped) {
+            m_blocks->SetBlock(block++, chunk.polyData);
+        }
+    }
+    m_blocks->Modified();
+    m_visibilityChanged = true;
+}
+
+void RenderChunks::syncLabels(const std::vector<int>& cellIds)
+{
+    vtkDataArray* source = m_source ? m_source->GetCellData()->GetScalars() : nullptr;
+    if (!source || cellIds.empty()) {
+        return;
+    }
+
+    const LabelView sourceView(source);
+    const int cellTotal = static_cast<int>(m_cellChunk.size());
+    m_dirtyChunks.clear();
+    for (int cellId : cellIds) {
+        const int index = cellId >= 0 && cellId < cellTotal ? m_cellChunk[cellId] : -1;
+        if (index < 0) {
+            continue;
+        }
+        Chunk& chunk = m_chunks[index];
+        const int local = m_cellLocal[cellId];
+        const LabelView view(chunk.labels);
+        const int oldLabel = readLabel(view, chunk.labels, local);
+        const int label = readLabel(sourceView, source, cellId);
+        if (label == oldLabel) {
+            continue;
+        }
+        writeLabel(view, chunk.labels, local, label);
+
+        auto it = chunk.labelCounts.find(oldLabel);
+        if (it != chunk.labelCounts.end() && --it->second == 0) {
+            chunk.labelCounts.erase(it);
+        }
+        ++chunk.labelCounts[label];
+
+        const bool hidden = m_hiddenLabels.test(label);
+        if (hidden != m_hiddenLabels.test(oldLabel)) {
+            const bool wasFullyHidden = isFullyHidden(chunk);
+            chunk.hiddenCells += hidden ? 1 : -1;
+            if (chunk.ghosts) {
+                chunk.ghosts->SetValue(local, hidden ? vtkDataSetAttributes::HIDDENCELL : 0);
+            }
+            if (isFullyHidden(chunk) != wasFullyHidden) {
+                m_visibilityChanged = true;
+            }
+        }
+
+        if (!chunk.dirty) {
+            chunk.dirty = true;
+            m_dirtyChunks.push_back(index);
+        }
+    }
+
+    // 只有涉及的块被标记为已修改，其它块的缓冲区不需要重新上传
+    for (int index : m_dirtyChunks) {
+        Chunk& chunk = m_chunks[index];
+        chunk.dirty = false;
+        chunk.labels->Modified();
+        updateGhosts(chunk, false);
+    }
+    if (!m_dirtyChunks.empty()) {
+        m_blocks->Modified();
+    }
+}
+
+void RenderChunks::syncAllLabels()
+{
+    vtkDataArray* source = m_source ? m_source->GetCellData()->GetScalars() : nullptr;
+    if (!source || m_chunks.empty()) {
+        return;
+    }
+
+    // 标签副本与网格的标签数组类型相同（标签容量改变后重新创建）
+    for (Chunk& chunk : m_chunks) {
+        if (!chunk.labels || chunk.labels->GetDataType() != source->GetDataType()) {
+            chunk.labels = vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+            chunk.labels->SetName("Label");
+            chunk.labels->SetNumberOfComponents(1);
+            chunk.labels->SetNumberOfTuples(static_cast<vtkIdType>(chunk.cellIds.size()));
+            chunk.polyData->GetCellData()->SetScalars(chunk.labels);
+        }
+    }
+
+    // 8/16 位或 float 标签按块并行复制；其它类型逐个读写，只在单线程上进行
+    const LabelView sourceView(source);
+    const int64_t minChunk = sourceView.isValid() ? 1 : std::max<int64_t>(chunkCount(), 1);
+    ParallelUtils::forChunks(0, chunkCount(), minChunk,
+        [&](int64_t begin, int64_t end, int) {
+            for (int64_t c = begin; c < end; ++c) {
+                Chunk& chunk = m_chunks[c];
+                const LabelView view(chunk.labels);
+                chunk.labelCounts.clear();
+                chunk.hiddenCells = 0;
+
+                // 相邻单元多为同一标签，按连续段计数
+                int runLabel = -1;
+                int runLength = 0;
+                auto flushRun = [&chunk, &runLabel, &runLength, this]() {
+                    if (runLength > 0) {
+                        chunk.labelCounts[runLabel] += runLength;
+                        chunk.hiddenCells += m_hiddenLabels.test(runLabel) ? runLength : 0;
+                    }
+                };
+                const int cellCount = static_cast<int>(chunk.cellIds.size());
+                for (int local = 0; local < cellCount; ++local) {
+                    const int label = readLabel(sourceView, source, chunk.cellIds[local]);
+                    writeLabel(view, chunk.labels, local, label);
+                    if (label != runLabel) {
+                        flushRun();
+                        runLabel = label;
+                        runLength = 0;
+                    }
+                    ++runLength;
+                }
+                flushRun();
+            }
+        });
+
+    for (Chunk& chunk : m_chunks) {
+        chunk.labels->Modified();
+        updateGhosts(chunk, true);
+    }
+    m_blocks->Modified();
+    m_visibilityChanged = true;
+}
+
+void RenderChunks::setHiddenLabels(const LabelMask& labels)
+{
+    if (labels == m_hiddenLabels) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const LabelMask previous = m_hiddenLabels;
+    m_hiddenLabels = labels;
+
+    // 每块只看出现过的标签：不含被切换标签的块不变
+    int touched = 0;
+    for (Chunk& chunk : m_chunks) {
+        bool affected = false;
+        int hidden = 0;
+        for (const std::pair<const int, int>& entry : chunk.labelCounts) {
+            const bool isHidden = labels.test(entry.first);
+            hidden += isHidden ? entry.second : 0;
+            affected = affected || isHidden != previous.test(entry.first);
+        }
+        if (!affected) {
+            continue;
+        }
+        chunk.hiddenCells = hidden;
+        updateGhosts(chunk, true);
+        ++touched;
+    }
+
+    if (touched > 0) {
+        m_blocks->Modified();
+        m_visibilityChanged = true;
+    }
+    if (!m_chunks.empty()) {
+        qDebug() << "Render chunks:" << touched << "of" << chunkCount() << "chunks updated,"
+                 << visibleCellCount() << "cells visible in" << timer.elapsed() << "ms";
+    }
+}
+
+bool RenderChunks::takeVisibilityChanged()
+{
+    const bool changed = m_visibilityChanged;
+    m_visibilityChanged = false;
+    return changed;
+}
+
+size_t RenderChunks::memoryBytes() const
+{
+    // 顶点数组属于网格，不计入（vtkPolyData::GetActualMemorySize() 会在每块中重复计算它）
+    size_t bytes = (m_cellChunk.capacity() + m_cellLocal.capacity()) * sizeof(int);
+    for (const Chunk& chunk : m_chunks) {
+        bytes += static_cast<size_t>(chunk.polyData->GetPolys()->GetActualMemorySize()) * 1024;
+        bytes += static_cast<size_t>(chunk.polyData->GetCellData()->GetActualMemorySize()) * 1024;
+        bytes += chunk.cellIds.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+void RenderChunks::updateGhosts(Chunk& chunk, bool rebuild)
+{
+    vtkCellData* cellData = chunk.polyData->GetCellData();
+    if (chunk.hiddenCells == 0 || isFullyHidden(chunk)) {
+        // 没有隐藏单元的块不需要数组；全部隐藏的块整块不绘制
+        if (chunk.ghosts) {
+            cellData->RemoveArray(vtkDataSetAttributes::GhostArrayName());
+            chunk.ghosts = nullptr;
+        }
+        return;
+    }
+    if (chunk.ghosts && !rebuild) {
+        chunk.ghosts->Modified();
+        return;
+    }
+
+    const vtkIdType cellCount = static_cast<vtkIdType>(chunk.cellIds.size());
+    if (!chunk.ghosts) {
+        chunk.ghosts = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        chunk.ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+        chunk.ghosts->SetNumberOfTuples(cellCount);
+        cellData->AddArray(chunk.ghosts);
+    }
+    const LabelView view(chunk.labels);
+    unsigned char* flags = chunk.ghosts->GetPointer(0);
+    for (vtkIdType local = 0; local < cellCount; ++local) {
+        flags[local] = m_hiddenLabels.test(readLabel(view, chunk.labels, local))
+            ? vtkDataSetAttributes::HIDDENCELL : 0;
+    }
+    chunk.ghosts->Modified();
+}
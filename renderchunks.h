@@ -0,0 +1,187 @@
+/**
+ * @file renderchunks.h
+ * @brief 按空间分块的渲染数据（隐藏标签只切换块的可见性）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef RENDERCHUNKS_H
+#define RENDERCHUNKS_H
+
+#include "labelmask.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <vtkSmartPointer.h>
+
+class vtkDataArray;
+class vtkDataObject;
+class vtkMultiBlockDataSet;
+class vtkPolyData;
+class vtkUnsignedCharArray;
+
+/**
+ * @brief 分块渲染数据
+ *
+ * build() 把网格的多边形按质心所在的空间格子分组，格子按 Morton 顺序连成每块约 chunkCells 个
+ * 单元的块（与 ChunkedMesh 的分块方式相同）。每块是一个 vtkPolyData：与网格共用同一个
+ * vtkPoints，只持有按全局顶点ID的多边形和单元标签的副本，放在 vtkMultiBlockDataSet 中交给
+ * 复合映射器。复合映射器按数组去重顶点缓冲区，顶点只上传一次，每块有自己的索引缓冲区；
+ * 分块额外占用的内存是连接关系和标签副本（每三角形约 30 字节），不复制顶点。
+ *
+ * 隐藏标签按每块的标签计数处理：单元全部隐藏的块整块不绘制，不含被切换标签的块不变，
+ * 只有同时含隐藏和可见单元的块才重建该块的可见性数组（vtkGhostType）。
+ * 因此切换隐藏的开销只与含该标签的块有关，绘制的三角形数随可见单元数减少。
+ *
+ * 设置裁剪盒（setClipBox()）后，包围盒与裁剪盒不相交的块移出 blocks()：块是预先建好的
+ * 空间索引，移动裁剪盒只比较各块的包围盒，映射器绘制和拾取测试的单元只来自盒附近的块。
+ * 盒内外的精确裁剪由映射器的裁剪平面完成。
+ *
+ * 标签写入后 syncLabels() 按改变的单元增量更新块内的标签副本，只有涉及的块被标记为已修改。
+ * 只支持单元标签着色（顶点标签插值需要完整网格的点数据）；verts、lines、strips 不进入任何块。
+ */
+class RenderChunks {
+public:
+    static constexpr int DEFAULT_CHUNK_CELLS = 32768;   ///< 默认每块单元数
+
+    RenderChunks();
+    ~RenderChunks();
+
+    RenderChunks(const RenderChunks&) = delete;
+    RenderChunks& operator=(const RenderChunks&) = delete;
+
+    /**
+     * @brief 把网格分块并复制标签（分组和每块的几何并行计算）
+     * @param polyData 网格（标签取自单元标量；分块持有它的引用）
+     * @param chunkCells 每块的目标单元数
+     */
+    void build(vtkPolyData* polyData, int chunkCells = DEFAULT_CHUNK_CELLS);
+
+    /**
+     * @brief 释放所有块
+     */
+    void clear();
+
+    /**
+     * @brief 块数量
+     */
+    int chunkCount() const { return static_cast<int>(m_chunks.size()); }
+
+    /**
+     * @brief 与裁剪盒相交的块（复合映射器的输入，按块编号排列；没有裁剪盒时为所有块）
+     */
+    vtkMultiBlockDataSet* blocks() const;
+
+    /**
+     * @brief 获取块的网格
+     */
+    vtkPolyData* chunk(int index) const;
+
+    /**
+     * @brief 拾取到的数据集对应的块编号（不是本对象的块时返回-1）
+     */
+    int chunkIndex(const vtkDataObject* block) const;
+
+    /**
+     * @brief 块内单元编号对应的全局单元ID（超出范围时返回-1）
+     */
+    int globalCellId(int chunk, int localCellId) const;
+
+    /**
+     * @brief 块的包围盒（xmin, xmax, ymin, ymax, zmin, zmax）
+     */
+    const double* chunkBounds(int chunk) const { return m_chunks[chunk].bounds; }
+
+    /**
+     * @brief 块是否需要绘制（至少有一个未隐藏的单元，且与裁剪盒相交）
+     */
+    bool isChunkVisible(int chunk) const;
+
+    /**
+     * @brief 块中的单元总数
+     */
+    int cellCount() const { return m_cellCount; }
+
+    /**
+     * @brief 需要绘制的单元数（可见块中未隐藏的单元）
+     */
+    int visibleCellCount() const;
+
+    /**
+     * @brief 设置裁剪盒，只比较块的包围盒（O(块数)），与盒不相交的块移出 blocks()
+     * @param bounds 裁剪盒（xmin, xmax, ymin, ymax, zmin, zmax），为空时取消裁剪
+     */
+    void setClipBox(const double* bounds);
+
+    /**
+     * @brief 按改变的单元增量更新块内的标签副本和可见性
+     * @param cellIds 标签改变的全局单元ID（可以重复）
+     */
+    void syncLabels(const std::vector<int>& cellIds);
+
+    /**
+     * @brief 全量复制标签（标签数组被替换或类型改变后，按块并行）
+     */
+    void syncAllLabels();
+
+    /**
+     * @brief 设置隐藏的标签，只更新含有被切换标签的块
+     */
+    void setHiddenLabels(const LabelMask& labels);
+
+    /**
+     * @brief 上次调用之后是否有块的可见性改变（调用后清除）
+     */
+    bool takeVisibilityChanged();
+
+    /**
+     * @brief 所有块占用的内存（字节，不含共用的网格顶点）
+     */
+    size_t memoryBytes() const;
+
+private:
+    /**
+     * @brief 一个块
+     */
+    struct Chunk {
+        vtkSmartPointer<vtkPolyData> polyData;       ///< 块的网格（共用的顶点、块内多边形和标签副本）
+        vtkSmartPointer<vtkDataArray> labels;        ///< 标签副本（与网格标签数组的类型相同）
+        vtkSmartPointer<vtkUnsignedCharArray> ghosts; ///< 可见性数组（只在块内同时有隐藏和可见单元时存在）
+        std::vector<int> cellIds;                    ///< 块内单元的全局ID（按局部编号）
+        std::unordered_map<int, int> labelCounts;    ///< 每个标签的单元数
+        double bounds[6];                            ///< 块的包围盒
+        int hiddenCells = 0;                         ///< 隐藏的单元数
+        bool clipped = false;                        ///< 是否在裁剪盒外
+        bool dirty = false;                          ///< 本次同步是否改动过
+    };
+
+    /**
+     * @brief 按块的隐藏单元数维护可见性数组
+     * @param chunk 块
+     * @param rebuild 数组已存在时是否按隐藏掩码重写（否则认为已逐个更新过）
+     */
+    void updateGhosts(Chunk& chunk, bool rebuild);
+
+    /**
+     * @brief 块内的单元是否全部隐藏
+     */
+    static bool isFullyHidden(const Chunk& chunk)
+    {
+        return chunk.hiddenCells >= static_cast<int>(chunk.cellIds.size());
+    }
+
+    vtkSmartPointer<vtkPolyData> m_source;          ///< 分块的网格
+    vtkSmartPointer<vtkMultiBlockDataSet> m_blocks; ///< 所有块
+    std::vector<Chunk> m_chunks;                    ///< 块
+    std::vector<int> m_cellChunk;                   ///< 每个全局单元所在的块（不在块中为-1）
+    std::vector<int> m_cellLocal;                   ///< 每个全局单元在块内的编号
+    std::unordered_map<const vtkDataObject*, int> m_blockIndex; ///< 块的数据集 -> 块编号
+    std::vector<int> m_dirtyChunks;                 ///< 本次同步改动过的块（复用缓冲区）
+    LabelMask m_hiddenLabels;                       ///< 隐藏的标签
+    int m_cellCount;                                ///< 块中的单元总数
+    bool m_visibilityChanged;                       ///< 是否有块的可见性改变
+};
+
+#endif // RENDERCHUNKS_H
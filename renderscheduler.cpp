@@ -0,0 +1,65 @@
+/**
+ * @file renderscheduler.cpp
+ * @brief RenderScheduler 渲染调度器的实现
+ */
+
+#include "renderscheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+RenderScheduler::RenderScheduler(std::function<void()> renderFunction, QObject* parent)
+    : QObject(parent)
+    , m_renderFunction(std::move(renderFunction))
+    , m_frameCostMs(0.0)
+    , m_interactionActive(false)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &RenderScheduler::renderNow);
+}
+
+int RenderScheduler::frameIntervalMs() const
+{
+    const double factor = m_interactionActive ? INTERACTION_COST_FACTOR : IDLE_COST_FACTOR;
+    const int interval = static_cast<int>(std::ceil(m_frameCostMs * factor));
+    return std::clamp(interval, MIN_FRAME_INTERVAL_MS, MAX_FRAME_INTERVAL_MS);
+}
+
+void RenderScheduler::request()
+{
+    // 已有待处理的帧：合并
+    if (m_timer.isActive()) {
+        return;
+    }
+
+    // 空闲：下一次事件循环立即渲染；否则等到窗口结束
+    int delay = 0;
+    if (m_sinceLastFrame.isValid()) {
+        const qint64 elapsed = m_sinceLastFrame.elapsed();
+        delay = static_cast<int>(std::max<qint64>(0, frameIntervalMs() - elapsed));
+    }
+    m_timer.start(delay);
+}
+
+void RenderScheduler::renderNow()
+{
+    m_timer.stop();
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    if (m_renderFunction) {
+        m_renderFunction();
+    }
+    const double costMs = frameTimer.nsecsElapsed() / 1.0e6;
+
+    m_frameCostMs = (m_frameCostMs <= 0.0)
+        ? costMs
+        : (1.0 - COST_SMOOTHING) * m_frameCostMs + COST_SMOOTHING * costMs;
+    m_sinceLastFrame.start();
+}
+
+void RenderScheduler::setInteractionActive(bool active)
+{
+    m_interactionActive = active;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file renderscheduler.h
+ * @brief 按实测帧耗时自适应的渲染调度器
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <functional>
+
+/**
+ * @brief 渲染调度器
+ *
+ * 测量每帧的实际渲染耗时（指数滑动平均），据此调整合并窗口：
+ * - 空闲时（距上一帧已超过窗口）请求会在下一次事件循环立即渲染；
+ * - 连续请求在窗口内合并为一帧，中间帧被丢弃；
+ * - 笔画进行中窗口放大，给区域计算留出时间，避免渲染挤占输入处理。
+ */
+class RenderScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MIN_FRAME_INTERVAL_MS = 16;        ///< 最小帧间隔（约 60fps，快于显示刷新无意义）
+    static constexpr int MAX_FRAME_INTERVAL_MS = 250;       ///< 最大帧间隔（保证慢网格上仍有反馈）
+    static constexpr double IDLE_COST_FACTOR = 1.0;         ///< 空闲时窗口 = 帧耗时 * 该系数
+    static constexpr double INTERACTION_COST_FACTOR = 1.5;  ///< 笔画中窗口 = 帧耗时 * 该系数
+    static constexpr double COST_SMOOTHING = 0.2;           ///< 帧耗时滑动平均系数
+
+    /**
+     * @brief 构造函数
+     * @param renderFunction 实际执行渲染的函数
+     * @param parent Qt父对象
+     */
+    explicit RenderScheduler(std::function<void()> renderFunction, QObject* parent = nullptr);
+
+    /**
+     * @brief 请求渲染（合并到下一帧）
+     */
+    void request();
+
+    /**
+     * @brief 立即渲染（取消待处理的请求）
+     */
+    void renderNow();
+
+    /**
+     * @brief 设置是否处于连续交互（笔画）中
+     */
+    void setInteractionActive(bool active);
+
+    /**
+     * @brief 获取平均帧耗时（毫秒）
+     */
+    double averageFrameMs() const { return m_frameCostMs; }
+
+    /**
+     * @brief 获取当前合并窗口（毫秒）
+     */
+    int frameIntervalMs() const;
+
+private:
+    std::function<void()> m_renderFunction;   ///< 渲染函数
+    QTimer m_timer;                           ///< 延迟渲染定时器
+    QElapsedTimer m_sinceLastFrame;           ///< 距上一帧结束的时间
+    double m_frameCostMs;                     ///< 平均帧耗时
+    bool m_interactionActive;                 ///< 是否处于笔画中
+};
+
+#endif // RENDERSCHEDULER_H
@@ -0,0 +1,655 @@
+/**
+ * @file meshlabelcore_test.cpp
+ * @brief 核心库的正确性测试（由 ctest 按用例名调用）
+ *
+ * 在 MeshGenerator 生成的网格上执行编辑操作，与全量重算或串行结果对照。
+ * 不依赖测试框架：每个用例返回 bool，失败时输出文件、行号和条件。
+ * @code
+ * meshlabeler_core_test statistics
+ * meshlabeler_core_test memory_budget
+ * meshlabeler_core_test bfs_threads
+ * meshlabeler_core_test chunked
+ * meshlabeler_core_test max_flow
+ * meshlabeler_core_test graph_cut
+ * meshlabeler_core_test label_capacity
+ * @endcode
+ */
+
+#include "chunkedmesh.h"
+#include "labelarray.h"
+#include "maxflowgraph.h"
+#include "meshadjacency.h"
+#include "meshgenerator.h"
+#include "meshlabelcore.h"
+#include "parallelutils.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+namespace {
+
+/**
+ * @brief 条件不成立时输出位置并让用例失败
+ */
+#define CHECK(condition)                                                               \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            QTextStream(stderr) << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition \
+                                << ") failed\n";                                       \
+            return false;                                                              \
+        }                                                                              \
+    } while (0)
+
+/**
+ * @brief 用生成的细分球网格初始化核心对象
+ * @param core 核心对象
+ * @param targetTriangles 目标三角形数量
+ * @param labelCount 预分配的标签数量（按空间区域划分）
+ */
+bool prepareCore(MeshLabelCore& core, long long targetTriangles, int labelCount)
+{
+    MeshGeneratorOptions options;
+    options.shape = MeshShape::Icosphere;
+    options.targetTriangles = targetTriangles;
+    options.labelCount = labelCount;
+    return core.setMesh(MeshGenerator::generate(options));
+}
+
+/**
+ * @brief 所有单元的标签
+ */
+std::vector<int> cellLabels(const MeshLabelCore& core)
+{
+    std::vector<int> labels(core.getCellCount());
+    for (int cellId = 0; cellId < core.getCellCount(); ++cellId) {
+        labels[cellId] = core.getCellLabel(cellId);
+    }
+    return labels;
+}
+
+/**
+ * @brief 单元的质心
+ */
+void cellCenter(const MeshLabelCore& core, int cellId, double center[3])
+{
+    vtkPolyData* polyData = core.polyData();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polyData->GetCellPoints(cellId, npts, pts);
+    center[0] = center[1] = center[2] = 0.0;
+    for (vtkIdType i = 0; i < npts; ++i) {
+        double p[3];
+        polyData->GetPoint(pts[i], p);
+        for (int k = 0; k < 3; ++k) {
+            center[k] += p[k] / static_cast<double>(npts);
+        }
+    }
+}
+
+/**
+ * @brief 单元0的平均边长（画刷半径的单位）
+ */
+double edgeLength(const MeshLabelCore& core)
+{
+    vtkPolyData* polyData = core.polyData();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polyData->GetCellPoints(0, npts, pts);
+    double p[3][3];
+    for (int k = 0; k < 3; ++k) {
+        polyData->GetPoint(pts[k], p[k]);
+    }
+    return (std::sqrt(vtkMath::Distance2BetweenPoints(p[0], p[1]))
+            + std::sqrt(vtkMath::Distance2BetweenPoints(p[1], p[2]))
+            + std::sqrt(vtkMath::Distance2BetweenPoints(p[2], p[0]))) / 3.0;
+}
+
+// ==================== 用例 ====================
+
+/**
+ * 画刷笔画、填充和碎片合并之后，增量统计与全量重算一致；
+ * 逐步撤销回到每一步之前的标签，逐步重做回到之后的标签，每一步都再次校验统计
+ */
+bool testStatistics()
+{
+    MeshLabelCore core;
+    CHECK(prepareCore(core, 20000, 6));
+    CHECK(core.verifyLabelStatistics());
+
+    std::vector<std::vector<int>> snapshots;   // 每个撤销步骤之后的标签，[0] 为初始标签
+    snapshots.push_back(cellLabels(core));
+
+    std::mt19937 random(7);
+    const int cellCount = core.getCellCount();
+    const double radius = 3.0 * edgeLength(core);
+    for (int stroke = 0; stroke < 30; ++stroke) {
+        core.beginStroke();
+        for (int sample = 0; sample < 5; ++sample) {
+            const int cellId = static_cast<int>(random() % cellCount);
+            // 与起始单元不同的标签，保证每个样本至少改变一个单元
+            const int label = (core.getCellLabel(cellId) + 1 + static_cast<int>(random() % 9)) % 10;
+            double position[3];
+            cellCenter(core, cellId, position);
+            core.paintCells(core.labelWithBFS(position, cellId, radius, label), label);
+        }
+        core.endStroke();
+        CHECK(core.verifyLabelStatistics());
+        snapshots.push_back(cellLabels(core));
+    }
+
+    const int fillCell = static_cast<int>(random() % cellCount);
+    CHECK(core.bucketFill(fillCell, (core.getCellLabel(fillCell) + 1) % 10) > 0);
+    CHECK(core.verifyLabelStatistics());
+    snapshots.push_back(cellLabels(core));
+
+    if (core.mergeSmallComponents(50) > 0) {
+        CHECK(core.verifyLabelStatistics());
+        snapshots.push_back(cellLabels(core));
+    }
+
+    for (size_t step = snapshots.size() - 1; step > 0; --step) {
+        CHECK(core.undo());
+        CHECK(core.verifyLabelStatistics());
+        CHECK(cellLabels(core) == snapshots[step - 1]);
+    }
+    CHECK(!core.canUndo());
+
+    for (size_t step = 1; step < snapshots.size(); ++step) {
+        CHECK(core.redo());
+        CHECK(core.verifyLabelStatistics());
+        CHECK(cellLabels(core) == snapshots[step]);
+    }
+    CHECK(!core.canRedo());
+    return true;
+}
+
+/**
+ * 从 STL 和 VTP 加载生成的网格后，常驻结构不超过每三角形内存预算
+ */
+bool testMemoryBudget()
+{
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString stlFile = QDir(dir.path()).filePath("budget.stl");
+    const QString vtpFile = QDir(dir.path()).filePath("budget.vtp");
+
+    MeshGeneratorOptions options;
+    options.shape = MeshShape::Icosphere;
+    options.targetTriangles = 200000;
+    CHECK(MeshGenerator::write(MeshGenerator::generate(options), stlFile));
+
+    MeshLabelCore core;
+    CHECK(core.loadSTL(stlFile));
+    CHECK(core.memoryReport().withinBudget(MeshLabelCore::MEMORY_BUDGET_PER_CELL));
+    CHECK(core.saveVTP(vtpFile));
+
+    MeshLabelCore reloaded;
+    CHECK(reloaded.loadVTP(vtpFile));
+    CHECK(reloaded.memoryReport().withinBudget(MeshLabelCore::MEMORY_BUDGET_PER_CELL));
+    return true;
+}
+
+/**
+ * 多线程扩展的画刷 BFS 与串行选中相同的单元集合（含锁定标签和感兴趣区域），
+ * 连续查询复用访问标记后结果不变
+ */
+bool testBfsThreads()
+{
+    MeshLabelCore core;
+    CHECK(prepareCore(core, 200000, 6));
+    // 调小交接长度，中等半径也会进入并行阶段
+    core.setParallelBfsFrontier(64);
+
+    LabelMask locked;
+    locked.set(2, true);
+    core.setLockedLabels(locked);
+    double bounds[6];
+    core.polyData()->GetBounds(bounds);
+    const double clipBox[6] = { bounds[0], bounds[1], bounds[2], 0.5 * (bounds[2] + bounds[3]),
+                                bounds[4], bounds[5] };
+
+    auto query = [&core](int threads, const double* position, int cellId, double radius,
+                         int label) {
+        ParallelUtils::setThreadCount(threads);
+        std::vector<int> cells = core.labelWithBFS(position, cellId, radius, label);
+        ParallelUtils::setThreadCount(0);
+        std::sort(cells.begin(), cells.end());
+        return cells;
+    };
+
+    std::mt19937 random(11);
+    const double edge = edgeLength(core);
+    for (int sample = 0; sample < 24; ++sample) {
+        if (sample == 12) {
+            core.setClipBox(clipBox);
+        }
+        const int cellId = static_cast<int>(random() % core.getCellCount());
+        const double radius = edge * (20.0 + static_cast<double>(random() % 200));
+        const int label = static_cast<int>(random() % 6);
+        double position[3];
+        cellCenter(core, cellId, position);
+
+        const std::vector<int> serial = query(1, position, cellId, radius, label);
+        for (int threads : { 2, 4, 7 }) {
+            CHECK(query(threads, position, cellId, radius, label) == serial);
+        }
+    }
+    return true;
+}
+
+/**
+ * 外存分块模式与内存模式加载同一个 STL：在换出频繁的小预算下，
+ * 每个画刷样本的最近单元和选中的单元集合相同（后半程锁定一个标签），
+ * 标注、撤销、重做之后标签和统计相同；超出容量的标签被拒绝，
+ * 容量超过 256 后 labels.bin 与内存模式的标签数组一样改为16位，重新打开后标签不变
+ */
+bool testChunked()
+{
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString stlFile = QDir(dir.path()).filePath("chunked.stl");
+    const QString tileDir = QDir(dir.path()).filePath("chunked_tiles");
+
+    MeshGeneratorOptions options;
+    options.shape = MeshShape::Icosphere;
+    options.targetTriangles = 50000;
+    CHECK(MeshGenerator::write(MeshGenerator::generate(options), stlFile));
+
+    MeshLabelCore core;
+    CHECK(core.loadSTL(stlFile));
+    ChunkedMesh chunked;
+    CHECK(chunked.createFromSTL(stlFile, tileDir, 2048));
+    CHECK(chunked.cellCount() == core.getCellCount());
+    // 每条单元记录 40 字节，预算只够常驻四个块，画刷和查找都要反复换入换出
+    chunked.setMemoryBudget(4 * 2048 * 40);
+
+    auto sameLabels = [&core, &chunked]() {
+        for (int cellId = 0; cellId < core.getCellCount(); ++cellId) {
+            if (chunked.cellLabel(cellId) != core.getCellLabel(cellId)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::mt19937 random(13);
+    const int cellCount = core.getCellCount();
+    const double edge = edgeLength(core);
+    int strokes = 0;
+    for (int sample = 0; sample < 300; ++sample) {
+        if (sample == 150) {
+            LabelMask locked;
+            locked.set(3, true);
+            core.setLockedLabels(locked);
+            chunked.setProtectedLabels(locked);
+        }
+        const int cellId = static_cast<int>(random() % cellCount);
+        const double radius = edge * (1.0 + static_cast<double>(random() % 30));
+        const int label = static_cast<int>(random() % 8);
+        double position[3];
+        cellCenter(core, cellId, position);
+        CHECK(chunked.findCell(position) == cellId);
+
+        std::vector<int> expected = core.labelWithBFS(position, cellId, radius, label);
+        std::vector<int> actual = chunked.labelWithBFS(position, cellId, radius, label);
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        CHECK(actual == expected);
+        if (expected.empty()) {
+            continue;
+        }
+
+        core.beginStroke();
+        core.paintCells(expected, label);
+        core.endStroke();
+        CHECK(chunked.paintCells(actual, label));
+        ++strokes;
+    }
+    CHECK(strokes > 0);
+    CHECK(chunked.residentChunkCount() < chunked.chunkCount());
+    CHECK(sameLabels());
+    CHECK(!chunked.paintCells({ 0 }, 300));
+    CHECK(chunked.cellLabel(0) == core.getCellLabel(0));
+
+    // 历史长度相同（都不超过 MAX_HISTORY_SIZE）时逐步撤销、重做的结果相同
+    const int steps = std::min(strokes, ChunkedMesh::MAX_HISTORY_SIZE) / 2;
+    for (int step = 0; step < steps; ++step) {
+        CHECK(core.undo());
+        CHECK(chunked.undo());
+    }
+    CHECK(sameLabels());
+    for (int step = 0; step < steps; ++step) {
+        CHECK(core.redo());
+        CHECK(chunked.redo());
+    }
+    CHECK(sameLabels());
+
+    const std::vector<int64_t> counts = chunked.labelCounts(8);
+    for (int label = 0; label < 8; ++label) {
+        CHECK(counts[label] == core.labelStatistics().cellCount(label));
+    }
+
+    // 宽标签：两边都改为16位存储后画同一笔（不再锁定标签，起始单元总能被标注）
+    core.setLockedLabels(LabelMask());
+    chunked.setProtectedLabels(LabelMask());
+    CHECK(core.setLabelCapacity(301));
+    CHECK(chunked.setLabelCapacity(301));
+    CHECK(QFileInfo(QDir(tileDir).filePath("labels.bin")).size() == 2LL * cellCount);
+    CHECK(sameLabels());
+    double position[3];
+    cellCenter(core, 0, position);
+    std::vector<int> expected = core.labelWithBFS(position, 0, 10.0 * edge, 300);
+    std::vector<int> actual = chunked.labelWithBFS(position, 0, 10.0 * edge, 300);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    CHECK(!expected.empty() && actual == expected);
+    core.paintCells(expected, 300);
+    CHECK(chunked.paintCells(actual, 300));
+    CHECK(!chunked.setLabelCapacity(300));
+
+    chunked.close();
+    CHECK(chunked.open(tileDir));
+    CHECK(chunked.labelCapacity() == LabelArray::MAX_CAPACITY);
+    CHECK(sameLabels());
+    CHECK(chunked.labelCounts(301)[300] == core.labelStatistics().cellCount(300));
+    return true;
+}
+
+/**
+ * 小随机图（含指向源点、从汇点出发的边和重边）上最大流等于穷举得到的最小割，
+ * solve() 给出的源点一侧本身就是一个最小割；同一个图对象反复 reset() 复用缓冲区
+ */
+bool testMaxFlow()
+{
+    struct Edge {
+        int from;
+        int to;
+        float capacity;
+        float reverseCapacity;
+    };
+
+    std::mt19937 random(17);
+    MaxFlowGraph graph;
+    for (int round = 0; round < 300; ++round) {
+        const int nodeCount = 1 + static_cast<int>(random() % 8);
+        const int edgeCount = static_cast<int>(random() % 20);
+        graph.reset(nodeCount);
+        std::vector<Edge> edges;
+        for (int i = 0; i < edgeCount; ++i) {
+            // 整数容量：浮点累加没有舍入，流量和割可以精确比较
+            Edge edge = { static_cast<int>(random() % (nodeCount + 2)),
+                          static_cast<int>(random() % (nodeCount + 2)),
+                          static_cast<float>(random() % 10),
+                          random() % 3 == 0 ? static_cast<float>(random() % 10) : 0.0f };
+            graph.addEdge(edge.from, edge.to, edge.capacity, edge.reverseCapacity);
+            edges.push_back(edge);
+        }
+
+        // 源点一侧为 sourceSide 时割开的容量
+        auto cutCapacity = [&edges](const std::vector<bool>& sourceSide) {
+            double cut = 0.0;
+            for (const Edge& edge : edges) {
+                if (edge.from == edge.to) {
+                    continue;
+                }
+                if (sourceSide[edge.from] && !sourceSide[edge.to]) {
+                    cut += edge.capacity;
+                } else if (sourceSide[edge.to] && !sourceSide[edge.from]) {
+                    cut += edge.reverseCapacity;
+                }
+            }
+            return cut;
+        };
+
+        std::vector<bool> sourceSide(nodeCount + 2, false);
+        sourceSide[graph.source()] = true;
+        double bruteForce = -1.0;
+        for (int mask = 0; mask < (1 << nodeCount); ++mask) {
+            for (int node = 0; node < nodeCount; ++node) {
+                sourceSide[node] = (mask >> node) & 1;
+            }
+            const double cut = cutCapacity(sourceSide);
+            if (bruteForce < 0.0 || cut < bruteForce) {
+                bruteForce = cut;
+            }
+        }
+
+        const double flow = graph.solve();
+        CHECK(flow == bruteForce);
+        CHECK(graph.isSourceSide(graph.source()));
+        CHECK(!graph.isSourceSide(graph.sink()));
+        for (int node = 0; node < nodeCount; ++node) {
+            sourceSide[node] = graph.isSourceSide(node);
+        }
+        CHECK(cutCapacity(sourceSide) == flow);
+    }
+    return true;
+}
+
+/**
+ * 在两个标签的交界上画出锯齿后图割细化：只有交界附近 bandRings 圈内的前景/背景单元
+ * 在两者之间互换，带外的单元（硬约束）和其它标签不变；
+ * 笔画中调用时已画的部分先单独提交，细化本身是一个撤销步骤
+ */
+bool testGraphCut()
+{
+    MeshLabelCore core;
+    CHECK(prepareCore(core, 20000, 6));
+    const MeshAdjacency& adjacency = core.meshAdjacency(true);
+    const int cellCount = core.getCellCount();
+    const std::vector<int> initial = cellLabels(core);
+
+    // 取第一对相邻的不同标签作为前景和背景
+    int foreground = -1;
+    int background = -1;
+    for (int cell = 0; cell < cellCount && foreground < 0; ++cell) {
+        for (const int* it = adjacency.cellNeighborsBegin(cell);
+             it != adjacency.cellNeighborsEnd(cell); ++it) {
+            if (initial[*it] != initial[cell]) {
+                foreground = initial[cell];
+                background = initial[*it];
+                break;
+            }
+        }
+    }
+    CHECK(foreground >= 0);
+
+    auto isSeam = [&adjacency, foreground, background](const std::vector<int>& labels, int cell) {
+        if (labels[cell] != foreground && labels[cell] != background) {
+            return false;
+        }
+        const int other = labels[cell] == foreground ? background : foreground;
+        for (const int* it = adjacency.cellNeighborsBegin(cell);
+             it != adjacency.cellNeighborsEnd(cell); ++it) {
+            if (labels[*it] == other) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // 笔画不结束：在交界的背景一侧画若干个前景小块
+    std::mt19937 random(19);
+    const double radius = 2.0 * edgeLength(core);
+    core.beginStroke();
+    for (int blob = 0; blob < 8; ++blob) {
+        const std::vector<int> labels = cellLabels(core);
+        std::vector<int> seeds;
+        for (int cell = 0; cell < cellCount; ++cell) {
+            if (labels[cell] == background && isSeam(labels, cell)) {
+                seeds.push_back(cell);
+            }
+        }
+        CHECK(!seeds.empty());
+        const int cellId = seeds[random() % seeds.size()];
+        double position[3];
+        cellCenter(core, cellId, position);
+        core.paintCells(core.labelWithBFS(position, cellId, radius, foreground), foreground);
+    }
+    const std::vector<int> painted = cellLabels(core);
+    CHECK(painted != initial);
+
+    // 与细化相同的分圈：从交界出发，只经过前景和背景单元
+    const int bandRings = 4;
+    std::vector<int> ring(cellCount, -1);
+    std::vector<int> queue;
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (isSeam(painted, cell)) {
+            ring[cell] = 0;
+            queue.push_back(cell);
+        }
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const int cell = queue[i];
+        for (const int* it = adjacency.cellNeighborsBegin(cell);
+             it != adjacency.cellNeighborsEnd(cell); ++it) {
+            if (ring[*it] < 0 && (painted[*it] == foreground || painted[*it] == background)) {
+                ring[*it] = ring[cell] + 1;
+                queue.push_back(*it);
+            }
+        }
+    }
+
+    const int changed = core.refineWithGraphCut(foreground, background, bandRings);
+    core.endStroke();
+    CHECK(changed > 0);
+    CHECK(core.verifyLabelStatistics());
+    const std::vector<int> refined = cellLabels(core);
+    int differing = 0;
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (refined[cell] == painted[cell]) {
+            continue;
+        }
+        ++differing;
+        CHECK(ring[cell] >= 0 && ring[cell] <= bandRings);
+        CHECK(refined[cell] == foreground || refined[cell] == background);
+    }
+    CHECK(differing == changed);
+
+    CHECK(core.undo());
+    CHECK(cellLabels(core) == painted);
+    CHECK(core.undo());
+    CHECK(cellLabels(core) == initial);
+    CHECK(!core.canUndo());
+    CHECK(core.redo());
+    CHECK(core.redo());
+    CHECK(cellLabels(core) == refined);
+    CHECK(core.verifyLabelStatistics());
+    return true;
+}
+
+/**
+ * 容量超过 256 后标签数组改为16位，已有标签不变；标注标签 300 后统计正确，撤销、重做正常；
+ * 网格中还有标签 300 时缩小容量被拒绝且历史保留，撤销后缩回 256 改回8位并清空历史
+ */
+bool testLabelCapacity()
+{
+    MeshLabelCore core;
+    CHECK(prepareCore(core, 20000, 6));
+    auto storageType = [&core]() {
+        return core.polyData()->GetCellData()->GetScalars()->GetDataType();
+    };
+    CHECK(core.labelCapacity() <= LabelArray::COMPACT_CAPACITY);
+    CHECK(storageType() == VTK_UNSIGNED_CHAR);
+    const std::vector<int> initial = cellLabels(core);
+
+    CHECK(core.setLabelCapacity(301));
+    CHECK(core.labelCapacity() == 301);
+    CHECK(storageType() == VTK_UNSIGNED_SHORT);
+    CHECK(cellLabels(core) == initial);
+    CHECK(core.verifyLabelStatistics());
+
+    double position[3];
+    cellCenter(core, 0, position);
+    const std::vector<int> cells = core.labelWithBFS(position, 0, 5.0 * edgeLength(core), 300);
+    CHECK(!cells.empty());
+    core.beginStroke();
+    core.paintCells(cells, 300);
+    core.endStroke();
+    const std::vector<int> painted = cellLabels(core);
+    CHECK(core.getCellLabel(0) == 300);
+    CHECK(core.labelStatistics().cellCount(300) == static_cast<int>(cells.size()));
+    CHECK(core.verifyLabelStatistics());
+
+    CHECK(core.undo());
+    CHECK(cellLabels(core) == initial);
+    CHECK(core.labelStatistics().cellCount(300) == 0);
+    CHECK(core.verifyLabelStatistics());
+    CHECK(core.redo());
+    CHECK(cellLabels(core) == painted);
+    CHECK(core.verifyLabelStatistics());
+
+    CHECK(!core.setLabelCapacity(300));
+    CHECK(!core.setLabelCapacity(LabelArray::COMPACT_CAPACITY));
+    CHECK(core.labelCapacity() == 301);
+    CHECK(storageType() == VTK_UNSIGNED_SHORT);
+    CHECK(core.canUndo());
+
+    CHECK(core.undo());
+    CHECK(core.setLabelCapacity(LabelArray::COMPACT_CAPACITY));
+    CHECK(storageType() == VTK_UNSIGNED_CHAR);
+    CHECK(!core.canUndo() && !core.canRedo());
+    CHECK(cellLabels(core) == initial);
+    CHECK(core.verifyLabelStatistics());
+    return true;
+}
+
+/**
+ * @brief 用例表
+ */
+struct TestCase {
+    const char* name;
+    bool (*run)();
+};
+
+const TestCase TEST_CASES[] = {
+    { "statistics", testStatistics },
+    { "memory_budget", testMemoryBudget },
+    { "bfs_threads", testBfsThreads },
+    { "chunked", testChunked },
+    { "max_flow", testMaxFlow },
+    { "graph_cut", testGraphCut },
+    { "label_capacity", testLabelCapacity },
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QLoggingCategory::setFilterRules("*.debug=false");
+    QTextStream err(stderr);
+
+    // 不带参数时运行所有用例
+    int failed = 0;
+    int matched = 0;
+    for (const TestCase& test : TEST_CASES) {
+        if (argc > 1 && std::strcmp(argv[1], test.name) != 0) {
+            continue;
+        }
+        ++matched;
+        const bool passed = test.run();
+        err << (passed ? "PASS " : "FAIL ") << test.name << "\n";
+        err.flush();
+        failed += passed ? 0 : 1;
+    }
+    if (matched == 0) {
+        err << "unknown test case: " << argv[1] << "\n";
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,382 @@
+/**
+ * @file batch.cpp
+ * @brief 无界面批处理命令行工具
+ *
+ * 示例：
+ * @code
+ * meshlabeler_batch stats labeled.vtp --output labeled_stats.csv
+ * meshlabeler_batch stats labeled.vtp --output labeled_stats.json
+ * meshlabeler_batch components labeled.vtp --min-cells 50
+ * meshlabeler_batch components labeled.vtp --min-cells 50 --merge --output cleaned.vtp
+ * meshlabeler_batch transfer rescan.stl --reference labeled.vtp --output rescan.vtp
+ * meshlabeler_batch convert labeled.vtp --to point --output labeled_points.vtp
+ * meshlabeler_batch tile huge.stl --output huge_tiles --chunk-cells 65536
+ * meshlabeler_batch paint huge_tiles --strokes strokes.txt --output huge_counts.csv
+ * meshlabeler_batch memory scan.stl
+ * @endcode
+ */
+
+#include "chunkedmesh.h"
+#include "labelarray.h"
+#include "meshlabelcore.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 按扩展名加载网格
+ */
+bool loadMesh(MeshLabelCore& core, const QString& filename)
+{
+    if (filename.endsWith(".vtp", Qt::CaseInsensitive)) {
+        return core.loadVTP(filename);
+    }
+    return core.loadSTL(filename);
+}
+
+/**
+ * @brief stats：输出每个标签的单元数量、面积、质心和包围盒
+ */
+int runStats(MeshLabelCore& core, const QString& output, QTextStream& out, QTextStream& err)
+{
+    if (output.isEmpty()) {
+        out << LabelStatistics::toCsv(core.labelSummaries());
+        return 0;
+    }
+
+    if (!core.exportLabelStatistics(output)) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief components：输出每个标签的连通分量数量和大小，可选合并碎片并保存网格
+ */
+int runComponents(MeshLabelCore& core, int minCells, bool merge, const QString& output,
+                  QTextStream& out, QTextStream& err)
+{
+    if (merge) {
+        if (output.isEmpty() || !output.endsWith(".vtp", Qt::CaseInsensitive)) {
+            err << "--merge 需要 --output 指定 .vtp 文件\n";
+            return 1;
+        }
+        const int merged = core.mergeSmallComponents(minCells);
+        err << "merged " << merged << " fragments\n";
+        if (!core.saveVTP(output)) {
+            err << core.lastError() << "\n";
+            return 1;
+        }
+        err << "wrote " << output << "\n";
+    }
+
+    const QByteArray csv = LabelComponents::toCsv(core.analyzeComponents().summaries(minCells));
+    if (merge || output.isEmpty()) {
+        out << csv;
+        return 0;
+    }
+
+    QFile file(output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(csv) != csv.size()) {
+        err << "无法写入文件: " << output << "\n";
+        return 1;
+    }
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief transfer：从已标注的参考网格按最近单元迁移标签并保存网格
+ */
+int runTransfer(MeshLabelCore& core, const QString& reference, double maxDistance,
+                const QString& output, QTextStream& err)
+{
+    if (reference.isEmpty()) {
+        err << "transfer 需要 --reference 指定已标注的 .vtp 文件\n";
+        return 1;
+    }
+    if (output.isEmpty() || !output.endsWith(".vtp", Qt::CaseInsensitive)) {
+        err << "transfer 需要 --output 指定 .vtp 文件\n";
+        return 1;
+    }
+
+    const int changed = core.transferLabelsFrom(reference, maxDistance);
+    if (changed < 0) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << "transferred " << changed << " cells\n";
+    if (!core.saveVTP(output)) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief convert：在单元标签和顶点标签之间转换并保存网格
+ */
+int runConvert(MeshLabelCore& core, const QString& to, const QString& output, QTextStream& err)
+{
+    LabelLocation location;
+    if (to == "point") {
+        location = LabelLocation::Point;
+    } else if (to == "cell") {
+        location = LabelLocation::Cell;
+    } else {
+        err << "convert 需要 --to point 或 --to cell\n";
+        return 1;
+    }
+    if (output.isEmpty() || !output.endsWith(".vtp", Qt::CaseInsensitive)) {
+        err << "convert 需要 --output 指定 .vtp 文件\n";
+        return 1;
+    }
+
+    if (!core.setLabelLocation(location)) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << "converted to " << to << " labels (" << core.getPointCount() << " points)\n";
+    if (!core.saveVTP(output)) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief memory：输出各数据结构的内存占用，常驻结构超出每三角形预算时返回1
+ */
+int runMemory(MeshLabelCore& core, QTextStream& out, QTextStream& err)
+{
+    const MemoryReport report = core.memoryReport();
+    out << report.toText() << "\n";
+    if (!report.withinBudget(MeshLabelCore::MEMORY_BUDGET_PER_CELL)) {
+        err << "resident memory " << report.residentBytesPerCell() << " bytes/triangle exceeds budget "
+            << MeshLabelCore::MEMORY_BUDGET_PER_CELL << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief tile：把超大二进制 STL 流式分块写入目录（不整体加载网格）
+ */
+int runTile(const QString& input, const QString& output, int chunkCells, QTextStream& err)
+{
+    if (output.isEmpty()) {
+        err << "tile 需要 --output 指定输出目录\n";
+        return 1;
+    }
+
+    ChunkedMesh mesh;
+    if (!mesh.createFromSTL(input, output, chunkCells)) {
+        err << mesh.lastError() << "\n";
+        return 1;
+    }
+    err << QFileInfo(input).fileName() << ": " << mesh.cellCount() << " cells in "
+        << mesh.chunkCount() << " chunks\n";
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief paint：在 tile 生成的目录上按笔画文件执行画刷，输出每个标签的单元数量
+ *
+ * 笔画文件每行一个画刷样本 "x y z radius label"，# 开头的行是注释。
+ * 标签直接写入目录中的 labels.bin（标签超过 255 时转换为每单元2字节）。
+ */
+int runPaint(const QString& input, const QString& strokesFile, const QString& output,
+             QTextStream& out, QTextStream& err)
+{
+    if (strokesFile.isEmpty()) {
+        err << "paint 需要 --strokes 指定笔画文件\n";
+        return 1;
+    }
+
+    ChunkedMesh mesh;
+    if (!mesh.open(input)) {
+        err << mesh.lastError() << "\n";
+        return 1;
+    }
+    QFile file(strokesFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err << "无法打开笔画文件: " << strokesFile << "\n";
+        return 1;
+    }
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    int labelCount = 1;
+    int64_t paintedCells = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().simplified();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QStringList fields = line.split(' ');
+        bool ok = fields.size() == 5;
+        double values[4] = {};
+        for (int i = 0; i < 4 && ok; ++i) {
+            values[i] = fields.at(i).toDouble(&ok);
+        }
+        const int label = ok ? fields.at(4).toInt(&ok) : -1;
+        if (!ok || label < 0 || label >= LabelArray::MAX_CAPACITY) {
+            err << strokesFile << ":" << lineNumber << ": 应为 \"x y z radius label\"（标签 0-"
+                << LabelArray::MAX_CAPACITY - 1 << "）\n";
+            return 1;
+        }
+        // 超出 1 字节的标签：一次转换为 16 位存储
+        if (label >= mesh.labelCapacity() && !mesh.setLabelCapacity(LabelArray::MAX_CAPACITY)) {
+            err << mesh.lastError() << "\n";
+            return 1;
+        }
+
+        const int cellId = mesh.findCell(values);
+        const std::vector<int> cells = mesh.labelWithBFS(values, cellId, values[3], label);
+        if (!mesh.paintCells(cells, label)) {
+            err << mesh.lastError() << "\n";
+            return 1;
+        }
+        paintedCells += static_cast<int64_t>(cells.size());
+        labelCount = std::max(labelCount, label + 1);
+    }
+    err << "painted " << paintedCells << " cells\n";
+
+    QByteArray csv("label,cells\n");
+    const std::vector<int64_t> counts = mesh.labelCounts(mesh.labelCapacity());
+    for (int label = 0; label < static_cast<int>(counts.size()); ++label) {
+        if (counts[label] > 0 || label < labelCount) {
+            csv += QByteArray::number(label) + ',' + QByteArray::number(counts[label]) + '\n';
+        }
+    }
+    if (output.isEmpty()) {
+        out << csv;
+        return 0;
+    }
+
+    QFile outFile(output);
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || outFile.write(csv) != csv.size()) {
+        err << "无法写入文件: " << output << "\n";
+        return 1;
+    }
+    err << "wrote " << output << "\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("meshlabeler_batch");
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("网格标注批处理工具");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "命令：stats、components、transfer、convert、tile、paint、memory");
+    parser.addPositionalArgument("input", "输入网格（.vtp 或 .stl；paint 为 tile 生成的目录）");
+
+    QCommandLineOption outputOption({ "o", "output" },
+                                    "输出文件（.csv 或 .json；缺省时 CSV 输出到标准输出）", "file");
+    parser.addOption(outputOption);
+    QCommandLineOption minCellsOption("min-cells",
+                                      "components：单元数小于该值的分量视为碎片（默认 50）",
+                                      "n", "50");
+    parser.addOption(minCellsOption);
+    QCommandLineOption mergeOption("merge",
+                                   "components：把碎片合并到周围标签，结果写入 --output（.vtp）");
+    parser.addOption(mergeOption);
+    QCommandLineOption referenceOption("reference",
+                                       "transfer：已标注的参考网格（.vtp）", "file");
+    parser.addOption(referenceOption);
+    QCommandLineOption maxDistanceOption("max-distance",
+                                         "transfer：离参考网格超过该距离的单元保持原标签（默认不限制）",
+                                         "d", "0");
+    parser.addOption(maxDistanceOption);
+    QCommandLineOption toOption("to", "convert：目标标签位置（point 或 cell）", "location");
+    parser.addOption(toOption);
+    QCommandLineOption chunkCellsOption("chunk-cells",
+                                        "tile：每块的目标单元数（默认 65536）", "n",
+                                        QString::number(ChunkedMesh::DEFAULT_CHUNK_CELLS));
+    parser.addOption(chunkCellsOption);
+    QCommandLineOption strokesOption("strokes",
+                                     "paint：笔画文件（每行 \"x y z radius label\"）", "file");
+    parser.addOption(strokesOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2) {
+        parser.showHelp(1);
+    }
+
+    const QString command = args.at(0).toLower();
+    const QString input = args.at(1);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (command == "tile") {
+        const int result = runTile(input, parser.value(outputOption),
+                                   parser.value(chunkCellsOption).toInt(), err);
+        err << command << ": " << timer.elapsed() << " ms\n";
+        return result;
+    }
+    if (command == "paint") {
+        const int result = runPaint(input, parser.value(strokesOption), parser.value(outputOption),
+                                    out, err);
+        err << command << ": " << timer.elapsed() << " ms\n";
+        return result;
+    }
+
+    MeshLabelCore core;
+    if (!loadMesh(core, input)) {
+        err << core.lastError() << "\n";
+        return 1;
+    }
+    err << QFileInfo(input).fileName() << ": " << core.getCellCount() << " cells (load "
+        << timer.restart() << " ms)\n";
+    const MemoryReport memory = core.memoryReport();
+    err << "memory: " << memory.residentBytes() / (1024 * 1024) << " MB resident, "
+        << memory.residentBytesPerCell() << " bytes/triangle\n";
+
+    int result = 1;
+    if (command == "stats") {
+        result = runStats(core, parser.value(outputOption), out, err);
+    } else if (command == "components") {
+        result = runComponents(core, parser.value(minCellsOption).toInt(),
+                               parser.isSet(mergeOption), parser.value(outputOption), out, err);
+    } else if (command == "memory") {
+        result = runMemory(core, out, err);
+    } else if (command == "transfer") {
+        result = runTransfer(core, parser.value(referenceOption),
+                             parser.value(maxDistanceOption).toDouble(),
+                             parser.value(outputOption), err);
+    } else if (command == "convert") {
+        result = runConvert(core, parser.value(toOption).toLower(), parser.value(outputOption), err);
+    } else {
+        err << "未知命令: " << command << "\n";
+        return 1;
+    }
+
+    err << command << ": " << timer.elapsed() << " ms\n";
+    return result;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file trianglebvh.cpp
+ * @brief TriangleBvh 三角形包围盒层次的实现
+ */
+
+#include "trianglebvh.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+double dot(const double* a, const double* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+} // namespace
+
+void TriangleBvh::clear()
+{
+    std::vector<Node>().swap(m_nodes);
+    std::vector<float>().swap(m_corners);
+    std::vector<int>().swap(m_ids);
+}
+
+void TriangleBvh::build(const std::vector<float>& vertices, const std::vector<int>& triangles,
+                        const std::vector<int>& triangleIds)
+{
+    clear();
+    const int triangleCount = static_cast<int>(triangles.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+
+    std::vector<float> centroids(3 * static_cast<size_t>(triangleCount));   // 每三角形3个
+    std::vector<int> order(triangleCount);   // 三角形下标，构建时原地划分
+    for (int t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            centroids[3 * t + k] = (vertices[3 * triangles[3 * t] + k]
+                                            + vertices[3 * triangles[3 * t + 1] + k]
+                                            + vertices[3 * triangles[3 * t + 2] + k]) / 3.0f;
+        }
+        order[t] = t;
+    }
+
+    m_nodes.reserve(2 * (triangleCount / LEAF_SIZE + 1));
+
+    // 显式栈：(节点下标, 三角形区间)
+    struct Task {
+        int node;
+        int begin;
+        int end;
+    };
+    std::vector<Task> tasks;
+    m_nodes.push_back(Node());
+    tasks.push_back({ 0, 0, triangleCount });
+
+    while (!tasks.empty()) {
+        const Task task = tasks.back();
+        tasks.pop_back();
+
+        // 节点包围盒（三角形顶点）和质心包围盒（用于选择划分轴）
+        float bounds[6];
+        float centroidBounds[6];
+        for (int k = 0; k < 3; ++k) {
+            bounds[2 * k] = centroidBounds[2 * k] = std::numeric_limits<float>::max();
+            bounds[2 * k + 1] = centroidBounds[2 * k + 1] = -std::numeric_limits<float>::max();
+        }
+        for (int i = task.begin; i < task.end; ++i) {
+            const int t = order[i];
+            for (int corner = 0; corner < 3; ++corner) {
+                const float* p = &vertices[3 * static_cast<size_t>(triangles[3 * t + corner])];
+                for (int k = 0; k < 3; ++k) {
+                    bounds[2 * k] = std::min(bounds[2 * k], p[k]);
+                    bounds[2 * k + 1] = std::max(bounds[2 * k + 1], p[k]);
+                }
+            }
+            for (int k = 0; k < 3; ++k) {
+                centroidBounds[2 * k] = std::min(centroidBounds[2 * k], centroids[3 * t + k]);
+                centroidBounds[2 * k + 1] = std::max(centroidBounds[2 * k + 1], centroids[3 * t + k]);
+            }
+        }
+        std::copy(bounds, bounds + 6, m_nodes[task.node].bounds);
+
+        if (task.end - task.begin <= LEAF_SIZE) {
+            m_nodes[task.node].first = task.begin;
+            m_nodes[task.node].count = task.end - task.begin;
+            continue;
+        }
+
+        int axis = 0;
+        for (int k = 1; k < 3; ++k) {
+            if (centroidBounds[2 * k + 1] - centroidBounds[2 * k]
+                > centroidBounds[2 * axis + 1] - centroidBounds[2 * axis]) {
+                axis = k;
+            }
+        }
+        const int middle = task.begin + (task.end - task.begin) / 2;
+        std::nth_element(order.begin() + task.begin, order.begin() + middle,
+                         order.begin() + task.end,
+            [&centroids, axis](int a, int b) {
+                return centroids[3 * a + axis] < centroids[3 * b + axis];
+            });
+
+        // 两个子节点相邻存放，first 记左子节点
+        const int left = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(Node());
+        m_nodes.push_back(Node());
+        tasks.push_back({ left, task.begin, middle });
+        tasks.push_back({ left + 1, middle, task.end });
+        m_nodes[task.node].first = left;
+        m_nodes[task.node].count = 0;
+    }
+
+    // 三角形按叶子顺序复制，查询时连续访问
+    m_corners.resize(9 * static_cast<size_t>(triangleCount));
+    m_ids.resize(triangleCount);
+    for (int i = 0; i < triangleCount; ++i) {
+        const int t = order[i];
+        for (int corner = 0; corner < 3; ++corner) {
+            for (int k = 0; k < 3; ++k) {
+                m_corners[9 * static_cast<size_t>(i) + 3 * corner + k] =
+                    vertices[3 * static_cast<size_t>(triangles[3 * t + corner]) + k];
+            }
+        }
+        m_ids[i] = triangleIds[t];
+    }
+}
+
+double TriangleBvh::boxDistance2(const Node& node, const double point[3])
+{
+    double distance2 = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        double d = 0.0;
+        if (point[k] < node.bounds[2 * k]) {
+            d = node.bounds[2 * k] - point[k];
+        } else if (point[k] > node.bounds[2 * k + 1]) {
+            d = point[k] - node.bounds[2 * k + 1];
+        }
+        distance2 += d * d;
+    }
+    return distance2;
+}
+
+double TriangleBvh::pointTriangleDistance2(const float* corners, const double point[3])
+{
+    // 按 Voronoi 区域求三角形上的最近点（Ericson, Real-Time Collision Detection 5.1.5）
+    const double a[3] = { corners[0], corners[1], corners[2] };
+    const double b[3] = { corners[3], corners[4], corners[5] };
+    const double c[3] = { corners[6], corners[7], corners[8] };
+    const double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    const double ap[3] = { point[0] - a[0], point[1] - a[1], point[2] - a[2] };
+
+    double closest[3];
+    auto at = [&closest](const double* origin, const double* direction, double t) {
+        for (int k = 0; k < 3; ++k) {
+            closest[k] = origin[k] + t * direction[k];
+        }
+    };
+
+    const double d1 = dot(ab, ap);
+    const double d2 = dot(ac, ap);
+    const double bp[3] = { point[0] - b[0], point[1] - b[1], point[2] - b[2] };
+    const double d3 = dot(ab, bp);
+    const double d4 = dot(ac, bp);
+    const double cp[3] = { point[0] - c[0], point[1] - c[1], point[2] - c[2] };
+    const double d5 = dot(ab, cp);
+    const double d6 = dot(ac, cp);
+    const double vc = d1 * d4 - d3 * d2;
+    const double vb = d5 * d2 - d1 * d6;
+    const double va = d3 * d6 - d5 * d4;
+
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        at(a, ab, 0.0);
+    } else if (d3 >= 0.0 && d4 <= d3) {
+        at(b, ab, 0.0);
+    } else if (d6 >= 0.0 && d5 <= d6) {
+        at(c, ab, 0.0);
+    } else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        at(a, ab, d1 / (d1 - d3));
+    } else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        at(a, ac, d2 / (d2 - d6));
+    } else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+        const double bc[3] = { c[0] - b[0], c[1] - b[1], c[2] - b[2] };
+        at(b, bc, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    } else {
+        const double sum = va + vb + vc;
+        const double v = sum != 0.0 ? vb / sum : 0.0;
+        const double w = sum != 0.0 ? vc / sum : 0.0;
+        for (int k = 0; k < 3; ++k) {
+            closest[k] = a[k] + ab[k] * v + ac[k] * w;
+        }
+    }
+
+    const double d[3] = { point[0] - closest[0], point[1] - closest[1], point[2] - closest[2] };
+    return dot(d, d);
+}
+
+int TriangleBvh::nearest(const double point[3], double* distance2) const
+{
+    if (m_nodes.empty()) {
+        return -1;
+    }
+
+    double best = std::numeric_limits<double>::max();
+    int bestIndex = -1;
+
+    // 栈中保存 (节点, 包围盒距离)，弹出时若已不可能更近则跳过
+    struct Entry {
+        int node;
+        double distance2;
+    };
+    Entry stack[64];
+    int top = 0;
+    stack[top++] = { 0, boxDistance2(m_nodes[0], point) };
+
+    while (top > 0) {
+        const Entry entry = stack[--top];
+        if (entry.distance2 >= best) {
+            continue;
+        }
+        const Node& node = m_nodes[entry.node];
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                const double d2 = pointTriangleDistance2(&m_corners[9 * static_cast<size_t>(i)], point);
+                if (d2 < best) {
+                    best = d2;
+                    bestIndex = i;
+                }
+            }
+            continue;
+        }
+
+        const int left = node.first;
+        const int right = left + 1;
+        const double leftDistance = boxDistance2(m_nodes[left], point);
+        const double rightDistance = boxDistance2(m_nodes[right], point);
+        // 近的后入栈、先访问
+        if (leftDistance < rightDistance) {
+            stack[top++] = { right, rightDistance };
+            stack[top++] = { left, leftDistance };
+        } else {
+            stack[top++] = { left, leftDistance };
+            stack[top++] = { right, rightDistance };
+        }
+    }
+
+    if (distance2) {
+        *distance2 = best;
+    }
+    return bestIndex >= 0 ? m_ids[bestIndex] : -1;
+}
+
+size_t TriangleBvh::memoryBytes() const
+{
+    return m_nodes.capacity() * sizeof(Node) + m_corners.capacity() * sizeof(float)
+        + m_ids.capacity() * sizeof(int);
+}
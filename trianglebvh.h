@@ -0,0 +1,86 @@
+/**
+ * @file trianglebvh.h
+ * @brief 三角形包围盒层次（BVH），用于最近面片查询
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef TRIANGLEBVH_H
+#define TRIANGLEBVH_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 三角形 BVH
+ *
+ * 按最长轴的质心中位数递归二分，每个叶子最多 LEAF_SIZE 个三角形；
+ * 节点和三角形都存放在连续数组中。构建后只读，多个线程可以同时查询。
+ * 查询用显式栈做分支限界，先访问离查询点更近的子节点。
+ */
+class TriangleBvh {
+public:
+    static constexpr int LEAF_SIZE = 4;    ///< 叶子中的最大三角形数
+
+    /**
+     * @brief 构建
+     * @param vertices 顶点坐标（每顶点3个）
+     * @param triangles 三角形顶点下标（每三角形3个）
+     * @param triangleIds 每个三角形对应的外部编号（如原网格的单元ID），查询时返回
+     */
+    void build(const std::vector<float>& vertices, const std::vector<int>& triangles,
+               const std::vector<int>& triangleIds);
+
+    /**
+     * @brief 释放所有数据
+     */
+    void clear();
+
+    /**
+     * @brief 是否为空
+     */
+    bool isEmpty() const { return m_nodes.empty(); }
+
+    /**
+     * @brief 三角形数量
+     */
+    int triangleCount() const { return static_cast<int>(m_ids.size()); }
+
+    /**
+     * @brief 查询离点最近的三角形
+     * @param point 查询点
+     * @param distance2 输出距离的平方（可为空）
+     * @return 最近三角形的外部编号，树为空时返回-1
+     */
+    int nearest(const double point[3], double* distance2 = nullptr) const;
+
+    /**
+     * @brief 占用的内存（字节）
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief 点到三角形距离的平方
+     * @param corners 三角形的三个顶点（9个坐标）
+     * @param point 查询点
+     */
+    static double pointTriangleDistance2(const float* corners, const double point[3]);
+
+private:
+    struct Node {
+        float bounds[6];   ///< xmin, xmax, ymin, ymax, zmin, zmax
+        int first;         ///< 叶子：第一个三角形；内部节点：左子节点（右子节点紧随其后）
+        int count;         ///< 叶子中的三角形数（内部节点为0）
+    };
+
+    /**
+     * @brief 点到节点包围盒距离的平方
+     */
+    static double boxDistance2(const Node& node, const double point[3]);
+
+    std::vector<Node> m_nodes;         ///< 节点（根为0）
+    std::vector<float> m_corners;      ///< 按叶子顺序排列的三角形顶点（每三角形9个）
+    std::vector<int> m_ids;            ///< 按叶子顺序排列的外部编号
+};
+
+#endif // TRIANGLEBVH_H
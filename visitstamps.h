@@ -0,0 +1,79 @@
+/**
+ * @file visitstamps.h
+ * @brief 可在多个线程上同时认领的访问标记（按代号复用）
+ * @author MeshLabeler Project
+ * @date 2026-01-11
+ */
+
+#ifndef VISITSTAMPS_H
+#define VISITSTAMPS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+/**
+ * @brief 访问标记
+ *
+ * 每个元素一个 32 位代号，begin() 推进代号代替清零（与 RegionGrower 相同），
+ * 首次使用后每次查询只与访问的元素数有关，不再随网格规模分配和清零内存。
+ * claim() 用原子交换，同一轮中每个元素只有一个调用方认领成功，可在多个线程上同时调用。
+ */
+class VisitStamps {
+public:
+    /**
+     * @brief 开始新一轮（元素数改变时重新分配，代号回绕时清零一次）
+     * @param count 元素数
+     */
+    void begin(size_t count)
+    {
+        if (m_size != count) {
+            m_stamps.reset(new std::atomic<uint32_t>[count]);
+            m_size = count;
+            m_generation = std::numeric_limits<uint32_t>::max();
+        }
+        if (m_generation == std::numeric_limits<uint32_t>::max()) {
+            for (size_t i = 0; i < m_size; ++i) {
+                m_stamps[i].store(0, std::memory_order_relaxed);
+            }
+            m_generation = 0;
+        }
+        ++m_generation;
+    }
+
+    /**
+     * @brief 认领一个元素
+     * @return 本轮第一次认领时返回true
+     */
+    bool claim(size_t index)
+    {
+        std::atomic<uint32_t>& stamp = m_stamps[index];
+        // 先读一次，已认领的元素不做写操作，避免缓存行在线程间来回失效
+        return stamp.load(std::memory_order_relaxed) != m_generation
+            && stamp.exchange(m_generation, std::memory_order_relaxed) != m_generation;
+    }
+
+    /**
+     * @brief 释放缓冲区
+     */
+    void clear()
+    {
+        m_stamps.reset();
+        m_size = 0;
+        m_generation = 0;
+    }
+
+    /**
+     * @brief 缓冲区占用的内存（字节）
+     */
+    size_t memoryBytes() const { return m_size * sizeof(std::atomic<uint32_t>); }
+
+private:
+    std::unique_ptr<std::atomic<uint32_t>[]> m_stamps;   ///< 每个元素最后一次被认领的代号
+    size_t m_size = 0;                                   ///< 元素数
+    uint32_t m_generation = 0;                           ///< 当前代号
+};
+
+#endif // VISITSTAMPS_H